@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Shell command that shows memory block usage, see lib/memb.h
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "shell-memb.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_memb_process, "memb");
+SHELL_COMMAND(memb_command,
+	      "memb",
+	      "memb [clear]: show memory block usage (or clear the peaks)",
+	      &shell_memb_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_memb_process, ev, data)
+{
+#if MEMB_STATS
+  struct memb *m;
+  char buf[64];
+#endif /* MEMB_STATS */
+
+  PROCESS_BEGIN();
+
+#if MEMB_STATS
+  if(data != NULL && strncmp(data, "clear", 5) == 0) {
+    memb_stats_clear();
+    PROCESS_EXIT();
+  }
+
+  shell_output_str(&memb_command, "memb: size, used/num, peak, failures", "");
+  for(m = memb_stats_list(); m != NULL; m = m->next) {
+    snprintf(buf, sizeof(buf), "%s: %u, %u/%u, %u, %u",
+	     m->name != NULL ? m->name : "?", m->size, m->used, m->num,
+	     m->peak, m->failures);
+    shell_output_str(&memb_command, buf, "");
+  }
+#else /* MEMB_STATS */
+  shell_output_str(&memb_command,
+		   "Memory block statistics not enabled (MEMB_CONF_STATS)", "");
+#endif /* MEMB_STATS */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_memb_init(void)
+{
+  shell_register_command(&memb_command);
+}
+/*---------------------------------------------------------------------------*/
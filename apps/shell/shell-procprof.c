@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Shell commands that show the per-process run time and event
+ *         latency profile, see sys/process-profile.h
+ */
+
+#include "contiki.h"
+#include "sys/process-profile.h"
+#include "shell-procprof.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if PROCESS_PROFILE
+/* The record written by procprof-dump for each entry, in the byte
+   order of the node. Times are in rtimer ticks. */
+struct procprof_record {
+  char name[16];
+  uint8_t ev;
+  uint8_t reserved[3];
+  uint32_t count;
+  uint32_t total_time;
+  uint32_t max_time;
+  uint32_t total_delay;
+  uint32_t max_delay;
+};
+#endif /* PROCESS_PROFILE */
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_procprof_process, "procprof");
+SHELL_COMMAND(procprof_command,
+	      "procprof",
+	      "procprof [clear]: show (or clear) process run times and event delays",
+	      &shell_procprof_process);
+PROCESS(shell_procprof_dump_process, "procprof-dump");
+SHELL_COMMAND(procprof_dump_command,
+	      "procprof-dump",
+	      "procprof-dump: output the process profile as binary records",
+	      &shell_procprof_dump_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_procprof_process, ev, data)
+{
+#if PROCESS_PROFILE
+  struct process_profile *e;
+  char buf[96];
+#endif /* PROCESS_PROFILE */
+
+  PROCESS_BEGIN();
+
+#if PROCESS_PROFILE
+  if(data != NULL && strncmp(data, "clear", 5) == 0) {
+    process_profile_clear();
+    PROCESS_EXIT();
+  }
+
+  snprintf(buf, sizeof(buf), "%lu ticks/s, %lu calls not recorded",
+	   (unsigned long)RTIMER_SECOND, process_profile_lost);
+  shell_output_str(&procprof_command, buf, "");
+  shell_output_str(&procprof_command,
+		   "process event: calls, run avg/max, delay avg/max", "");
+  for(e = process_profile;
+      e < &process_profile[PROCESS_PROFILE] && e->p != NULL; e++) {
+    snprintf(buf, sizeof(buf), "%s %u: %lu, %lu/%lu, %lu/%lu",
+	     PROCESS_NAME_STRING(e->p), e->ev, e->count,
+	     e->total_time / e->count, (unsigned long)e->max_time,
+	     e->total_delay / e->count, (unsigned long)e->max_delay);
+    shell_output_str(&procprof_command, buf, "");
+  }
+#else /* PROCESS_PROFILE */
+  shell_output_str(&procprof_command,
+		   "Process profiling not enabled (PROCESS_CONF_PROFILE)", "");
+#endif /* PROCESS_PROFILE */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_procprof_dump_process, ev, data)
+{
+#if PROCESS_PROFILE
+  struct process_profile *e;
+  struct procprof_record r;
+#endif /* PROCESS_PROFILE */
+
+  PROCESS_BEGIN();
+
+#if PROCESS_PROFILE
+  for(e = process_profile;
+      e < &process_profile[PROCESS_PROFILE] && e->p != NULL; e++) {
+    memset(&r, 0, sizeof(r));
+    strncpy(r.name, PROCESS_NAME_STRING(e->p), sizeof(r.name) - 1);
+    r.ev = e->ev;
+    r.count = e->count;
+    r.total_time = e->total_time;
+    r.max_time = e->max_time;
+    r.total_delay = e->total_delay;
+    r.max_delay = e->max_delay;
+    shell_output(&procprof_dump_command, &r, sizeof(r), "", 0);
+  }
+#endif /* PROCESS_PROFILE */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_procprof_init(void)
+{
+  shell_register_command(&procprof_command);
+  shell_register_command(&procprof_dump_command);
+}
+/*---------------------------------------------------------------------------*/
@@ -138,27 +138,18 @@ PROCESS_THREAD(shell_mac_process, ev, data)
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(shell_packetize_process, ev, data)
 {
-  static struct queuebuf *q = NULL;
-  static char *ptr;
+  /* The data is collected across events, while queuebufs may be moved
+     or swapped out (see queuebuf.h), so it is not kept in one. */
+  static char buf[PACKETBUF_SIZE];
   static int size;
   int len;
   PROCESS_BEGIN();
 
+  size = 0;
   while(1) {
     struct shell_input *input;
     PROCESS_WAIT_EVENT_UNTIL(ev == shell_event_input);
 
-    if(q == NULL) {
-      packetbuf_clear();
-      q = queuebuf_new_from_packetbuf();
-      if(q == NULL) {
-	shell_output_str(&packetize_command, "packetize: could not allocate packet buffer", "");
-	PROCESS_EXIT();
-      }
-      ptr = queuebuf_dataptr(q);
-      size = 0;
-    }
-    
     input = data;
 
     len = input->len1 + input->len2;
@@ -166,16 +157,14 @@ PROCESS_THREAD(shell_packetize_process, ev, data)
     if(len + size >= PACKETBUF_SIZE ||
        len  == 0) {
       shell_output(&packetize_command,
-		   ptr, size,
+		   buf, size,
 		   "", 0);
-      queuebuf_free(q);
-      q = NULL;
       PROCESS_EXIT();
     }
 
-    memcpy(ptr + size, input->data1, input->len1);
+    memcpy(buf + size, input->data1, input->len1);
     size += input->len1;
-    memcpy(ptr + size, input->data2, input->len2);
+    memcpy(buf + size, input->data2, input->len2);
     size += input->len2;
     
   }
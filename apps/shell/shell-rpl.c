@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Shell commands for RPL control-plane statistics and event traces
+ */
+
+#include "contiki.h"
+#include "shell-rpl.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if UIP_CONF_IPV6_RPL
+#include "net/rpl/rpl.h"
+#endif /* UIP_CONF_IPV6_RPL */
+
+#if UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS
+static const char *event_names[] = {
+  "dio-in", "dio-out", "dis-in", "dis-out", "dao-in", "dao-out",
+  "dao-ack-in", "dao-ack-out", "parent-switch", "global-repair",
+  "local-repair", "trickle-reset", "route-add", "route-remove",
+  "parent-lost"
+};
+#endif /* UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS */
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_rpl_stats_process, "rpl-stats");
+SHELL_COMMAND(rpl_stats_command,
+	      "rpl-stats",
+	      "rpl-stats: show RPL control message and repair counters",
+	      &shell_rpl_stats_process);
+PROCESS(shell_rpl_trace_process, "rpl-trace");
+SHELL_COMMAND(rpl_trace_command,
+	      "rpl-trace",
+	      "rpl-trace [clear]: show (or clear) recent RPL control-plane events",
+	      &shell_rpl_trace_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_rpl_stats_process, ev, data)
+{
+#if UIP_CONF_IPV6_RPL && RPL_CONF_STATS
+  char buf[64];
+#endif /* UIP_CONF_IPV6_RPL && RPL_CONF_STATS */
+
+  PROCESS_BEGIN();
+
+#if UIP_CONF_IPV6_RPL && RPL_CONF_STATS
+  snprintf(buf, sizeof(buf), "in %u out %u",
+	   rpl_stats.dio_in, rpl_stats.dio_out);
+  shell_output_str(&rpl_stats_command, "DIO ", buf);
+  snprintf(buf, sizeof(buf), "in %u out %u",
+	   rpl_stats.dis_in, rpl_stats.dis_out);
+  shell_output_str(&rpl_stats_command, "DIS ", buf);
+  snprintf(buf, sizeof(buf), "in %u out %u",
+	   rpl_stats.dao_in, rpl_stats.dao_out);
+  shell_output_str(&rpl_stats_command, "DAO ", buf);
+  snprintf(buf, sizeof(buf), "in %u out %u",
+	   rpl_stats.dao_ack_in, rpl_stats.dao_ack_out);
+  shell_output_str(&rpl_stats_command, "DAO-ACK ", buf);
+  snprintf(buf, sizeof(buf),
+	   "parent switches %u (lost %u), global %u, local %u",
+	   rpl_stats.parent_switch, rpl_stats.parent_lost,
+	   rpl_stats.global_repairs, rpl_stats.local_repairs);
+  shell_output_str(&rpl_stats_command, "Repairs: ", buf);
+  snprintf(buf, sizeof(buf), "%u", rpl_stats.resets);
+  shell_output_str(&rpl_stats_command, "Trickle resets: ", buf);
+  snprintf(buf, sizeof(buf), "added %u removed %u",
+	   rpl_stats.routes_added, rpl_stats.routes_removed);
+  shell_output_str(&rpl_stats_command, "Routes ", buf);
+  snprintf(buf, sizeof(buf), "malformed %u, memory overflows %u",
+	   rpl_stats.malformed_msgs, rpl_stats.mem_overflows);
+  shell_output_str(&rpl_stats_command, "Errors: ", buf);
+#else /* UIP_CONF_IPV6_RPL && RPL_CONF_STATS */
+  shell_output_str(&rpl_stats_command,
+		   "RPL statistics not enabled (RPL_CONF_STATS)", "");
+#endif /* UIP_CONF_IPV6_RPL && RPL_CONF_STATS */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_rpl_trace_process, ev, data)
+{
+#if UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS
+  const struct rpl_trace_event *e;
+  char buf[48];
+  int i;
+#endif /* UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS */
+
+  PROCESS_BEGIN();
+
+#if UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS
+  if(data != NULL && strncmp(data, "clear", 5) == 0) {
+    rpl_trace_clear();
+    PROCESS_EXIT();
+  }
+
+  for(i = 0; (e = rpl_trace_get(i)) != NULL; i++) {
+    snprintf(buf, sizeof(buf), "%lu %s %04x",
+	     (unsigned long)e->time,
+	     e->type < sizeof(event_names) / sizeof(event_names[0]) ?
+	     event_names[e->type] : "?",
+	     e->arg);
+    shell_output_str(&rpl_trace_command, buf, "");
+  }
+#else /* UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS */
+  shell_output_str(&rpl_trace_command,
+		   "RPL trace not enabled (RPL_CONF_TRACE_EVENTS)", "");
+#endif /* UIP_CONF_IPV6_RPL && RPL_TRACE_EVENTS */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_rpl_init(void)
+{
+  shell_register_command(&rpl_stats_command);
+  shell_register_command(&rpl_trace_command);
+}
+/*---------------------------------------------------------------------------*/
@@ -383,6 +383,7 @@ struct shell_input {
 #include "shell-file.h"
 #include "shell-httpd.h"
 #include "shell-irc.h"
+#include "shell-memb.h"
 #include "shell-memdebug.h"
 #include "shell-netfile.h"
 #include "shell-netperf.h"
@@ -390,6 +391,7 @@ struct shell_input {
 #include "shell-ping.h"
 #include "shell-power.h"
 #include "shell-powertrace.h"
+#include "shell-procprof.h"
 #include "shell-ps.h"
 #include "shell-reboot.h"
 #include "shell-rime-debug.h"
@@ -401,6 +403,7 @@ struct shell_input {
 #include "shell-rime-sniff.h"
 #include "shell-rime-unicast.h"
 #include "shell-rime.h"
+#include "shell-rpl.h"
 #include "shell-rsh.h"
 #include "shell-run.h"
 #include "shell-sendtest.h"
@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *	A block cache for storage back ends of the file systems.
+ */
+
+#include <string.h>
+
+#include "contiki-conf.h"
+#include "cfs/cfs-cache.h"
+
+#define DEBUG 0
+#if DEBUG
+#include <stdio.h>
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+
+/* The amount of blocks to read ahead on a sequential miss. */
+#ifdef CFS_CACHE_CONF_READ_AHEAD
+#define CFS_CACHE_READ_AHEAD CFS_CACHE_CONF_READ_AHEAD
+#else
+#define CFS_CACHE_READ_AHEAD 1
+#endif
+
+#if CFS_CACHE_READ_AHEAD >= CFS_CACHE_BLOCKS
+#error "CFS_CACHE_READ_AHEAD must be less than CFS_CACHE_BLOCKS."
+#endif
+
+#if CFS_CACHE_STATS
+struct cfs_cache_stats cfs_cache_stats;
+#define STATS_ADD(field, count) cfs_cache_stats.field += (count)
+#else
+#define STATS_ADD(field, count)
+#endif
+
+struct cache_entry {
+  /* The back end of the block, or NULL if the entry is unused. */
+  const struct cfs_cache_backend *backend;
+  cfs_offset_t block;
+  int id;
+  /* The bytes that have not been written back. */
+  uint16_t dirty_start;
+  uint16_t dirty_end;
+  /* The bytes that are known to match the storage, counted from the
+     start of the block. Only used if the block has been loaded. */
+  uint16_t valid;
+  uint8_t loaded;
+};
+
+#define DIRTY(e)		((e)->dirty_start != (e)->dirty_end)
+#define ENTRY_DATA(e)		cache_data[(e) - cache_entries]
+#define BLOCK_START(block)	((block) * CFS_CACHE_BLOCK_SIZE)
+
+static struct cache_entry cache_entries[CFS_CACHE_BLOCKS];
+/* Consecutive entries have consecutive buffers, so that several blocks
+   can be read ahead with one read from the back end. */
+static uint8_t cache_data[CFS_CACHE_BLOCKS][CFS_CACHE_BLOCK_SIZE];
+/* Entries are replaced in FIFO order. */
+static unsigned next_entry;
+
+/* The end of the latest read, used to recognize sequential reads. */
+static const struct cfs_cache_backend *last_backend;
+static int last_id;
+static cfs_offset_t last_end;
+/*---------------------------------------------------------------------------*/
+static struct cache_entry *
+find_entry(const struct cfs_cache_backend *backend, int id,
+           cfs_offset_t block)
+{
+  struct cache_entry *e;
+
+  for(e = cache_entries; e < &cache_entries[CFS_CACHE_BLOCKS]; e++) {
+    if(e->backend == backend && e->block == block && e->id == id) {
+      return e;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Whether the dirty bytes of entry e continue those of the entry
+   before it, in the next block and in the next buffer. */
+static int
+continues_dirty(struct cache_entry *e)
+{
+  struct cache_entry *prev;
+
+  if(e == cache_entries || !DIRTY(e) || e->dirty_start != 0) {
+    return 0;
+  }
+  prev = e - 1;
+  return prev->backend == e->backend && prev->id == e->id &&
+         prev->block + 1 == e->block && DIRTY(prev) &&
+         prev->dirty_end == CFS_CACHE_BLOCK_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/* Write back the dirty bytes of an entry, together with those of the
+   neighboring entries that they continue into, so that a write that
+   straddles blocks reaches the back end as one write. */
+static int
+write_back(struct cache_entry *e)
+{
+  struct cache_entry *first;
+  struct cache_entry *last;
+  int r;
+
+  if(!DIRTY(e)) {
+    return 0;
+  }
+
+  for(first = e; continues_dirty(first); first--);
+  for(last = e; last + 1 < &cache_entries[CFS_CACHE_BLOCKS] &&
+        continues_dirty(last + 1); last++);
+
+  PRINTF("cfs-cache: write back blocks %ld-%ld bytes %u-%u\n",
+         (long)first->block, (long)last->block, first->dirty_start,
+         last->dirty_end);
+  r = e->backend->write(e->id, &ENTRY_DATA(first)[first->dirty_start],
+                        BLOCK_START(last - first) + last->dirty_end -
+                        first->dirty_start,
+                        BLOCK_START(first->block) + first->dirty_start);
+  STATS_ADD(write_backs, 1);
+  for(e = first; e <= last; e++) {
+    e->dirty_start = e->dirty_end = 0;
+  }
+  return r < 0 ? -1 : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Free a run of consecutive entries and return the first one. */
+static struct cache_entry *
+allocate_entries(unsigned count)
+{
+  struct cache_entry *e;
+  unsigned i;
+
+  if(next_entry + count > CFS_CACHE_BLOCKS) {
+    next_entry = 0;
+  }
+  e = &cache_entries[next_entry];
+  next_entry = (next_entry + count) % CFS_CACHE_BLOCKS;
+
+  for(i = 0; i < count; i++) {
+    if(e[i].backend != NULL) {
+      /* Nothing can be done about a failure here; the data is lost
+         just as if the back end had failed a direct write. */
+      write_back(&e[i]);
+      e[i].backend = NULL;
+    }
+  }
+  return e;
+}
+/*---------------------------------------------------------------------------*/
+/* Load a run of consecutive blocks into a run of consecutive entries. */
+static int
+load_entries(struct cache_entry *e, const struct cfs_cache_backend *backend,
+             int id, cfs_offset_t block, unsigned count)
+{
+  cfs_offset_t offset;
+  unsigned size;
+  unsigned i;
+  int r;
+
+  offset = BLOCK_START(block);
+  size = count * CFS_CACHE_BLOCK_SIZE;
+  if(backend->size > 0) {
+    if(offset >= backend->size) {
+      size = 0;
+    } else if(backend->size - offset < size) {
+      size = backend->size - offset;
+    }
+  }
+
+  r = 0;
+  if(size > 0) {
+    r = backend->read(id, ENTRY_DATA(e), size, offset);
+    if(r < 0) {
+      return -1;
+    }
+  }
+
+  for(i = 0; i < count; i++, e++, r -= CFS_CACHE_BLOCK_SIZE) {
+    e->backend = backend;
+    e->id = id;
+    e->block = block + i;
+    e->dirty_start = e->dirty_end = 0;
+    e->loaded = 1;
+    if(r <= 0) {
+      e->valid = 0;
+    } else {
+      e->valid = r < CFS_CACHE_BLOCK_SIZE ? r : CFS_CACHE_BLOCK_SIZE;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Count the blocks from a block on that are not in the cache. */
+static unsigned
+uncached_blocks(const struct cfs_cache_backend *backend, int id,
+                cfs_offset_t block, unsigned max)
+{
+  unsigned count;
+
+  for(count = 0; count < max; count++) {
+    if(find_entry(backend, id, block + count) != NULL) {
+      break;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_cache_read(const struct cfs_cache_backend *backend, int id,
+               void *buf, unsigned size, cfs_offset_t offset)
+{
+  struct cache_entry *e;
+  cfs_offset_t block;
+  unsigned block_offset;
+  unsigned done;
+  unsigned count;
+  unsigned n;
+  char sequential;
+  int r;
+
+  sequential = backend == last_backend && id == last_id &&
+               offset == last_end;
+
+  for(done = 0; done < size; done += n, offset += n) {
+    block = offset / CFS_CACHE_BLOCK_SIZE;
+    block_offset = offset - BLOCK_START(block);
+    n = CFS_CACHE_BLOCK_SIZE - block_offset;
+    if(n > size - done) {
+      n = size - done;
+    }
+
+    e = find_entry(backend, id, block);
+    if(e == NULL && n == CFS_CACHE_BLOCK_SIZE) {
+      /* Whole blocks would only push other blocks out of the cache. */
+      count = uncached_blocks(backend, id, block,
+                              (size - done) / CFS_CACHE_BLOCK_SIZE);
+      r = backend->read(id, (char *)buf + done,
+                        count * CFS_CACHE_BLOCK_SIZE, offset);
+      if(r < 0) {
+        return done > 0 ? (int)done : -1;
+      }
+      STATS_ADD(direct, count);
+      if(r < count * CFS_CACHE_BLOCK_SIZE) {
+        done += r;
+        offset += r;
+        break;
+      }
+      n = r;
+      continue;
+    }
+
+    if(e == NULL) {
+      count = 1;
+      if(sequential || block_offset + (size - done) > CFS_CACHE_BLOCK_SIZE) {
+        /* Fetch the next blocks with the same back end read, as they
+           are likely to be read next. */
+        count += uncached_blocks(backend, id, block + 1, CFS_CACHE_READ_AHEAD);
+      }
+      e = allocate_entries(count);
+      if(load_entries(e, backend, id, block, count) < 0) {
+        return done > 0 ? (int)done : -1;
+      }
+      STATS_ADD(misses, 1);
+      STATS_ADD(read_ahead, count - 1);
+    } else if(!e->loaded && (block_offset < e->dirty_start ||
+                             block_offset + n > e->dirty_end)) {
+      /* The block has only been written to, and the rest of it must
+         be read from the back end. */
+      if(write_back(e) < 0 || load_entries(e, backend, id, block, 1) < 0) {
+        return done > 0 ? (int)done : -1;
+      }
+      STATS_ADD(misses, 1);
+    } else {
+      STATS_ADD(hits, 1);
+    }
+
+    if(e->loaded) {
+      if(block_offset >= e->valid) {
+        break;
+      }
+      if(n > e->valid - block_offset) {
+        n = e->valid - block_offset;
+        memcpy((char *)buf + done, &ENTRY_DATA(e)[block_offset], n);
+        done += n;
+        offset += n;
+        break;
+      }
+    }
+    memcpy((char *)buf + done, &ENTRY_DATA(e)[block_offset], n);
+  }
+
+  last_backend = backend;
+  last_id = id;
+  last_end = offset;
+
+  return done;
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_cache_write(const struct cfs_cache_backend *backend, int id,
+                const void *buf, unsigned size, cfs_offset_t offset)
+{
+  struct cache_entry *e;
+  cfs_offset_t block;
+  unsigned block_offset;
+  unsigned done;
+  unsigned count;
+  unsigned n;
+  int r;
+
+  for(done = 0; done < size; done += n, offset += n) {
+    block = offset / CFS_CACHE_BLOCK_SIZE;
+    block_offset = offset - BLOCK_START(block);
+    n = CFS_CACHE_BLOCK_SIZE - block_offset;
+    if(n > size - done) {
+      n = size - done;
+    }
+
+    e = find_entry(backend, id, block);
+    if(e == NULL && n == CFS_CACHE_BLOCK_SIZE) {
+      count = uncached_blocks(backend, id, block,
+                              (size - done) / CFS_CACHE_BLOCK_SIZE);
+      r = backend->write(id, (const char *)buf + done,
+                         count * CFS_CACHE_BLOCK_SIZE, offset);
+      if(r < 0) {
+        return done > 0 ? (int)done : -1;
+      }
+      STATS_ADD(direct, count);
+      if(r < count * CFS_CACHE_BLOCK_SIZE) {
+        return done + r;
+      }
+      n = r;
+      continue;
+    }
+
+    if(e == NULL) {
+      /* The block is not read until it is needed. A write that ends in
+         part of the next block takes consecutive entries for both, so
+         that it is written back as one. */
+      count = 1;
+      if(size - done > n && size - done - n < CFS_CACHE_BLOCK_SIZE &&
+         find_entry(backend, id, block + 1) == NULL) {
+        count = 2;
+      }
+      e = allocate_entries(count);
+      for(r = 0; r < count; r++) {
+        e[r].backend = backend;
+        e[r].id = id;
+        e[r].block = block + r;
+        e[r].dirty_start = e[r].dirty_end = 0;
+        e[r].loaded = 0;
+      }
+    } else if(DIRTY(e) && (block_offset > e->dirty_end ||
+                           block_offset + n < e->dirty_start)) {
+      /* Only one range per block is kept dirty. */
+      if(write_back(e) < 0) {
+        return done > 0 ? (int)done : -1;
+      }
+    }
+
+    memcpy(&ENTRY_DATA(e)[block_offset], (const char *)buf + done, n);
+    if(!DIRTY(e)) {
+      e->dirty_start = block_offset;
+      e->dirty_end = block_offset + n;
+    } else {
+      if(block_offset < e->dirty_start) {
+        e->dirty_start = block_offset;
+      }
+      if(block_offset + n > e->dirty_end) {
+        e->dirty_end = block_offset + n;
+      }
+    }
+
+    if(e->loaded) {
+      if(block_offset > e->valid) {
+        /* The gap before the written bytes is unknown. */
+        e->loaded = 0;
+      } else if(block_offset + n > e->valid) {
+        e->valid = block_offset + n;
+      }
+    }
+  }
+
+  return done;
+}
+/*---------------------------------------------------------------------------*/
+int
+cfs_cache_flush(const struct cfs_cache_backend *backend, int id)
+{
+  struct cache_entry *e;
+  int r;
+
+  r = 0;
+  for(e = cache_entries; e < &cache_entries[CFS_CACHE_BLOCKS]; e++) {
+    if(e->backend == backend && (id == -1 || e->id == id)) {
+      if(write_back(e) < 0) {
+        r = -1;
+      }
+    }
+  }
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+void
+cfs_cache_invalidate(const struct cfs_cache_backend *backend, int id,
+                     cfs_offset_t offset, cfs_offset_t size)
+{
+  struct cache_entry *e;
+  cfs_offset_t start;
+
+  for(e = cache_entries; e < &cache_entries[CFS_CACHE_BLOCKS]; e++) {
+    if(e->backend != NULL && (backend == NULL || e->backend == backend) &&
+       (id == -1 || e->id == id)) {
+      start = BLOCK_START(e->block);
+      if(start + CFS_CACHE_BLOCK_SIZE > offset &&
+         (size == 0 || start < offset + size)) {
+        e->backend = NULL;
+      }
+    }
+  }
+
+  if((backend == NULL || last_backend == backend) &&
+     (id == -1 || last_id == id)) {
+    last_backend = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
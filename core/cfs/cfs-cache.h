@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *	A block cache for storage back ends of the file systems.
+ *
+ *	Reads are served from cached blocks, and a miss that continues
+ *	the previous read, or that goes on into the next block, also
+ *	fetches the following blocks. Writes are
+ *	collected in the cached blocks and written back when a block is
+ *	evicted or flushed, so that small writes to the same block reach
+ *	the storage as a single write. Dirty bytes that run on into the
+ *	next block are written back together with it.
+ */
+
+#ifndef CFS_CACHE_H
+#define CFS_CACHE_H
+
+#include "contiki-conf.h"
+#include "cfs/cfs.h"
+
+/**
+ * The storage below the cache. The id is passed through from the
+ * cache functions, so that one back end can serve several files.
+ */
+struct cfs_cache_backend {
+  int (*read)(int id, void *buf, unsigned size, cfs_offset_t offset);
+  int (*write)(int id, const void *buf, unsigned size, cfs_offset_t offset);
+  /* The storage size, or 0 if the storage has no fixed size. Blocks
+     are never read past this size. */
+  cfs_offset_t size;
+};
+
+/* The number of cached blocks, and their size in bytes. */
+#ifdef CFS_CACHE_CONF_BLOCKS
+#define CFS_CACHE_BLOCKS CFS_CACHE_CONF_BLOCKS
+#else
+#define CFS_CACHE_BLOCKS 8
+#endif
+
+#ifdef CFS_CACHE_CONF_BLOCK_SIZE
+#define CFS_CACHE_BLOCK_SIZE CFS_CACHE_CONF_BLOCK_SIZE
+#else
+#define CFS_CACHE_BLOCK_SIZE 32
+#endif
+
+#ifdef CFS_CACHE_CONF_STATS
+#define CFS_CACHE_STATS CFS_CACHE_CONF_STATS
+#else
+#define CFS_CACHE_STATS 0
+#endif
+
+#if CFS_CACHE_STATS
+struct cfs_cache_stats {
+  /* Block accesses served from the cache. */
+  unsigned long hits;
+  /* Block accesses that required a read from the back end. */
+  unsigned long misses;
+  /* Blocks that were read ahead on a sequential miss. */
+  unsigned long read_ahead;
+  /* Whole blocks that were read or written without being cached. */
+  unsigned long direct;
+  /* Writes of dirty blocks to the back end. */
+  unsigned long write_backs;
+};
+
+extern struct cfs_cache_stats cfs_cache_stats;
+#endif /* CFS_CACHE_STATS */
+
+/**
+ * \brief Read through the cache.
+ * \return The amount of bytes read, which is less than size at the
+ *         end of the storage, or -1 if the back end failed.
+ */
+int cfs_cache_read(const struct cfs_cache_backend *backend, int id,
+                   void *buf, unsigned size, cfs_offset_t offset);
+
+/**
+ * \brief Write through the cache.
+ * \return The amount of bytes written, or -1 if the back end failed.
+ *
+ * The data may stay in the cache until the block is evicted or
+ * cfs_cache_flush() is called.
+ */
+int cfs_cache_write(const struct cfs_cache_backend *backend, int id,
+                    const void *buf, unsigned size, cfs_offset_t offset);
+
+/**
+ * \brief Write back the dirty blocks of an id, or of all ids if id is -1.
+ * \return 0 on success, -1 if the back end failed.
+ */
+int cfs_cache_flush(const struct cfs_cache_backend *backend, int id);
+
+/**
+ * \brief Drop the cached blocks that overlap a range without writing them back.
+ *
+ * A NULL backend matches all back ends, an id of -1 matches all ids,
+ * and a size of 0 extends the range to the end of the storage. This
+ * must be called when the storage is changed without going through
+ * the cache, for instance when it is erased.
+ */
+void cfs_cache_invalidate(const struct cfs_cache_backend *backend, int id,
+                          cfs_offset_t offset, cfs_offset_t size);
+
+#endif /* !CFS_CACHE_H */
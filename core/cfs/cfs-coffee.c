@@ -90,16 +90,153 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING	1
 #endif
 
+/*
+ * Keep an index in RAM from file name hashes to the first page of
+ * each file. The index is built by a single scan of the storage at
+ * the first file lookup and is kept up to date when files are
+ * reserved and removed, so that opening a file requires no more than
+ * a header read to verify the name.
+ */
+#ifndef COFFEE_NAME_INDEX
+#define COFFEE_NAME_INDEX	0
+#endif
+
+/* The number of index entries. Must be a power of two. If there are
+   more files than entries, lookups that miss in the index fall back
+   to scanning the storage. */
+#ifndef COFFEE_NAME_INDEX_SIZE
+#define COFFEE_NAME_INDEX_SIZE	32
+#endif
+
+#if COFFEE_NAME_INDEX && (COFFEE_NAME_INDEX_SIZE & (COFFEE_NAME_INDEX_SIZE - 1))
+#error COFFEE_NAME_INDEX_SIZE must be a power of two.
+#endif
+
+/*
+ * Keep the number of active and obsolete pages of each sector in RAM.
+ * The map is built by a single scan of the storage and is updated when
+ * files are reserved, removed, and erased, so that neither garbage
+ * collection nor page allocation has to read page headers.
+ */
+#ifndef COFFEE_SECTOR_MAP
+#define COFFEE_SECTOR_MAP	0
+#endif
+
+/* Erase fully obsolete sectors in a separate process, one at a time,
+   instead of leaving them to the garbage collection in reserve(). */
+#ifndef COFFEE_BACKGROUND_GC
+#define COFFEE_BACKGROUND_GC	0
+#endif
+
+#if COFFEE_BACKGROUND_GC && !COFFEE_SECTOR_MAP
+#error "COFFEE_BACKGROUND_GC requires COFFEE_SECTOR_MAP."
+#endif
+
+/*
+ * Keep a copy of the log index table of modified files in their cached
+ * file objects, so that reading a modified file does not require
+ * searching the table in the storage. Logs with more records than
+ * COFFEE_LOG_INDEX_RECORDS are searched in the storage as before.
+ */
+#ifndef COFFEE_LOG_INDEX
+#define COFFEE_LOG_INDEX	0
+#endif
+
+#ifndef COFFEE_LOG_INDEX_RECORDS
+#define COFFEE_LOG_INDEX_RECORDS	32
+#endif
+
+/*
+ * An erase that is cut short by a power failure can leave a sector
+ * whose first page is free but which still holds old data further on.
+ * Coffee takes such a sector for a free one, and files written there
+ * would get the old data mixed into them. With COFFEE_ERASE_CHECK
+ * set, the free pages of all sectors are read through once after a
+ * restart, before anything is allocated, and the erasure of the
+ * sectors where they are not entirely free is finished. On an empty
+ * file system this reads the whole flash, which takes seconds on a
+ * slow serial flash, so the platform decides.
+ */
+#ifndef COFFEE_ERASE_CHECK
+#define COFFEE_ERASE_CHECK	0
+#endif
+
+/* The buffer size used when a file is copied during a log merge. */
+#ifndef COFFEE_MERGE_BUFFER_SIZE
+#define COFFEE_MERGE_BUFFER_SIZE	COFFEE_PAGE_SIZE
+#endif
+
+/*
+ * Route all storage accesses through the block cache in cfs-cache.c.
+ * Headers and small reads are then served from RAM, and small writes
+ * to the same block are combined. Writes are delayed until the block
+ * is evicted or a file is closed, so a power failure may lose more
+ * than the latest write.
+ */
+#ifndef COFFEE_CACHE
+#define COFFEE_CACHE	0
+#endif
+
+#if COFFEE_LOG_INDEX && !COFFEE_MICRO_LOGS
+#error "COFFEE_LOG_INDEX requires COFFEE_MICRO_LOGS."
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
 
+#if COFFEE_CACHE
+#include "cfs/cfs-cache.h"
+
+static int
+storage_read(int id, void *buf, unsigned size, cfs_offset_t offset)
+{
+  COFFEE_READ(buf, size, offset);
+  return size;
+}
+
+static int
+storage_write(int id, const void *buf, unsigned size, cfs_offset_t offset)
+{
+  COFFEE_WRITE(buf, size, offset);
+  return size;
+}
+
+static const struct cfs_cache_backend storage_cache =
+  {storage_read, storage_write, COFFEE_SIZE};
+
+static void
+storage_erase(unsigned sector)
+{
+  /* The blocks of the sector are dropped, and the writes to other
+     sectors, such as pages isolated ahead of this erase, must reach
+     the storage before it. */
+  cfs_cache_invalidate(&storage_cache, 0,
+                       (cfs_offset_t)sector * COFFEE_SECTOR_SIZE,
+                       COFFEE_SECTOR_SIZE);
+  cfs_cache_flush(&storage_cache, 0);
+  COFFEE_ERASE(sector);
+}
+
+/* The functions above use the storage directly, and everything below
+   goes through the cache. */
+#undef COFFEE_READ
+#define COFFEE_READ(buf, size, offset) \
+	cfs_cache_read(&storage_cache, 0, (void *)(buf), (size), (offset))
+#undef COFFEE_WRITE
+#define COFFEE_WRITE(buf, size, offset) \
+	cfs_cache_write(&storage_cache, 0, (buf), (size), (offset))
+#undef COFFEE_ERASE
+#define COFFEE_ERASE(sector)	storage_erase(sector)
+#endif /* COFFEE_CACHE */
+
 #define COFFEE_FD_FREE		0x0
 #define COFFEE_FD_READ		0x1
 #define COFFEE_FD_WRITE		0x2
 #define COFFEE_FD_APPEND	0x4
 
 #define COFFEE_FILE_MODIFIED	0x1
+#define COFFEE_FILE_LOG_INDEXED	0x2
 
 #define INVALID_PAGE		((coffee_page_t)-1)
 #define UNKNOWN_OFFSET		((cfs_offset_t)-1)
@@ -161,6 +298,29 @@ struct sector_status {
   coffee_page_t free;
 };
 
+#if COFFEE_SECTOR_MAP
+/*
+ * The page counts of a sector. Free pages are always at the end of a
+ * sector, following the active and obsolete ones. The lead is the
+ * amount of pages at the start of the sector that belong to a file
+ * whose header is in a previous sector.
+ */
+struct sector_map {
+  coffee_page_t active;
+  coffee_page_t obsolete;
+  coffee_page_t lead;
+};
+
+/* Ways to update the sector map. */
+#define MAP_ADD_ACTIVE		0
+#define MAP_ADD_OBSOLETE	1
+#define MAP_MAKE_OBSOLETE	2
+
+#define SECTOR_FREE(sector)	(COFFEE_PAGES_PER_SECTOR -		\
+				 sector_map[(sector)].active -		\
+				 sector_map[(sector)].obsolete)
+#endif /* COFFEE_SECTOR_MAP */
+
 /* The structure of cached file objects. */
 struct file {
   cfs_offset_t end;
@@ -169,6 +329,11 @@ struct file {
   int16_t record_count;
   uint8_t references;
   uint8_t flags;
+#if COFFEE_LOG_INDEX
+  /* The region of each used log record, incremented by one as in the
+     storage. Valid if COFFEE_FILE_LOG_INDEXED is set. */
+  uint16_t log_regions[COFFEE_LOG_INDEX_RECORDS];
+#endif
 };
 
 /* The file descriptor structure. */
@@ -193,6 +358,26 @@ struct file_header {
   char name[COFFEE_NAME_LENGTH];
 };
 
+#if COFFEE_NAME_INDEX
+/* An entry in the file name index. A zero hash marks a free entry.
+   The end of a file is remembered when its file object is evicted
+   from the cache, so that reopening the file does not require a
+   search for the end. */
+struct name_entry {
+  cfs_offset_t end;
+  uint16_t hash;
+  coffee_page_t page;
+};
+
+#define NAME_INDEX_MASK		(COFFEE_NAME_INDEX_SIZE - 1)
+
+/* The index state: not yet built, built with every file, or built
+   with some files left out because the index became full. */
+#define NAME_INDEX_UNBUILT	0
+#define NAME_INDEX_COMPLETE	1
+#define NAME_INDEX_PARTIAL	2
+#endif /* COFFEE_NAME_INDEX */
+
 /* This is needed because of a buggy compiler. */
 struct log_param {
   cfs_offset_t offset;
@@ -211,11 +396,39 @@ static struct protected_mem_t {
   struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
   coffee_page_t next_free;
   char gc_wait;
+#if COFFEE_ERASE_CHECK
+  char erases_checked;
+#endif
+#if COFFEE_NAME_INDEX
+  struct name_entry name_index[COFFEE_NAME_INDEX_SIZE];
+  uint16_t name_index_count;
+  char name_index_state;
+#endif
+#if COFFEE_SECTOR_MAP
+  struct sector_map sector_map[COFFEE_SECTOR_COUNT];
+  char sector_map_built;
+#endif
 } protected_mem;
 static struct file * const coffee_files = protected_mem.coffee_files;
 static struct file_desc * const coffee_fd_set = protected_mem.coffee_fd_set;
 static coffee_page_t * const next_free = &protected_mem.next_free;
 static char * const gc_wait = &protected_mem.gc_wait;
+#if COFFEE_ERASE_CHECK
+static char * const erases_checked = &protected_mem.erases_checked;
+#endif
+#if COFFEE_NAME_INDEX
+static struct name_entry * const name_index = protected_mem.name_index;
+static uint16_t * const name_index_count = &protected_mem.name_index_count;
+static char * const name_index_state = &protected_mem.name_index_state;
+#endif
+#if COFFEE_SECTOR_MAP
+static struct sector_map * const sector_map = protected_mem.sector_map;
+static char * const sector_map_built = &protected_mem.sector_map_built;
+#endif
+
+#if COFFEE_BACKGROUND_GC
+PROCESS(coffee_gc_process, "Coffee GC");
+#endif
 
 /*---------------------------------------------------------------------------*/
 static void
@@ -242,6 +455,7 @@ absolute_offset(coffee_page_t page, cfs_offset_t offset)
   return page * COFFEE_PAGE_SIZE + sizeof(struct file_header) + offset;
 }
 /*---------------------------------------------------------------------------*/
+#if !COFFEE_SECTOR_MAP
 static coffee_page_t
 get_sector_status(uint16_t sector, struct sector_status *stats)
 {
@@ -341,6 +555,7 @@ get_sector_status(uint16_t sector, struct sector_status *stats)
   return (last_pages_are_active || (skip_pages >= COFFEE_PAGES_PER_SECTOR)) ?
 	0 : skip_pages;
 }
+#endif /* !COFFEE_SECTOR_MAP */
 /*---------------------------------------------------------------------------*/
 static void
 isolate_pages(coffee_page_t start, coffee_page_t skip_pages)
@@ -362,12 +577,192 @@ isolate_pages(coffee_page_t start, coffee_page_t skip_pages)
 
 }
 /*---------------------------------------------------------------------------*/
+#if !COFFEE_SECTOR_MAP
+static void
+erase_run(uint16_t end, uint16_t count)
+{
+  uint16_t sector;
+  coffee_page_t first_page;
+
+  /*
+   * An obsolete file may cover several of the sectors. They are erased
+   * from the back, so that the header of the file remains until the
+   * pages it covers are gone. Otherwise, a power failure in between
+   * would leave a sector that starts in the middle of a file, and
+   * next_file() would skip the files after it.
+   */
+  for(sector = end; sector > end - count;) {
+    sector--;
+    COFFEE_ERASE(sector);
+    PRINTF("Coffee: Erased sector %d!\n", sector);
+  }
+
+  first_page = (end - count) * COFFEE_PAGES_PER_SECTOR;
+  if(count > 0 && first_page < *next_free) {
+    *next_free = first_page;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* !COFFEE_SECTOR_MAP */
+#if COFFEE_SECTOR_MAP
+static void sector_map_build(void);
+
+static void
+sector_map_update(coffee_page_t start, coffee_page_t count, int how)
+{
+  coffee_page_t page, end, n;
+  uint16_t sector;
+
+  /* A map built now reflects the change already. */
+  if(!*sector_map_built) {
+    sector_map_build();
+    return;
+  }
+
+  end = start + count;
+  if(end > COFFEE_PAGE_COUNT) {
+    end = COFFEE_PAGE_COUNT;
+  }
+
+  for(page = start; page < end; page += n) {
+    sector = page / COFFEE_PAGES_PER_SECTOR;
+    n = (sector + 1) * COFFEE_PAGES_PER_SECTOR - page;
+    if(n > end - page) {
+      n = end - page;
+    }
+
+    if(how == MAP_MAKE_OBSOLETE) {
+      sector_map[sector].active -= n;
+      sector_map[sector].obsolete += n;
+      continue;
+    }
+
+    if(page != start) {
+      sector_map[sector].lead = n;
+    }
+    if(how == MAP_ADD_ACTIVE) {
+      sector_map[sector].active += n;
+    } else {
+      sector_map[sector].obsolete += n;
+    }
+  }
+}
+static void
+sector_map_build(void)
+{
+  struct file_header hdr;
+  coffee_page_t page, count;
+
+  memset(sector_map, 0, sizeof(protected_mem.sector_map));
+  *sector_map_built = 1;
+
+  for(page = 0; page < COFFEE_PAGE_COUNT; page += count) {
+    read_header(&hdr, page);
+    if(HDR_FREE(hdr)) {
+      count = COFFEE_PAGES_PER_SECTOR - page % COFFEE_PAGES_PER_SECTOR;
+    } else if(HDR_ISOLATED(hdr)) {
+      count = 1;
+      sector_map[page / COFFEE_PAGES_PER_SECTOR].obsolete++;
+    } else {
+      count = hdr.max_pages;
+      sector_map_update(page, count,
+                        HDR_ACTIVE(hdr) ? MAP_ADD_ACTIVE : MAP_ADD_OBSOLETE);
+    }
+  }
+  PRINTF("Coffee: Built the sector map\n");
+}
+/*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+static int
+sector_erasable(uint16_t sector, int mode)
+{
+  struct sector_map *map;
+
+  map = &sector_map[sector];
+
+  /*
+   * A sector that is covered by a file starting in a previous sector
+   * can only be erased along with that sector. Neither is there any
+   * gain in erasing a sector whose only obsolete pages belong to such
+   * a file, because these pages must be isolated again.
+   */
+  if(map->active > 0 || map->lead >= COFFEE_PAGES_PER_SECTOR ||
+     map->obsolete <= map->lead) {
+    return 0;
+  }
+
+  return mode == GC_GREEDY || SECTOR_FREE(sector) == 0;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+erase_sectors(uint16_t first)
+{
+  uint16_t sector, last;
+  coffee_page_t first_page, lead;
+
+  /* The sectors that follow and are covered entirely by an obsolete
+     file starting in the first one are erased along with it. */
+  last = first + 1;
+  while(last < COFFEE_SECTOR_COUNT &&
+        sector_map[last].lead >= COFFEE_PAGES_PER_SECTOR) {
+    last++;
+  }
+
+  /*
+   * The last obsolete file may end in the sector after them. Its pages
+   * there are isolated before anything is erased, and the sectors are
+   * erased from the back, so that the header of the file remains
+   * until the pages it covers are gone. Otherwise, a power failure in
+   * between would leave a sector that starts in the middle of a file,
+   * and next_file() would skip the files after it.
+   */
+  if(last < COFFEE_SECTOR_COUNT && sector_map[last].lead > 0) {
+    isolate_pages(last * COFFEE_PAGES_PER_SECTOR, sector_map[last].lead);
+    sector_map[last].lead = 0;
+  }
+
+  lead = sector_map[first].lead;
+  sector = last;
+  do {
+    sector--;
+    COFFEE_ERASE(sector);
+    PRINTF("Coffee: Erased sector %u!\n", sector);
+    sector_map[sector].active = 0;
+    sector_map[sector].obsolete = 0;
+    sector_map[sector].lead = 0;
+  } while(sector > first);
+
+  /*
+   * The header of a file at the start of the first sector is kept
+   * in the previous sector. The erased pages of the file are
+   * isolated so that next_file() can still step over the file, and
+   * they remain the lead of the sector.
+   */
+  first_page = first * COFFEE_PAGES_PER_SECTOR;
+  if(lead > 0) {
+    isolate_pages(first_page, lead);
+    sector_map[first].obsolete = lead;
+    sector_map[first].lead = lead;
+  }
+  if(first_page < *next_free) {
+    *next_free = first_page;
+  }
+
+  return last - first;
+}
+#endif /* COFFEE_SECTOR_MAP */
+/*---------------------------------------------------------------------------*/
 static void
 collect_garbage(int mode)
 {
   uint16_t sector;
+#if COFFEE_SECTOR_MAP
+  uint16_t erased;
+#else
   struct sector_status stats;
-  coffee_page_t first_page, isolation_count;
+  coffee_page_t isolation_count;
+  uint16_t run;
+#endif
 
   PRINTF("Coffee: Running the file system garbage collector in %s mode\n",
 	 mode == GC_RELUCTANT ? "reluctant" : "greedy");
@@ -375,36 +770,87 @@ collect_garbage(int mode)
    * The garbage collector erases as many sectors as possible. A sector is
    * erasable if there are only free or obsolete pages in it.
    */
+#if COFFEE_SECTOR_MAP
+  if(!*sector_map_built) {
+    sector_map_build();
+  }
+
+  for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
+    PRINTF("Coffee: Sector %u has %u active, %u obsolete, and %u free pages.\n",
+        sector, (unsigned)sector_map[sector].active,
+	(unsigned)sector_map[sector].obsolete, (unsigned)SECTOR_FREE(sector));
+
+    if(sector_erasable(sector, mode)) {
+      erased = erase_sectors(sector);
+      if(mode == GC_RELUCTANT) {
+        break;
+      }
+      sector += erased - 1;
+    }
+  }
+#else /* COFFEE_SECTOR_MAP */
+  run = 0;
   for(sector = 0; sector < COFFEE_SECTOR_COUNT; sector++) {
     isolation_count = get_sector_status(sector, &stats);
     PRINTF("Coffee: Sector %u has %u active, %u obsolete, and %u free pages.\n",
         sector, (unsigned)stats.active,
 	(unsigned)stats.obsolete, (unsigned)stats.free);
 
-    if(stats.active > 0) {
+    if(stats.active > 0 ||
+       (mode == GC_RELUCTANT && stats.free > 0) ||
+       (mode == GC_GREEDY && stats.obsolete == 0)) {
+      erase_run(sector, run);
+      run = 0;
       continue;
     }
 
-    if((mode == GC_RELUCTANT && stats.free == 0) ||
-       (mode == GC_GREEDY && stats.obsolete > 0)) {
-      first_page = sector * COFFEE_PAGES_PER_SECTOR;
-      if(first_page < *next_free) {
-        *next_free = first_page;
-      }
+    /* The sector is erased along with the erasable ones following it. */
+    if(isolation_count > 0) {
+      isolate_pages((sector + 1) * COFFEE_PAGES_PER_SECTOR, isolation_count);
+    }
+    run++;
 
-      if(isolation_count > 0) {
-        isolate_pages(first_page + COFFEE_PAGES_PER_SECTOR, isolation_count);
-      }
+    if(mode == GC_RELUCTANT && isolation_count > 0) {
+      sector++;
+      break;
+    }
+  }
+  erase_run(sector, run);
+#endif /* COFFEE_SECTOR_MAP */
+}
+/*---------------------------------------------------------------------------*/
+#if COFFEE_BACKGROUND_GC
+PROCESS_THREAD(coffee_gc_process, ev, data)
+{
+  static uint16_t sector;
 
-      COFFEE_ERASE(sector);
-      PRINTF("Coffee: Erased sector %d!\n", sector);
+  PROCESS_BEGIN();
 
-      if(mode == GC_RELUCTANT && isolation_count > 0) {
-        break;
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+
+    /*
+     * Erase the sectors that contain nothing but obsolete pages. Such
+     * sectors cannot be allocated from, so erasing them early does
+     * not affect the wear levelling. Other processes run between the
+     * erasures, and the search restarts afterwards because files may
+     * have been removed in the meantime.
+     */
+    sector = 0;
+    while(sector < COFFEE_SECTOR_COUNT) {
+      if(sector_erasable(sector, GC_RELUCTANT)) {
+        erase_sectors(sector);
+        PROCESS_PAUSE();
+        sector = 0;
+      } else {
+        sector++;
       }
     }
   }
+
+  PROCESS_END();
 }
+#endif /* COFFEE_BACKGROUND_GC */
 /*---------------------------------------------------------------------------*/
 static coffee_page_t
 next_file(coffee_page_t page, struct file_header *hdr)
@@ -427,6 +873,172 @@ next_file(coffee_page_t page, struct file_header *hdr)
   return page + hdr->max_pages;    
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_ERASE_CHECK
+static void
+check_erases(void)
+{
+  struct file_header hdr;
+  coffee_page_t page, sector_end;
+  cfs_offset_t offset, end;
+  uint32_t buf[8];
+  unsigned i;
+
+  *erases_checked = 1;
+
+  /* The free pages of a sector follow its files, and must all be
+     erased. The files are stepped over rather than read. */
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(!HDR_FREE(hdr)) {
+      continue;
+    }
+
+    sector_end = (page / COFFEE_PAGES_PER_SECTOR + 1) * COFFEE_PAGES_PER_SECTOR;
+    end = (cfs_offset_t)sector_end * COFFEE_PAGE_SIZE;
+    for(offset = (cfs_offset_t)page * COFFEE_PAGE_SIZE; offset < end;
+        offset += sizeof(buf)) {
+      COFFEE_READ(buf, sizeof(buf), offset);
+      for(i = 0; i < sizeof(buf) / sizeof(buf[0]); i++) {
+        if(buf[i] != 0) {
+          break;
+        }
+      }
+      if(i < sizeof(buf) / sizeof(buf[0])) {
+        break;
+      }
+    }
+    if(offset >= end) {
+      continue;
+    }
+
+    /*
+     * A sector that starts with such pages was being erased. Further
+     * on in a sector, they can also be the remains of a header that
+     * was being written, and the files before them must be kept.
+     */
+    if(page % COFFEE_PAGES_PER_SECTOR == 0) {
+      PRINTF("Coffee: Finishing the erasure of sector %u\n",
+             (unsigned)(page / COFFEE_PAGES_PER_SECTOR));
+      COFFEE_ERASE(page / COFFEE_PAGES_PER_SECTOR);
+    } else {
+      isolate_pages(page, sector_end - page);
+      /* Step over the isolated pages at once. */
+      hdr.flags = HDR_FLAG_ALLOCATED;
+      hdr.max_pages = sector_end - page;
+    }
+#if COFFEE_SECTOR_MAP
+    *sector_map_built = 0;
+#endif
+  }
+}
+#endif /* COFFEE_ERASE_CHECK */
+/*---------------------------------------------------------------------------*/
+#if COFFEE_NAME_INDEX
+static uint16_t
+name_hash(const char *name)
+{
+  uint16_t hash;
+  int i;
+
+  /* Only the part of the name that is stored in the header counts. */
+  hash = 5381;
+  for(i = 0; i < COFFEE_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+    hash = ((hash << 5) + hash) ^ (unsigned char)name[i];
+  }
+  hash ^= hash >> 8;
+
+  return hash == 0 ? 1 : hash;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_insert(const char *name, coffee_page_t page)
+{
+  uint16_t hash;
+  unsigned i;
+
+  /* One entry is always left free to terminate the probe sequences. */
+  if(*name_index_count >= COFFEE_NAME_INDEX_SIZE - 1) {
+    /* Lookups must scan the storage on misses from now on. */
+    *name_index_state = NAME_INDEX_PARTIAL;
+    PRINTF("Coffee: The name index is full\n");
+    return;
+  }
+
+  hash = name_hash(name);
+  for(i = hash & NAME_INDEX_MASK; name_index[i].hash != 0;
+      i = (i + 1) & NAME_INDEX_MASK);
+  name_index[i].hash = hash;
+  name_index[i].page = page;
+  name_index[i].end = UNKNOWN_OFFSET;
+  ++*name_index_count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_remove(const char *name, coffee_page_t page)
+{
+  unsigned i, j, k;
+
+  for(i = name_hash(name) & NAME_INDEX_MASK;
+      name_index[i].hash != 0 && name_index[i].page != page;
+      i = (i + 1) & NAME_INDEX_MASK);
+  if(name_index[i].hash == 0) {
+    return;
+  }
+
+  /*
+   * Shift back the following entries of the probe sequence that
+   * would otherwise become unreachable. An entry can fill the hole
+   * at i unless its home slot k lies cyclically within (i, j].
+   */
+  for(j = i;;) {
+    j = (j + 1) & NAME_INDEX_MASK;
+    if(name_index[j].hash == 0) {
+      break;
+    }
+    k = name_index[j].hash & NAME_INDEX_MASK;
+    if(i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+      continue;
+    }
+    name_index[i] = name_index[j];
+    i = j;
+  }
+  name_index[i].hash = 0;
+  --*name_index_count;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_set_end(coffee_page_t page, cfs_offset_t end)
+{
+  unsigned i;
+
+  for(i = 0; i < COFFEE_NAME_INDEX_SIZE; i++) {
+    if(name_index[i].hash != 0 && name_index[i].page == page) {
+      name_index[i].end = end;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_build(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+
+  memset(name_index, 0, sizeof(protected_mem.name_index));
+  *name_index_count = 0;
+  *name_index_state = NAME_INDEX_COMPLETE;
+
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+      name_index_insert(hdr.name, page);
+    }
+  }
+  PRINTF("Coffee: Built the name index\n");
+}
+#endif /* COFFEE_NAME_INDEX */
+/*---------------------------------------------------------------------------*/
 static struct file *
 load_file(coffee_page_t start, struct file_header *hdr)
 {
@@ -456,6 +1068,13 @@ load_file(coffee_page_t start, struct file_header *hdr)
   }
 
   file = &coffee_files[i];
+#if COFFEE_NAME_INDEX
+  if(free == -1) {
+    /* Remember the end of the evicted file for the next time it is
+       opened. */
+    name_index_set_end(file->page, file->end);
+  }
+#endif
   file->page = start;
   file->end = UNKNOWN_OFFSET;
   file->max_pages = hdr->max_pages;
@@ -475,6 +1094,45 @@ find_file(const char *name)
   int i;
   struct file_header hdr;
   coffee_page_t page;
+#if COFFEE_NAME_INDEX
+  struct file *file;
+  uint16_t hash;
+  unsigned j;
+
+  if(*name_index_state == NAME_INDEX_UNBUILT) {
+    name_index_build();
+  }
+
+  hash = name_hash(name);
+  for(j = hash & NAME_INDEX_MASK; name_index[j].hash != 0;
+      j = (j + 1) & NAME_INDEX_MASK) {
+    if(name_index[j].hash != hash) {
+      continue;
+    }
+
+    page = name_index[j].page;
+    read_header(&hdr, page);
+    if(!(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0)) {
+      continue;
+    }
+
+    for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
+      if(!FILE_FREE(&coffee_files[i]) && coffee_files[i].page == page) {
+        return &coffee_files[i];
+      }
+    }
+
+    file = load_file(page, &hdr);
+    if(file != NULL) {
+      file->end = name_index[j].end;
+    }
+    return file;
+  }
+
+  if(*name_index_state == NAME_INDEX_COMPLETE) {
+    return NULL;
+  }
+#endif /* COFFEE_NAME_INDEX */
   
   /* First check if the file metadata is cached. */
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
@@ -533,12 +1191,63 @@ file_end(coffee_page_t start)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_SECTOR_MAP
+static coffee_page_t
+find_contiguous_pages(coffee_page_t amount)
+{
+  uint16_t sector;
+  coffee_page_t start, run, free;
+
+#if COFFEE_ERASE_CHECK
+  if(!*erases_checked) {
+    check_erases();
+  }
+#endif
+  if(!*sector_map_built) {
+    sector_map_build();
+  }
+
+  /*
+   * A contiguous extent consists of the free pages at the end of a
+   * sector, followed by any number of completely free sectors.
+   */
+  start = INVALID_PAGE;
+  run = 0;
+  for(sector = *next_free / COFFEE_PAGES_PER_SECTOR;
+      sector < COFFEE_SECTOR_COUNT; sector++) {
+    free = SECTOR_FREE(sector);
+    if(start != INVALID_PAGE && free == COFFEE_PAGES_PER_SECTOR) {
+      run += free;
+    } else if(free > 0) {
+      start = (sector + 1) * COFFEE_PAGES_PER_SECTOR - free;
+      run = free;
+    } else {
+      start = INVALID_PAGE;
+      continue;
+    }
+
+    if(run >= amount) {
+      if(start == *next_free) {
+        *next_free = start + amount;
+      }
+      return start;
+    }
+  }
+  return INVALID_PAGE;
+}
+#else /* COFFEE_SECTOR_MAP */
 static coffee_page_t
 find_contiguous_pages(coffee_page_t amount)
 {
   coffee_page_t page, start;
   struct file_header hdr;
 
+#if COFFEE_ERASE_CHECK
+  if(!*erases_checked) {
+    check_erases();
+  }
+#endif
+
   start = INVALID_PAGE;
   for(page = *next_free; page < COFFEE_PAGE_COUNT;) {
     read_header(&hdr, page);
@@ -568,6 +1277,7 @@ find_contiguous_pages(coffee_page_t amount)
   }
   return INVALID_PAGE;
 }
+#endif /* COFFEE_SECTOR_MAP */
 /*---------------------------------------------------------------------------*/
 static int
 remove_by_page(coffee_page_t page, int remove_log, int close_fds,
@@ -581,6 +1291,12 @@ remove_by_page(coffee_page_t page, int remove_log, int close_fds,
     return -1;
   }
 
+#if COFFEE_NAME_INDEX
+  if(!HDR_LOG(hdr)) {
+    name_index_remove(hdr.name, page);
+  }
+#endif
+
   if(remove_log && HDR_MODIFIED(hdr)) {
     if(remove_by_page(hdr.log_page, !REMOVE_LOG, !CLOSE_FDS, !ALLOW_GC) < 0) {
       return -1;
@@ -589,6 +1305,9 @@ remove_by_page(coffee_page_t page, int remove_log, int close_fds,
 
   hdr.flags |= HDR_FLAG_OBSOLETE;
   write_header(&hdr, page);
+#if COFFEE_SECTOR_MAP
+  sector_map_update(page, hdr.max_pages, MAP_MAKE_OBSOLETE);
+#endif
 
   *gc_wait = 0;
 
@@ -609,7 +1328,12 @@ remove_by_page(coffee_page_t page, int remove_log, int close_fds,
     }
   }
 
-#if !COFFEE_EXTENDED_WEAR_LEVELLING
+#if COFFEE_BACKGROUND_GC
+  if(!process_is_running(&coffee_gc_process)) {
+    process_start(&coffee_gc_process, NULL);
+  }
+  process_poll(&coffee_gc_process);
+#elif !COFFEE_EXTENDED_WEAR_LEVELLING
   if(gc_allowed) {
     collect_garbage(GC_RELUCTANT);
   }
@@ -655,6 +1379,15 @@ reserve(const char *name, coffee_page_t pages,
   hdr.max_pages = pages;
   hdr.flags = HDR_FLAG_ALLOCATED | flags;
   write_header(&hdr, page);
+#if COFFEE_SECTOR_MAP
+  sector_map_update(page, pages, MAP_ADD_ACTIVE);
+#endif
+
+#if COFFEE_NAME_INDEX
+  if(!(flags & HDR_FLAG_LOG) && *name_index_state != NAME_INDEX_UNBUILT) {
+    name_index_insert(hdr.name, page);
+  }
+#endif
 
   PRINTF("Coffee: Reserved %u pages starting from %u for file %s\n",
       pages, page, name);
@@ -697,6 +1430,43 @@ modify_log_buffer(uint16_t log_record_size,
 }
 #endif /* COFFEE_MICRO_LOGS */
 /*---------------------------------------------------------------------------*/
+#if COFFEE_LOG_INDEX
+static int
+log_index_load(struct file *file, coffee_page_t log_page, uint16_t log_records)
+{
+  uint16_t i;
+
+  if(file->flags & COFFEE_FILE_LOG_INDEXED) {
+    return 1;
+  }
+  if(log_records > COFFEE_LOG_INDEX_RECORDS) {
+    return 0;
+  }
+
+  COFFEE_READ(file->log_regions, log_records * sizeof(file->log_regions[0]),
+              absolute_offset(log_page, 0));
+  for(i = 0; i < log_records && file->log_regions[i] != 0; i++);
+
+  /* The next record is known now as well. */
+  file->record_count = i;
+  file->flags |= COFFEE_FILE_LOG_INDEXED;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+log_index_find(struct file *file, uint16_t search_records, uint16_t region)
+{
+  int i;
+
+  for(i = search_records - 1; i >= 0; i--) {
+    if(file->log_regions[i] - 1 == region) {
+      return i;
+    }
+  }
+  return -1;
+}
+#endif /* COFFEE_LOG_INDEX */
+/*---------------------------------------------------------------------------*/
 #if COFFEE_MICRO_LOGS
 static int
 get_record_index(coffee_page_t log_page, uint16_t search_records,
@@ -741,8 +1511,8 @@ get_record_index(coffee_page_t log_page, uint16_t search_records,
 /*---------------------------------------------------------------------------*/
 #if COFFEE_MICRO_LOGS
 static int
-read_log_page(struct file_header *hdr, int16_t record_count,
-              struct log_param *lp)
+read_log_page(struct file *file, struct file_header *hdr,
+              int16_t record_count, struct log_param *lp)
 {
   uint16_t region;
   int16_t match_index;
@@ -755,7 +1525,15 @@ read_log_page(struct file_header *hdr, int16_t record_count,
   region = modify_log_buffer(log_record_size, &lp->offset, &lp->size);
 
   search_records = record_count < 0 ? log_records : record_count;
+#if COFFEE_LOG_INDEX
+  if(log_index_load(file, hdr->log_page, log_records)) {
+    match_index = log_index_find(file, search_records, region);
+  } else {
+    match_index = get_record_index(hdr->log_page, search_records, region);
+  }
+#else
   match_index = get_record_index(hdr->log_page, search_records, region);
+#endif
   if(match_index < 0) {
     return -1;
   }
@@ -792,10 +1570,83 @@ create_log(struct file *file, struct file_header *hdr)
   write_header(hdr, file->page);
 
   file->flags |= COFFEE_FILE_MODIFIED;
+#if COFFEE_LOG_INDEX
+  if(log_records <= COFFEE_LOG_INDEX_RECORDS) {
+    file->flags |= COFFEE_FILE_LOG_INDEXED;
+  }
+#endif
   return log_file->page;
 }
 #endif /* COFFEE_MICRO_LOGS */
 /*---------------------------------------------------------------------------*/
+static cfs_offset_t
+copy_extents(struct file *file, struct file_header *hdr, coffee_page_t dest)
+{
+  char buf[COFFEE_MERGE_BUFFER_SIZE];
+  cfs_offset_t offset, n;
+#if COFFEE_LOG_INDEX
+  uint16_t log_record_size = 0, log_records = 0;
+  uint16_t region;
+  cfs_offset_t run;
+  int record;
+#endif
+
+  if(FILE_MODIFIED(file)) {
+#if COFFEE_LOG_INDEX
+    adjust_log_config(hdr, &log_record_size, &log_records);
+    if(!log_index_load(file, hdr->log_page, log_records)) {
+      return -1;
+    }
+#else
+    return -1;
+#endif
+  }
+
+  /*
+   * Copy the unchanged parts of the file in as large batches as the
+   * buffer allows, and each logged region from its newest log record.
+   */
+  for(offset = 0; offset < file->end; offset += n) {
+    n = file->end - offset;
+    if(n > (cfs_offset_t)sizeof(buf)) {
+      n = sizeof(buf);
+    }
+
+#if COFFEE_LOG_INDEX
+    if(FILE_MODIFIED(file)) {
+      region = offset / log_record_size;
+      run = (region + 1) * log_record_size - offset;
+      record = log_index_find(file, file->record_count, region);
+      if(record >= 0) {
+        if(n > run) {
+          n = run;
+        }
+        COFFEE_READ(buf, n,
+                    absolute_offset(hdr->log_page,
+                                    log_records * sizeof(region)) +
+                    (cfs_offset_t)record * log_record_size +
+                    offset % log_record_size);
+        COFFEE_WRITE(buf, n, absolute_offset(dest, offset));
+        continue;
+      }
+
+      while(run < n && log_index_find(file, file->record_count,
+                                      ++region) < 0) {
+        run += log_record_size;
+      }
+      if(n > run) {
+        n = run;
+      }
+    }
+#endif /* COFFEE_LOG_INDEX */
+
+    COFFEE_READ(buf, n, absolute_offset(file->page, offset));
+    COFFEE_WRITE(buf, n, absolute_offset(dest, offset));
+  }
+
+  return file->end;
+}
+/*---------------------------------------------------------------------------*/
 static int
 merge_log(coffee_page_t file_page, int extend)
 {
@@ -824,19 +1675,23 @@ merge_log(coffee_page_t file_page, int extend)
     return -1;
   }
 
-  offset = 0;
-  do {
-    char buf[hdr.log_record_size == 0 ? COFFEE_PAGE_SIZE : hdr.log_record_size];
-    n = cfs_read(fd, buf, sizeof(buf));
-    if(n < 0) {
-      remove_by_page(new_file->page, !REMOVE_LOG, !CLOSE_FDS, ALLOW_GC);
-      cfs_close(fd);
-      return -1;
-    } else if(n > 0) {
-      COFFEE_WRITE(buf, n, absolute_offset(new_file->page, offset));
-      offset += n;
-    }
-  } while(n != 0);
+  offset = copy_extents(coffee_fd_set[fd].file, &hdr, new_file->page);
+  if(offset < 0) {
+    /* Read the file record by record through its log. */
+    offset = 0;
+    do {
+      char buf[hdr.log_record_size == 0 ? COFFEE_PAGE_SIZE : hdr.log_record_size];
+      n = cfs_read(fd, buf, sizeof(buf));
+      if(n < 0) {
+        remove_by_page(new_file->page, !REMOVE_LOG, !CLOSE_FDS, ALLOW_GC);
+        cfs_close(fd);
+        return -1;
+      } else if(n > 0) {
+        COFFEE_WRITE(buf, n, absolute_offset(new_file->page, offset));
+        offset += n;
+      }
+    } while(n != 0);
+  }
 
   for(i = 0; i < COFFEE_FD_SET_SIZE; i++) {
     if(coffee_fd_set[i].flags != COFFEE_FD_FREE && 
@@ -927,6 +1782,9 @@ write_log_page(struct file *file, struct log_param *lp)
   if(HDR_MODIFIED(hdr)) {
     /* A log structure has already been created. */
     log_page = hdr.log_page;
+#if COFFEE_LOG_INDEX
+    log_index_load(file, log_page, log_records);
+#endif
     log_record = find_next_record(file, log_page, log_records);
     if(log_record >= log_records) {
       /* The log is full; merge the log. */
@@ -953,7 +1811,7 @@ write_log_page(struct file *file, struct log_param *lp)
     lp_out.size = log_record_size;
 
     if((lp->offset > 0 || lp->size != log_record_size) &&
-	read_log_page(&hdr, log_record, &lp_out) < 0) {
+	read_log_page(file, &hdr, log_record, &lp_out) < 0) {
       COFFEE_READ(copy_buf, sizeof(copy_buf),
 	  absolute_offset(file->page, offset));
     }
@@ -973,6 +1831,11 @@ write_log_page(struct file *file, struct log_param *lp)
     COFFEE_WRITE(copy_buf, sizeof(copy_buf),
 		 offset + log_record * log_record_size);
     file->record_count = log_record + 1;
+#if COFFEE_LOG_INDEX
+    if(file->flags & COFFEE_FILE_LOG_INDEXED) {
+      file->log_regions[log_record] = region;
+    }
+#endif
   }
 
   return lp->size;
@@ -1035,6 +1898,9 @@ cfs_close(int fd)
     coffee_fd_set[fd].flags = COFFEE_FD_FREE;
     coffee_fd_set[fd].file->references--;
     coffee_fd_set[fd].file = NULL;
+#if COFFEE_CACHE
+    cfs_cache_flush(&storage_cache, 0);
+#endif
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -1131,7 +1997,7 @@ cfs_read(int fd, void *buf, unsigned size)
     lp.offset = fdp->offset;
     lp.buf = buf;
     lp.size = bytes_left;
-    r = read_log_page(&hdr, file->record_count, &lp);
+    r = read_log_page(file, &hdr, file->record_count, &lp);
 
     /* Read from the original file if we cannot find the data in the log. */
     if(r < 0) {
@@ -1264,8 +2130,15 @@ cfs_readdir(struct cfs_dir *dir, struct cfs_dirent *record)
     read_header(&hdr, page);
     if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
       coffee_page_t next_page;
-      memcpy(record->name, hdr.name, sizeof(record->name));
-      record->name[sizeof(record->name) - 1] = '\0';
+      unsigned name_length;
+
+      /* The name in the header need not end with a NUL. */
+      name_length = sizeof(hdr.name);
+      if(name_length > sizeof(record->name) - 1) {
+        name_length = sizeof(record->name) - 1;
+      }
+      memcpy(record->name, hdr.name, name_length);
+      record->name[name_length] = '\0';
       record->size = file_end(page);
 
       next_page = next_file(page, &hdr);
@@ -1350,6 +2223,16 @@ cfs_coffee_format(void)
 
   /* Formatting invalidates the file information. */
   memset(&protected_mem, 0, sizeof(protected_mem));
+#if COFFEE_NAME_INDEX
+  /* The storage is empty, so there is nothing to index. */
+  *name_index_state = NAME_INDEX_COMPLETE;
+#endif
+#if COFFEE_SECTOR_MAP
+  *sector_map_built = 1;
+#endif
+#if COFFEE_ERASE_CHECK
+  *erases_checked = 1;
+#endif
 
   PRINTF(" done!\n");
 
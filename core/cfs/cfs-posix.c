@@ -41,13 +41,51 @@
 #include <unistd.h>
 #endif
 
+#include "contiki-conf.h"
 #include "cfs/cfs.h"
 
+/* Keep small reads and writes in the block cache of cfs-cache.c.
+   Cached blocks belong to a file descriptor, so a file that is open
+   more than once may be seen differently through each descriptor
+   until they are closed. */
+#ifdef CFS_POSIX_CONF_CACHE
+#define CFS_POSIX_CACHE CFS_POSIX_CONF_CACHE
+#else
+#define CFS_POSIX_CACHE 0
+#endif
+
+#if CFS_POSIX_CACHE
+#include "cfs/cfs-cache.h"
+
+static int
+posix_read(int f, void *b, unsigned int l, cfs_offset_t o)
+{
+  if(lseek(f, o, SEEK_SET) == (off_t)-1) {
+    return -1;
+  }
+  return read(f, b, l);
+}
+
+static int
+posix_write(int f, const void *b, unsigned int l, cfs_offset_t o)
+{
+  if(lseek(f, o, SEEK_SET) == (off_t)-1) {
+    return -1;
+  }
+  return write(f, b, l);
+}
+
+static const struct cfs_cache_backend posix_cache = {posix_read, posix_write, 0};
+#endif /* CFS_POSIX_CACHE */
+
 /*---------------------------------------------------------------------------*/
 int
 cfs_open(const char *n, int f)
 {
   int s = 0;
+#if CFS_POSIX_CACHE
+  int fd;
+#endif
   if(f == CFS_READ) {
     return open(n, O_RDONLY);
   } else if(f & CFS_WRITE) {
@@ -57,12 +95,25 @@ cfs_open(const char *n, int f)
     } else {
       s |= O_WRONLY;
     }
+#if CFS_POSIX_CACHE
+    /* The cache writes at explicit offsets, so appending is done by
+       starting at the end of the file. */
+    if(!(f & CFS_APPEND)) {
+      s |= O_TRUNC;
+    }
+    fd = open(n, s, 0600);
+    if(fd >= 0 && (f & CFS_APPEND)) {
+      lseek(fd, 0, SEEK_END);
+    }
+    return fd;
+#else
     if(f & CFS_APPEND) {
       s |= O_APPEND;
     } else {
       s |= O_TRUNC;
     }
     return open(n, s, 0600);
+#endif /* CFS_POSIX_CACHE */
   }
   return -1;
 }
@@ -70,19 +121,49 @@ cfs_open(const char *n, int f)
 void
 cfs_close(int f)
 {
+#if CFS_POSIX_CACHE
+  cfs_cache_flush(&posix_cache, f);
+  cfs_cache_invalidate(&posix_cache, f, 0, 0);
+#endif
   close(f);
 }
 /*---------------------------------------------------------------------------*/
 int
 cfs_read(int f, void *b, unsigned int l)
 {
+#if CFS_POSIX_CACHE
+  off_t o;
+  int r;
+
+  o = lseek(f, 0, SEEK_CUR);
+  if(o == (off_t)-1) {
+    return -1;
+  }
+  r = cfs_cache_read(&posix_cache, f, b, l, o);
+  lseek(f, r > 0 ? o + r : o, SEEK_SET);
+  return r;
+#else
   return read(f, b, l);
+#endif
 }
 /*---------------------------------------------------------------------------*/
 int
 cfs_write(int f, const void *b, unsigned int l)
 {
+#if CFS_POSIX_CACHE
+  off_t o;
+  int r;
+
+  o = lseek(f, 0, SEEK_CUR);
+  if(o == (off_t)-1) {
+    return -1;
+  }
+  r = cfs_cache_write(&posix_cache, f, b, l, o);
+  lseek(f, r > 0 ? o + r : o, SEEK_SET);
+  return r;
+#else
   return write(f, b, l);
+#endif
 }
 /*---------------------------------------------------------------------------*/
 cfs_offset_t
@@ -93,6 +174,10 @@ cfs_seek(int f, cfs_offset_t o, int w)
   } else if(w == CFS_SEEK_CUR) {
     w = SEEK_CUR;
   } else if(w == CFS_SEEK_END) {
+#if CFS_POSIX_CACHE
+    /* Written blocks may extend the file. */
+    cfs_cache_flush(&posix_cache, f);
+#endif
     w = SEEK_END;
   } else {
     return (cfs_offset_t)-1;
@@ -121,7 +121,7 @@ volatile uint16_t cc2420_sfd_end_time;
 
 static volatile uint16_t last_packet_timestamp;
 /*---------------------------------------------------------------------------*/
-PROCESS(cc2420_process, "CC2420 driver");
+PROCESS_PRIO(cc2420_process, "CC2420 driver", PROCESS_PRIO_HIGH);
 /*---------------------------------------------------------------------------*/
 
 
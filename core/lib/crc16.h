@@ -55,6 +55,18 @@
 #ifndef __CRC16_H__
 #define __CRC16_H__
 
+/*
+ * Implementations selectable with CRC16_CONF_METHOD. The bitwise
+ * variant needs no tables and is the default. The nibble variant
+ * uses a 32 byte table, the table variant a 512 byte table and the
+ * slicing variant additionally builds 1.5 kilobytes of tables in RAM
+ * to process four bytes per round in crc16_data().
+ */
+#define CRC16_BITWISE 0
+#define CRC16_NIBBLE  1
+#define CRC16_TABLE   2
+#define CRC16_SLICE4  3
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -65,10 +77,10 @@
  *             with one byte. It can be used as a running checksum, or
  *             to checksum an entire data block.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note With the default CRC16_BITWISE method the
+ *             algorithm is tailored for a running checksum and does
+ *             not perform as well as a table-driven algorithm when
+ *             checksumming an entire data block.
  *
  */
 unsigned short crc16_add(unsigned char b, unsigned short crc);
@@ -82,14 +94,21 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note With the default CRC16_BITWISE method the
+ *             algorithm is tailored for a running checksum and does
+ *             not perform as well as a table-driven algorithm when
+ *             checksumming an entire data block.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
 
+/**
+ * \brief      Check the configured CRC16 method against the bitwise one
+ * \return     Non-zero if crc16_add() and crc16_data() agree with the
+ *             bitwise reference implementation, zero otherwise.
+ */
+int crc16_selfcheck(void);
+
 #endif /* __CRC16_H__ */
 
 /** @} */
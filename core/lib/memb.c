@@ -48,18 +48,86 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+#if MEMB_STATS
+static struct memb *stats_list;
+#endif /* MEMB_STATS */
+
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
   memset(m->count, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_FREELIST
+  m->free = 0;
+  m->unused = 0;
+#endif /* MEMB_FREELIST */
+#if MEMB_STATS
+  m->used = 0;
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+static void
+count_alloc(struct memb *m, void *ptr)
+{
+  if(!m->listed) {
+    m->listed = 1;
+    m->next = stats_list;
+    stats_list = m;
+  }
+  if(ptr == NULL) {
+    m->failures++;
+  } else if(++m->used > m->peak) {
+    m->peak = m->used;
+  }
+}
+#else /* MEMB_STATS */
+#define count_alloc(m, ptr)
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
+#if MEMB_FREELIST
+/* The free list is kept in the links array of MEMB(). Blocks declared
+   without one fall back to scanning. */
+#define HAS_LINK(m) ((m)->links != NULL)
+
+static void *
+freelist_alloc(struct memb *m)
+{
+  unsigned short i;
+
+  if(m->free != 0) {
+    i = m->free - 1;
+    m->free = m->links[i];
+  } else {
+    /* Blocks can be in use before the list has reached them if the
+       count array was filled in by hand. */
+    while(m->unused < m->num && m->count[m->unused] != 0) {
+      m->unused++;
+    }
+    if(m->unused == m->num) {
+      return NULL;
+    }
+    i = m->unused++;
+  }
+  m->count[i] = 1;
+  return (char *)m->mem + i * m->size;
+}
+#endif /* MEMB_FREELIST */
+/*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
   int i;
+  void *ptr;
+
+#if MEMB_FREELIST
+  if(HAS_LINK(m)) {
+    ptr = freelist_alloc(m);
+    count_alloc(m, ptr);
+    return ptr;
+  }
+#endif /* MEMB_FREELIST */
 
   for(i = 0; i < m->num; ++i) {
     if(m->count[i] == 0) {
@@ -67,12 +135,15 @@ memb_alloc(struct memb *m)
 	 indicate that it now is used and return a pointer to the
 	 memory block. */
       ++(m->count[i]);
-      return (void *)((char *)m->mem + (i * m->size));
+      ptr = (void *)((char *)m->mem + (i * m->size));
+      count_alloc(m, ptr);
+      return ptr;
     }
   }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
+  count_alloc(m, NULL);
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -82,6 +153,35 @@ memb_free(struct memb *m, void *ptr)
   int i;
   char *ptr2;
 
+#if MEMB_FREELIST
+  if(HAS_LINK(m)) {
+    unsigned long offset;
+
+    if(!memb_inmemb(m, ptr)) {
+      return -1;
+    }
+    offset = (char *)ptr - (char *)m->mem;
+    if(offset % m->size != 0) {
+      return -1;
+    }
+    i = offset / m->size;
+    if(m->count[i] > 0 && --(m->count[i]) == 0) {
+      /* Only blocks the list has reached can go back on it;
+         the others are picked up when it gets there. */
+      if(i < m->unused) {
+        m->links[i] = m->free;
+        m->free = i + 1;
+      }
+#if MEMB_STATS
+      if(m->used > 0) {
+        m->used--;
+      }
+#endif /* MEMB_STATS */
+    }
+    return m->count[i];
+  }
+#endif /* MEMB_FREELIST */
+
   /* Walk through the list of blocks and try to find the block to
      which the pointer "ptr" points to. */
   ptr2 = (char *)m->mem;
@@ -93,6 +193,11 @@ memb_free(struct memb *m, void *ptr)
       if(m->count[i] > 0) {
 	/* Make sure that we don't deallocate free memory. */
 	--(m->count[i]);
+#if MEMB_STATS
+	if(m->count[i] == 0 && m->used > 0) {
+	  m->used--;
+	}
+#endif /* MEMB_STATS */
       }
       return m->count[i];
     }
@@ -108,5 +213,24 @@ memb_inmemb(struct memb *m, void *ptr)
     (char *)ptr < (char *)m->mem + (m->num * m->size);
 }
 /*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+struct memb *
+memb_stats_list(void)
+{
+  return stats_list;
+}
+/*---------------------------------------------------------------------------*/
+void
+memb_stats_clear(void)
+{
+  struct memb *m;
+
+  for(m = stats_list; m != NULL; m = m->next) {
+    m->peak = m->used;
+    m->failures = 0;
+  }
+}
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
 
 /** @} */
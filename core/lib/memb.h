@@ -66,6 +66,47 @@
 
 #include "sys/cc.h"
 
+/**
+ * With MEMB_CONF_FREELIST set, freed blocks are kept on a list, so
+ * that memb_alloc() and memb_free() take constant time instead of
+ * scanning the block. The list is kept in an array of one unsigned
+ * short per block, declared by MEMB(), so the contents of a freed
+ * block are left alone. A struct memb set up without MEMB() is
+ * scanned as before.
+ */
+#ifdef MEMB_CONF_FREELIST
+#define MEMB_FREELIST MEMB_CONF_FREELIST
+#else
+#define MEMB_FREELIST 0
+#endif
+
+/**
+ * With MEMB_CONF_STATS set, every memory block keeps count of the
+ * blocks in use, the most ever in use and the failed allocations.
+ * Memory blocks appear in memb_stats_list() once they have been
+ * allocated from.
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else
+#define MEMB_STATS 0
+#endif
+
+#if MEMB_STATS
+#define MEMB_NAME(name) , #name
+#else
+#define MEMB_NAME(name)
+#endif
+
+#if MEMB_FREELIST
+#define MEMB_LINKS_DECLARE(name, num) \
+        static unsigned short CC_CONCAT(name,_memb_links)[num];
+#define MEMB_LINKS(name) , CC_CONCAT(name,_memb_links)
+#else
+#define MEMB_LINKS_DECLARE(name, num)
+#define MEMB_LINKS(name)
+#endif
+
 /**
  * Declare a memory block.
  *
@@ -89,16 +130,37 @@ MEMB(connections, struct connection, 16);
  */
 #define MEMB(name, structure, num) \
         static char CC_CONCAT(name,_memb_count)[num]; \
+        MEMB_LINKS_DECLARE(name, num) \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_count), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_NAME(name) MEMB_LINKS(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
   char *count;
   void *mem;
+#if MEMB_STATS
+  const char *name;
+#endif /* MEMB_STATS */
+#if MEMB_FREELIST
+  /* For each freed block, index + 1 of the next one on the list. */
+  unsigned short *links;
+  /* Index + 1 of the first freed block, 0 if there is none. */
+  unsigned short free;
+  /* Blocks from this index on have not been allocated since
+     memb_init(). */
+  unsigned short unused;
+#endif /* MEMB_FREELIST */
+#if MEMB_STATS
+  struct memb *next;
+  unsigned short used;
+  unsigned short peak;
+  unsigned short failures;
+  unsigned char listed;
+#endif /* MEMB_STATS */
 };
 
 /**
@@ -131,6 +193,19 @@ char  memb_free(struct memb *m, void *ptr);
 
 int memb_inmemb(struct memb *m, void *ptr);
 
+#if MEMB_STATS
+/**
+ * Get the memory blocks that have been allocated from, linked through
+ * their next field.
+ */
+struct memb *memb_stats_list(void);
+
+/**
+ * Restart the peak and failure counts of all memory blocks.
+ */
+void memb_stats_clear(void);
+#endif /* MEMB_STATS */
+
 
 /** @} */
 /** @} */
@@ -56,10 +56,112 @@
 #define MMEM_SIZE 4096
 #endif
 
+/* The number of size classes of freed blocks. Class i holds the
+   blocks of MMEM_MIN << i bytes or more, up to the next class. */
+#ifdef MMEM_CONF_CLASSES
+#define MMEM_CLASSES MMEM_CONF_CLASSES
+#else
+#define MMEM_CLASSES 8
+#endif
+
+/* A freed block, waiting in its size class to be reused. */
+struct free_block {
+  struct free_block *next;
+  unsigned int size;
+};
+
+/* Blocks are rounded up to hold a free_block when freed. */
+#define MMEM_ALIGN sizeof(struct free_block *)
+#define MMEM_MIN sizeof(struct free_block)
+#define MMEM_ROUND(size) ((size) < MMEM_MIN ? MMEM_MIN :                \
+                          ((size) + MMEM_ALIGN - 1) & ~(MMEM_ALIGN - 1))
+
+/* The list of allocated blocks, in address order. */
 LIST(mmemlist);
+/* Bytes not allocated: the free space at the top, the freed blocks
+   and the unused ends of reused blocks. */
 unsigned int avail_memory;
-static char memory[MMEM_SIZE];
+static struct free_block memory_blocks[(MMEM_SIZE + MMEM_MIN - 1) / MMEM_MIN];
+#define memory ((char *)memory_blocks)
+/* The end of the highest allocated block. */
+static unsigned int top;
+static struct free_block *free_lists[MMEM_CLASSES];
+
+#if MMEM_STATS
+static unsigned int peak;
+static unsigned int compactions;
+#endif /* MMEM_STATS */
+
+/*---------------------------------------------------------------------------*/
+static int
+size_class(unsigned int size)
+{
+  int c;
+
+  for(c = 0; c < MMEM_CLASSES - 1 && size >= (MMEM_MIN << (c + 1)); ++c);
+  return c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_free(char *ptr, unsigned int size)
+{
+  struct free_block *f = (struct free_block *)ptr;
+  int c = size_class(size);
+
+  f->size = size;
+  f->next = free_lists[c];
+  free_lists[c] = f;
+}
+/*---------------------------------------------------------------------------*/
+/* Take a freed block of at least size bytes, splitting off the rest
+   of it if that is large enough to be reused. */
+static char *
+get_free(unsigned int size)
+{
+  struct free_block **fp, *f;
+  int c;
+
+  /* Only the blocks of the smallest class may be too small. */
+  for(c = size_class(size); c < MMEM_CLASSES; ++c) {
+    for(fp = &free_lists[c]; *fp != NULL; fp = &(*fp)->next) {
+      f = *fp;
+      if(f->size >= size) {
+        *fp = f->next;
+        if(f->size - size >= MMEM_MIN) {
+          put_free((char *)f + size, f->size - size);
+        }
+        return (char *)f;
+      }
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Move all allocated blocks to the bottom of the memory, in address
+   order, and drop the freed blocks. */
+static void
+compact(void)
+{
+  struct mmem *n;
+  unsigned int size;
+  int c;
 
+  top = 0;
+  for(n = list_head(mmemlist); n != NULL; n = n->next) {
+    size = MMEM_ROUND(n->size);
+    if((char *)n->ptr != &memory[top]) {
+      memmove(&memory[top], n->ptr, size);
+      n->ptr = &memory[top];
+    }
+    top += size;
+  }
+  for(c = 0; c < MMEM_CLASSES; ++c) {
+    free_lists[c] = NULL;
+  }
+#if MMEM_STATS
+  compactions++;
+#endif /* MMEM_STATS */
+}
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Allocate a managed memory block
@@ -73,6 +175,12 @@ static char memory[MMEM_SIZE];
  *             memory allocated with this function must be deallocated
  *             using the mmem_free() function.
  *
+ *             A freed block of the right size class is reused if
+ *             there is one, otherwise the block is taken from the top
+ *             of the memory. If the free space is too fragmented for
+ *             the block, the memory is compacted first, which moves
+ *             the other blocks.
+ *
  *             \note This function does NOT return a pointer to the
  *             allocated memory, but a pointer to a structure that
  *             contains information about the managed memory. The
@@ -83,24 +191,46 @@ static char memory[MMEM_SIZE];
 int
 mmem_alloc(struct mmem *m, unsigned int size)
 {
+  struct mmem *n, *prev;
+  unsigned int rsize = MMEM_ROUND(size);
+  char *ptr;
+
   /* Check if we have enough memory left for this allocation. */
-  if(avail_memory < size) {
+  if(size > MMEM_SIZE || avail_memory < rsize) {
     return 0;
   }
 
-  /* We had enough memory so we add this memory block to the end of
-     the list of allocated memory blocks. */
-  list_add(mmemlist, m);
+  ptr = get_free(rsize);
+  if(ptr != NULL) {
+    /* Keep the list in address order, for compact(). */
+    prev = NULL;
+    for(n = list_head(mmemlist); n != NULL && (char *)n->ptr < ptr;
+        n = n->next) {
+      prev = n;
+    }
+    list_insert(mmemlist, prev, m);
+  } else {
+    if(MMEM_SIZE - top < rsize) {
+      compact();
+    }
+    ptr = &memory[top];
+    top += rsize;
+    list_add(mmemlist, m);
+  }
 
-  /* Set up the pointer so that it points to the first available byte
-     in the memory block. */
-  m->ptr = &memory[MMEM_SIZE - avail_memory];
+  m->ptr = ptr;
 
   /* Remember the size of this memory block. */
   m->size = size;
 
   /* Decrease the amount of available memory. */
-  avail_memory -= size;
+  avail_memory -= rsize;
+
+#if MMEM_STATS
+  if(MMEM_SIZE - avail_memory > peak) {
+    peak = MMEM_SIZE - avail_memory;
+  }
+#endif /* MMEM_STATS */
 
   /* Return non-zero to indicate that we were able to allocate
      memory. */
@@ -113,33 +243,68 @@ mmem_alloc(struct mmem *m, unsigned int size)
  * \author     Adam Dunkels
  *
  *             This function deallocates a managed memory block that
- *             previously has been allocated with mmem_alloc().
+ *             previously has been allocated with mmem_alloc(). No
+ *             other block is moved.
  *
  */
 void
 mmem_free(struct mmem *m)
 {
-  struct mmem *n;
+  unsigned int rsize = MMEM_ROUND(m->size);
 
-  if(m->next != NULL) {
-    /* Compact the memory after the allocation that is to be removed
-       by moving it downwards. */
-    memmove(m->ptr, m->next->ptr,
-	    &memory[MMEM_SIZE - avail_memory] - (char *)m->next->ptr);
-    
-    /* Update all the memory pointers that points to memory that is
-       after the allocation that is to be removed. */
-    for(n = m->next; n != NULL; n = n->next) {
-      n->ptr = (void *)((char *)n->ptr - m->size);
-    }
+  if((char *)m->ptr + rsize == &memory[top]) {
+    top -= rsize;
+  } else {
+    put_free(m->ptr, rsize);
   }
 
-  avail_memory += m->size;
+  avail_memory += rsize;
 
   /* Remove the memory block from the list. */
   list_remove(mmemlist, m);
 }
 /*---------------------------------------------------------------------------*/
+#if MMEM_STATS
+/**
+ * \brief      Get the usage and fragmentation of the managed memory
+ * \param s    A pointer to the statistics to fill in
+ *
+ */
+void
+mmem_stats(struct mmem_stats *s)
+{
+  struct free_block *f;
+  int c;
+
+  s->used = MMEM_SIZE - avail_memory;
+  s->peak = peak;
+  s->free = avail_memory;
+  s->fragmented = avail_memory - (MMEM_SIZE - top);
+  s->largest = MMEM_SIZE - top;
+  s->free_blocks = 0;
+  for(c = 0; c < MMEM_CLASSES; ++c) {
+    for(f = free_lists[c]; f != NULL; f = f->next) {
+      s->free_blocks++;
+      if(f->size > s->largest) {
+        s->largest = f->size;
+      }
+    }
+  }
+  s->compactions = compactions;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Restart the peak usage and compaction counts
+ *
+ */
+void
+mmem_stats_clear(void)
+{
+  peak = MMEM_SIZE - avail_memory;
+  compactions = 0;
+}
+#endif /* MMEM_STATS */
+/*---------------------------------------------------------------------------*/
 /**
  * \brief      Initialize the managed memory module
  * \author     Adam Dunkels
@@ -152,8 +317,18 @@ mmem_free(struct mmem *m)
 void
 mmem_init(void)
 {
+  int c;
+
   list_init(mmemlist);
   avail_memory = MMEM_SIZE;
+  top = 0;
+  for(c = 0; c < MMEM_CLASSES; ++c) {
+    free_lists[c] = NULL;
+  }
+#if MMEM_STATS
+  peak = 0;
+  compactions = 0;
+#endif /* MMEM_STATS */
 }
 /*---------------------------------------------------------------------------*/
 
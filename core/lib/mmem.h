@@ -39,8 +39,10 @@
  * \defgroup mmem Managed memory allocator
  *
  * The managed memory allocator is a fragmentation-free memory
- * manager. It keeps the allocated memory free from fragmentation by
- * compacting the memory when blocks are freed. A program that uses
+ * manager. Freed blocks are kept in lists by size class and reused
+ * for later allocations. When an allocation does not fit in a freed
+ * block or at the top of the memory, the memory is compacted by
+ * moving all allocated blocks downwards. A program that uses
  * the managed memory module cannot be sure that allocated memory
  * stays in place. Therefore, a level of indirection is used: access
  * to allocated memory must always be done using a special macro.
@@ -60,6 +62,19 @@
 #ifndef __MMEM_H__
 #define __MMEM_H__
 
+#include "contiki-conf.h"
+
+/**
+ * With MMEM_CONF_STATS set, the managed memory keeps track of its
+ * peak usage and of the number of compactions, and mmem_stats()
+ * reports how fragmented the free memory is.
+ */
+#ifdef MMEM_CONF_STATS
+#define MMEM_STATS MMEM_CONF_STATS
+#else
+#define MMEM_STATS 0
+#endif
+
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Get a pointer to the managed memory
@@ -88,6 +103,25 @@ int  mmem_alloc(struct mmem *m, unsigned int size);
 void mmem_free(struct mmem *);
 void mmem_init(void);
 
+#if MMEM_STATS
+struct mmem_stats {
+  /* Bytes allocated, and the most ever allocated. */
+  unsigned int used;
+  unsigned int peak;
+  /* Bytes free, and how many of them are not at the top of the
+     memory, in freed blocks or the unused ends of reused blocks. */
+  unsigned int free;
+  unsigned int fragmented;
+  /* The largest block that can be allocated without compacting. */
+  unsigned int largest;
+  unsigned int free_blocks;
+  unsigned int compactions;
+};
+
+void mmem_stats(struct mmem_stats *s);
+void mmem_stats_clear(void);
+#endif /* MMEM_STATS */
+
 #endif /* __MMEM_H__ */
 
 /** @} */
@@ -227,8 +227,13 @@ static struct compower_activity current_packet;
 #define MAX_PHASE_NEIGHBORS CONTIKIMAC_CONF_MAX_PHASE_NEIGHBORS
 #endif
 
+/* Phases are kept in the neighbor table, which bounds their number. */
 #ifndef MAX_PHASE_NEIGHBORS
-#define MAX_PHASE_NEIGHBORS 30
+#define MAX_PHASE_NEIGHBORS NEIGHBOR_ATTR_MAX_NEIGHBORS
+#endif
+
+#if MAX_PHASE_NEIGHBORS > NEIGHBOR_ATTR_MAX_NEIGHBORS
+#error "CONTIKIMAC_CONF_MAX_PHASE_NEIGHBORS exceeds the neighbor table, raise NEIGHBOR_CONF_MAX_NEIGHBORS"
 #endif
 
 PHASE_LIST(phase_list, MAX_PHASE_NEIGHBORS);
@@ -48,6 +48,7 @@
 #include "lib/random.h"
 
 #include "net/netstack.h"
+#include "net/neighbor-attr.h"
 
 #include "lib/list.h"
 #include "lib/memb.h"
@@ -84,10 +85,10 @@ struct qbuf_metadata {
   uint8_t max_transmissions;
 };
 
-/* Every neighbor has its own packet queue */
+/* Every neighbor has its own packet queue. The queues are found
+   through the neighbor table, which also holds their addresses. */
 struct neighbor_queue {
-  struct neighbor_queue *next;
-  rimeaddr_t addr;
+  const rimeaddr_t *addr;
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions, deferrals;
@@ -105,7 +106,7 @@ struct neighbor_queue {
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
-LIST(neighbor_list);
+NEIGHBOR_ATTRIBUTE(struct neighbor_queue *, neighbor_queues, NULL);
 
 static void packet_sent(void *ptr, int status, int num_transmissions);
 static void transmit_packet_list(void *ptr);
@@ -113,14 +114,51 @@ static void transmit_packet_list(void *ptr);
 /*---------------------------------------------------------------------------*/
 static struct
 neighbor_queue *neighbor_queue_from_addr(const rimeaddr_t *addr) {
-  struct neighbor_queue *n = list_head(neighbor_list);
-  while(n != NULL) {
-    if(rimeaddr_cmp(&n->addr, addr)) {
-      return n;
-    }
-    n = list_item_next(n);
+  struct neighbor_queue **np;
+
+  np = neighbor_attr_get_data(&neighbor_queues, addr);
+  return np == NULL ? NULL : *np;
+}
+/*---------------------------------------------------------------------------*/
+static struct neighbor_queue *
+neighbor_queue_alloc(const rimeaddr_t *addr)
+{
+  struct neighbor_queue *n;
+
+  n = memb_alloc(&neighbor_memb);
+  if(n == NULL) {
+    return NULL;
+  }
+  if(neighbor_attr_add_neighbor(addr) < 0) {
+    memb_free(&neighbor_memb, n);
+    return NULL;
   }
-  return NULL;
+  n->addr = neighbor_attr_get_addr(addr);
+  neighbor_attr_set_data(&neighbor_queues, n->addr, &n);
+  n->transmissions = 0;
+  n->collisions = 0;
+  n->deferrals = 0;
+  LIST_STRUCT_INIT(n, queued_packet_list);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_free(struct neighbor_queue *n)
+{
+  struct neighbor_queue **np;
+
+  np = neighbor_attr_get_data(&neighbor_queues, n->addr);
+  if(np != NULL) {
+    *np = NULL;
+  }
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
+/* The neighbor table keeps the address of a queue as long as it exists. */
+static int
+neighbor_queue_veto(void *data)
+{
+  return *(struct neighbor_queue **)data != NULL;
 }
 /*---------------------------------------------------------------------------*/
 static clock_time_t
@@ -177,8 +215,7 @@ free_first_packet(struct neighbor_queue *n)
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_free(n);
     }
   }
 }
@@ -290,18 +327,7 @@ send_packet(mac_callback_t sent, void *ptr)
     n = neighbor_queue_from_addr(addr);
     if(n == NULL) {
       /* Allocate a new neighbor entry */
-      n = memb_alloc(&neighbor_memb);
-      if(n != NULL) {
-        /* Init neighbor entry */
-        rimeaddr_copy(&n->addr, addr);
-        n->transmissions = 0;
-        n->collisions = 0;
-        n->deferrals = 0;
-        /* Init packet list for this neighbor */
-        LIST_STRUCT_INIT(n, queued_packet_list);
-        /* Add neighbor to the list */
-        list_add(neighbor_list, n);
-      }
+      n = neighbor_queue_alloc(addr);
     }
 
     if(n != NULL) {
@@ -345,8 +371,7 @@ send_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        neighbor_queue_free(n);
       }
       PRINTF("csma: could not allocate packet, dropping packet\n");
     } else {
@@ -359,6 +384,57 @@ send_packet(mac_callback_t sent, void *ptr)
   }
 }
 /*---------------------------------------------------------------------------*/
+int
+csma_reroute(const rimeaddr_t *from, const rimeaddr_t *to)
+{
+  struct neighbor_queue *n, *m;
+  struct rdc_buf_list *q, *next, *head;
+  int was_empty;
+  int moved;
+
+  n = neighbor_queue_from_addr(from);
+  if(n == NULL || rimeaddr_cmp(from, to)) {
+    return 0;
+  }
+
+  m = neighbor_queue_from_addr(to);
+  if(m == NULL) {
+    m = neighbor_queue_alloc(to);
+    if(m == NULL) {
+      PRINTF("csma: could not allocate neighbor, not rerouting\n");
+      return 0;
+    }
+  }
+  was_empty = list_head(m->queued_packet_list) == NULL;
+
+  /* The packet at the head of the queue may be with the RDC layer,
+     which may have deferred it (MAC_TX_DEFERRED) and still hold on to
+     the packet and to n. It stays, and n with it, until its callback
+     arrives; only the packets behind it move. */
+  moved = 0;
+  head = list_head(n->queued_packet_list);
+  for(q = head == NULL ? NULL : list_item_next(head); q != NULL; q = next) {
+    next = list_item_next(q);
+    /* The network layer tags the packets that may go to another
+       neighbor, e.g., those whose destination is not derived from the
+       link-layer address they were queued for. */
+    if(queuebuf_attr(q->buf, PACKETBUF_ATTR_REROUTABLE)) {
+      list_remove(n->queued_packet_list, q);
+      queuebuf_set_addr(q->buf, PACKETBUF_ADDR_RECEIVER, to);
+      list_add(m->queued_packet_list, q);
+      moved++;
+    }
+  }
+  PRINTF("csma: rerouted %d packets\n", moved);
+
+  if(list_head(m->queued_packet_list) == NULL) {
+    neighbor_queue_free(m);
+  } else if(was_empty) {
+    ctimer_set(&m->transmit_timer, 0, transmit_packet_list, m);
+  }
+  return moved;
+}
+/*---------------------------------------------------------------------------*/
 static void
 input_packet(void)
 {
@@ -392,6 +468,8 @@ init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+  neighbor_attr_register(&neighbor_queues);
+  neighbor_attr_set_evict_veto(&neighbor_queues, neighbor_queue_veto);
 }
 /*---------------------------------------------------------------------------*/
 const struct mac_driver csma_driver = {
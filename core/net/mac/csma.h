@@ -44,9 +44,20 @@
 
 #include "net/mac/mac.h"
 #include "dev/radio.h"
+#include "net/rime/rimeaddr.h"
 
 extern const struct mac_driver csma_driver;
 
 const struct mac_driver *csma_init(const struct mac_driver *r);
 
+/**
+ * Move the packets queued for one neighbor to another one, e.g.,
+ * after the routing layer has replaced a failed next hop. Packets
+ * addressed to the old neighbor itself stay in its queue, and so does
+ * the packet at its head, which may be in transmission.
+ *
+ * \return The number of packets moved.
+ */
+int csma_reroute(const rimeaddr_t *from, const rimeaddr_t *to);
+
 #endif /* __CSMA_H__ */
@@ -77,10 +77,9 @@ struct phase *
 find_neighbor(const struct phase_list *list, const rimeaddr_t *addr)
 {
   struct phase *e;
-  for(e = list_head(*list->list); e != NULL; e = list_item_next(e)) {
-    if(rimeaddr_cmp(addr, &e->neighbor)) {
-      return e;
-    }
+  e = neighbor_attr_get_data(list->attr, addr);
+  if(e != NULL && e->valid) {
+    return e;
   }
   return NULL;
 }
@@ -91,8 +90,7 @@ phase_remove(const struct phase_list *list, const rimeaddr_t *neighbor)
   struct phase *e;
   e = find_neighbor(list, neighbor);
   if(e != NULL) {
-    list_remove(*list->list, e);
-    memb_free(list->memb, e);
+    e->valid = 0;
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -111,6 +109,7 @@ phase_update(const struct phase_list *list,
       e->drift = time-e->time;
 #endif
       e->time = time;
+      neighbor_attr_tick(neighbor);
     }
     /* If the neighbor didn't reply to us, it may have switched
        phase (rebooted). We try a number of transmissions to it
@@ -123,30 +122,28 @@ phase_update(const struct phase_list *list,
       }
       if(e->noacks >= MAX_NOACKS || timer_expired(&e->noacks_timer)) {
         PRINTF("drop %d\n", neighbor->u8[0]);
-        list_remove(*list->list, e);
-        memb_free(list->memb, e);
+        e->valid = 0;
         return;
       }
     } else if(mac_status == MAC_TX_OK) {
       e->noacks = 0;
     }
   } else {
-    /* No matching phase was found, so we allocate a new one. */
-    if(mac_status == MAC_TX_OK && e == NULL) {
-      e = memb_alloc(list->memb);
-      if(e == NULL) {
-        PRINTF("phase alloc NULL\n");
-        /* We could not allocate memory for this phase, so we drop
-           the last item on the list and reuse it for our phase. */
-        e = list_chop(*list->list);
-      }
-      rimeaddr_copy(&e->neighbor, neighbor);
-      e->time = time;
+    /* No matching phase was found, so we record a new one. If the
+       neighbor table is full, the least recently active neighbor is
+       evicted to make room. */
+    if(mac_status == MAC_TX_OK) {
+      struct phase p;
+
+      p.time = time;
 #if PHASE_DRIFT_CORRECT
-      e->drift = 0;
+      p.drift = 0;
 #endif
-      e->noacks = 0;
-      list_push(*list->list, e);
+      p.noacks = 0;
+      p.valid = 1;
+      if(!neighbor_attr_set_data(list->attr, neighbor, &p)) {
+        PRINTF("phase alloc NULL\n");
+      }
     }
   }
 }
@@ -261,8 +258,7 @@ phase_wait(struct phase_list *list,
 void
 phase_init(struct phase_list *list)
 {
-  list_init(*list->list);
-  memb_init(list->memb);
+  neighbor_attr_register(list->attr);
   memb_init(&queued_packets_memb);
 }
 /*---------------------------------------------------------------------------*/
@@ -46,6 +46,7 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 #include "net/netstack.h"
+#include "net/neighbor-attr.h"
 
 #if PHASE_CONF_DRIFT_CORRECT
 #define PHASE_DRIFT_CORRECT PHASE_CONF_DRIFT_CORRECT
@@ -53,20 +54,19 @@
 #define PHASE_DRIFT_CORRECT 0
 #endif
 
+/* Phases are stored as an attribute of the shared neighbor table. */
 struct phase {
-  struct phase *next;
-  rimeaddr_t neighbor;
   rtimer_clock_t time;
 #if PHASE_DRIFT_CORRECT
   rtimer_clock_t drift;
 #endif
   uint8_t noacks;
+  uint8_t valid;
   struct timer noacks_timer;
 };
 
 struct phase_list {
-  list_t *list;
-  struct memb *memb;
+  struct neighbor_attr *attr;
 };
 
 typedef enum {
@@ -76,9 +76,12 @@ typedef enum {
 } phase_status_t;
 
 
-#define PHASE_LIST(name, num) LIST(phase_list_list);                              \
-                              MEMB(phase_list_memb, struct phase, num);           \
-                              struct phase_list name = { &phase_list_list, &phase_list_memb }
+/* The phases live in the neighbor table, so there is room for one per
+   neighbor in it (NEIGHBOR_CONF_MAX_NEIGHBORS, 30 by default as the
+   phase list used to have). num must not exceed that; raise
+   NEIGHBOR_CONF_MAX_NEIGHBORS to keep more. */
+#define PHASE_LIST(name, num) NEIGHBOR_ATTRIBUTE(struct phase, phase_list_attr, NULL) \
+                              struct phase_list name = { &phase_list_attr }
 
 void phase_init(struct phase_list *list);
 phase_status_t phase_wait(struct phase_list *list,  const rimeaddr_t *neighbor,
@@ -52,8 +52,15 @@ static uint16_t timeout = 0;
 
 MEMB(neighbor_addr_mem, struct neighbor_addr, NEIGHBOR_ATTR_MAX_NEIGHBORS);
 
+/* The neighbor list is kept in order of activity, most recently
+   active neighbor first, so that the last entry is the one evicted
+   when the table is full. */
 LIST(neighbor_addrs);
 LIST(neighbor_attrs);
+
+/* Several layers look up the same neighbor while handling one packet;
+   the most recent lookup is remembered to avoid rescanning the list. */
+static struct neighbor_addr *last_lookup;
 /*---------------------------------------------------------------------------*/
 static struct neighbor_addr *
 neighbor_addr_get(const rimeaddr_t *addr)
@@ -66,9 +73,14 @@ neighbor_addr_get(const rimeaddr_t *addr)
         (((char *)addr) - offsetof(struct neighbor_addr, addr));
   }
 
+  if(last_lookup != NULL && rimeaddr_cmp(addr, &last_lookup->addr)) {
+    return last_lookup;
+  }
+
   item = list_head(neighbor_addrs);
   while(item != NULL) {
     if(rimeaddr_cmp(addr, &item->addr)) {
+      last_lookup = item;
       return item;
     }
     item = item->next;
@@ -76,6 +88,26 @@ neighbor_addr_get(const rimeaddr_t *addr)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static void
+neighbor_addr_remove(struct neighbor_addr *item)
+{
+  if(item == last_lookup) {
+    last_lookup = NULL;
+  }
+  list_remove(neighbor_addrs, item);
+  memb_free(&neighbor_addr_mem, item);
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_addr_touch(struct neighbor_addr *item)
+{
+  item->time = 0;
+  if(list_head(neighbor_addrs) != item) {
+    list_remove(neighbor_addrs, item);
+    list_push(neighbor_addrs, item);
+  }
+}
+/*---------------------------------------------------------------------------*/
 struct neighbor_addr *
 neighbor_attr_list_neighbors(void)
 {
@@ -114,6 +146,64 @@ neighbor_attr_has_neighbor(const rimeaddr_t *addr)
   return neighbor_addr_get(addr) != NULL;
 }
 /*---------------------------------------------------------------------------*/
+const rimeaddr_t *
+neighbor_attr_get_addr(const rimeaddr_t *addr)
+{
+  struct neighbor_addr *item = neighbor_addr_get(addr);
+
+  if(item != NULL) {
+    return &item->addr;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+neighbor_attr_set_evict_veto(struct neighbor_attr *def,
+                             neighbor_attr_veto_t veto)
+{
+  def->veto = veto;
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_vetoed(struct neighbor_addr *item)
+{
+  struct neighbor_attr *def;
+
+  for(def = list_head(neighbor_attrs); def != NULL; def = def->next) {
+    if(def->veto != NULL &&
+       def->veto((char *)def->data + item->index * def->size)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static struct neighbor_addr *
+evict_neighbor(void)
+{
+  struct neighbor_addr *item;
+  struct neighbor_addr *victim;
+
+  /* The least recently active neighbor that nobody vetoes. */
+  victim = NULL;
+  for(item = list_head(neighbor_addrs); item != NULL; item = item->next) {
+    if(!is_vetoed(item)) {
+      victim = item;
+    }
+  }
+  if(victim == NULL) {
+    return NULL;
+  }
+
+  PRINTF("neighbor-attr: evicting neighbor %d.%d\n",
+         victim->addr.u8[0], victim->addr.u8[1]);
+  if(victim == last_lookup) {
+    last_lookup = NULL;
+  }
+  list_remove(neighbor_addrs, victim);
+  return victim;
+}
+/*---------------------------------------------------------------------------*/
 int
 neighbor_attr_add_neighbor(const rimeaddr_t *addr)
 {
@@ -128,7 +218,12 @@ neighbor_attr_add_neighbor(const rimeaddr_t *addr)
 
   item = memb_alloc(&neighbor_addr_mem);
   if(item == NULL) {
-    return -1;
+    /* The table is full: evict the least recently active neighbor,
+       together with the attributes of every layer. */
+    item = evict_neighbor();
+    if(item == NULL) {
+      return -1;
+    }
   }
 
   list_push(neighbor_addrs, item);
@@ -158,9 +253,8 @@ neighbor_attr_remove_neighbor(const rimeaddr_t *addr)
 {
   struct neighbor_addr *item = neighbor_addr_get(addr);
 
-  if(item != NULL) {
-    list_remove(neighbor_addrs, item);
-    memb_free(&neighbor_addr_mem, item);
+  if(item != NULL && !is_vetoed(item)) {
+    neighbor_addr_remove(item);
     return 0;
   }
   return -1;
@@ -189,7 +283,7 @@ neighbor_attr_set_data(struct neighbor_attr *def, const rimeaddr_t *addr,
     }
   }
   if(attr != NULL) {
-    attr->time = 0;
+    neighbor_addr_touch(attr);
     memcpy((char *)def->data + attr->index * def->size, data, def->size);
     return 1;
   }
@@ -202,7 +296,7 @@ neighbor_attr_tick(const rimeaddr_t * addr)
   struct neighbor_addr *attr = neighbor_addr_get(addr);
 
   if(attr != NULL) {
-    attr->time = 0;
+    neighbor_addr_touch(attr);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -223,11 +317,10 @@ timeout_check(void *ptr)
 
     while(item != NULL) {
       item->time += TIMEOUT_SECONDS;
-      if(item->time >= timeout) {
+      if(item->time >= timeout && !is_vetoed(item)) {
         struct neighbor_addr *next_item = item->next;
 
-        list_remove(neighbor_addrs, item);
-        memb_free(&neighbor_addr_mem, item);
+        neighbor_addr_remove(item);
         item = next_item;
       } else {
         item = item->next;
@@ -37,11 +37,19 @@
 
 /**
  * define how many neighbors you can store
+ *
+ * The table holds the link statistics, the ContikiMAC phases, the csma
+ * queues, and on IPv6 stacks the link addresses of the ND neighbor
+ * cache and the RPL parents. Its default of 30 is the capacity the
+ * ContikiMAC phase list used to have; an IPv6 neighbor cache that is
+ * configured larger (UIP_CONF_DS6_NBR_NBU) raises it.
  */
 #ifdef NEIGHBOR_CONF_MAX_NEIGHBORS
 #define NEIGHBOR_ATTR_MAX_NEIGHBORS NEIGHBOR_CONF_MAX_NEIGHBORS
+#elif UIP_CONF_IPV6 && UIP_CONF_DS6_NBR_NBU > 30
+#define NEIGHBOR_ATTR_MAX_NEIGHBORS UIP_CONF_DS6_NBR_NBU
 #else                           /* NEIGHBOR_CONF_MAX_NEIGHBORS */
-#define NEIGHBOR_ATTR_MAX_NEIGHBORS 12
+#define NEIGHBOR_ATTR_MAX_NEIGHBORS 30
 #endif                          /* NEIGHBOR_CONF_MAX_NEIGHBORS */
 
 /**
@@ -54,6 +62,13 @@ struct neighbor_addr {
   uint16_t index;
 };
 
+/**
+ * \brief      Decides whether a neighbor may be evicted
+ * \param data The attribute of the neighbor
+ * \retval     non-zero to keep the neighbor, zero to allow the eviction
+ */
+typedef int (*neighbor_attr_veto_t)(void *data);
+
 /**
  * \brief      properties that define a neighbor attribute
  */
@@ -62,6 +77,7 @@ struct neighbor_attr {
   uint16_t size;
   void *default_value;
   void *data;
+  neighbor_attr_veto_t veto;
 };
 
 /**
@@ -77,16 +93,16 @@ struct neighbor_attr {
 #define NEIGHBOR_ATTRIBUTE(type, name, default_value_ptr) \
   static type _##name##_mem[NEIGHBOR_ATTR_MAX_NEIGHBORS]; \
   static struct neighbor_attr name = \
-    {NULL, sizeof(type), default_value_ptr, (void*)_##name##_mem} ; \
+    {NULL, sizeof(type), default_value_ptr, (void*)_##name##_mem, NULL} ; \
 
 /** Same as NEIGHBOR_ATTRIBUTE, only the attr is not declared static
  * this way you can say <tt>extern struct neighbor_attr name</tt> in header to declare
  * a global neighbor attribute
  */
 #define NEIGHBOR_ATTRIBUTE_NONSTATIC(type, name, default_value_ptr) \
-	  static type _##name##_mem[MAX_NEIGHBORS]; \
+	  static type _##name##_mem[NEIGHBOR_ATTR_MAX_NEIGHBORS]; \
 	  struct neighbor_attr name = \
-	    {NULL, sizeof(type), default_value_ptr, (void*)_##name##_mem} ; \
+	    {NULL, sizeof(type), default_value_ptr, (void*)_##name##_mem, NULL} ; \
 
 /**
  * \brief      register a neighbor attribute
@@ -109,12 +125,40 @@ int neighbor_attr_has_neighbor(const rimeaddr_t * addr);
  * \brief      Add a neighbor entry to neighbor table
  * \retval     -1 if unsuccessful, 0 if the neighbor was already
  *             in the table, and 1 if successful
+ *
+ *             If the table is full, the least recently active neighbor
+ *             that is not vetoed is evicted along with all of its
+ *             attributes. If all of them are vetoed, the add fails.
  */
 int neighbor_attr_add_neighbor(const rimeaddr_t * addr);
 
+/**
+ * \brief      Set the function that vetoes evictions for an attribute
+ *
+ *             A layer whose attribute refers to state it still uses,
+ *             such as a queue or a parent, sets it so that the table
+ *             neither evicts nor times out the neighbor meanwhile. A
+ *             neighbor is kept if the veto of any of its attributes
+ *             says so.
+ */
+void neighbor_attr_set_evict_veto(struct neighbor_attr *,
+                                  neighbor_attr_veto_t veto);
+
+/**
+ * \brief      Get the address of a neighbor as stored in the table
+ * \retval     pointer to the address, NULL if neighbor was not found
+ *
+ *             The pointer stays valid as long as the neighbor is in the
+ *             table, which a veto guarantees. Looking a neighbor up by
+ *             this pointer does not scan the table.
+ */
+const rimeaddr_t *neighbor_attr_get_addr(const rimeaddr_t * addr);
+
 /**
  * \brief      Remove a neighbor entry to neighbor table
  * \retval     -1 if unsuccessful, 0 if the neighbor was removed
+ *
+ *             A neighbor that an attribute vetoes is not removed.
  */
 int neighbor_attr_remove_neighbor(const rimeaddr_t * addr);
 
@@ -49,12 +49,25 @@
 #define ETX_SCALE		100
 #define ETX_ALPHA		90
 #define ETX_NOACK_PENALTY       ETX_LIMIT
+
+/* The number of consecutive unacknowledged packets after which a
+   neighbor is reported as lost to the subscriber. Zero disables the
+   check, leaving the ETX as the only indication of a broken link. */
+#ifdef NEIGHBOR_INFO_CONF_NOACK_LIMIT
+#define NOACK_LIMIT NEIGHBOR_INFO_CONF_NOACK_LIMIT
+#else
+#define NOACK_LIMIT 0
+#endif /* NEIGHBOR_INFO_CONF_NOACK_LIMIT */
 /*---------------------------------------------------------------------------*/
 NEIGHBOR_ATTRIBUTE(link_metric_t, etx, NULL);
+#if NOACK_LIMIT
+NEIGHBOR_ATTRIBUTE(uint8_t, noacks, NULL);
+#endif /* NOACK_LIMIT */
 
 static neighbor_info_subscriber_t subscriber_callback;
 /*---------------------------------------------------------------------------*/
-static void
+/* Returns non-zero when the recorded metric of the neighbor changed. */
+static int
 update_metric(const rimeaddr_t *dest, int packet_metric)
 {
   link_metric_t *metricp;
@@ -80,11 +93,35 @@ update_metric(const rimeaddr_t *dest, int packet_metric)
 
   if(neighbor_attr_has_neighbor(dest)) {
     neighbor_attr_set_data(&etx, dest, &new_metric);
-    if(new_metric != recorded_metric && subscriber_callback != NULL) {
-      subscriber_callback(dest, 1, new_metric);
-    }
+    return new_metric != recorded_metric;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+#if NOACK_LIMIT
+/* Returns non-zero when the neighbor has now missed NOACK_LIMIT
+   acknowledgements in a row. */
+static int
+count_noack(const rimeaddr_t *dest, int acked)
+{
+  uint8_t *countp;
+  uint8_t count;
+
+  countp = (uint8_t *)neighbor_attr_get_data(&noacks, dest);
+  count = countp == NULL ? 0 : *countp;
+  if(acked) {
+    count = 0;
+  } else if(++count >= NOACK_LIMIT) {
+    PRINTF("neighbor-info: %d consecutive noacks from %d\n",
+           count, dest->u8[7]);
+    count = 0;
+    neighbor_attr_set_data(&noacks, dest, &count);
+    return 1;
   }
+  neighbor_attr_set_data(&noacks, dest, &count);
+  return 0;
 }
+#endif /* NOACK_LIMIT */
 /*---------------------------------------------------------------------------*/
 static void
 add_neighbor(const rimeaddr_t *addr)
@@ -124,6 +161,9 @@ neighbor_info_packet_sent(int status, int numtx)
   switch(status) {
   case MAC_TX_OK:
     add_neighbor(dest);
+#if NOACK_LIMIT
+    count_noack(dest, 1);
+#endif /* NOACK_LIMIT */
 #if UIP_DS6_LL_NUD
     nbr = uip_ds6_nbr_ll_lookup((uip_lladdr_t *)dest);
     if(nbr != NULL &&
@@ -138,6 +178,17 @@ neighbor_info_packet_sent(int status, int numtx)
     break;
   case MAC_TX_NOACK:
     packet_metric = ETX_NOACK_PENALTY;
+#if NOACK_LIMIT
+    if(count_noack(dest, 0)) {
+      /* The subscriber hears of the lost neighbor only, not of the
+         ETX change that comes with it. */
+      update_metric(dest, packet_metric);
+      if(subscriber_callback != NULL) {
+        subscriber_callback(dest, 0, neighbor_info_get_metric(dest));
+      }
+      return;
+    }
+#endif /* NOACK_LIMIT */
     break;
   default:
     /* Do not penalize the ETX when collisions or transmission
@@ -145,7 +196,9 @@ neighbor_info_packet_sent(int status, int numtx)
     return;
   }
 
-  update_metric(dest, packet_metric);
+  if(update_metric(dest, packet_metric) && subscriber_callback != NULL) {
+    subscriber_callback(dest, 1, neighbor_info_get_metric(dest));
+  }
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -169,6 +222,9 @@ neighbor_info_subscribe(neighbor_info_subscriber_t s)
 {
   if(subscriber_callback == NULL) {
     neighbor_attr_register(&etx);
+#if NOACK_LIMIT
+    neighbor_attr_register(&noacks);
+#endif /* NOACK_LIMIT */
     subscriber_callback = s;
     return 1;
   }
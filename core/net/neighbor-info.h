@@ -76,6 +76,9 @@ void neighbor_info_packet_received(void);
 /**
  * Subscribe to notifications of changed neighbor information.
  *
+ * The subscriber is called with known set to 0 when a neighbor has
+ * failed to acknowledge NEIGHBOR_INFO_CONF_NOACK_LIMIT packets in a row.
+ *
  * \return Returns 1 if the subscription was successful, and 0 if not.
  */
 int neighbor_info_subscribe(neighbor_info_subscriber_t);
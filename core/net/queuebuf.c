@@ -65,6 +65,9 @@ struct queuebuf {
   int line;
   clock_time_t time;
 #endif /* QUEUEBUF_DEBUG */
+#if QUEUEBUF_PACKED
+  struct qbuf_block *block;
+#else /* QUEUEBUF_PACKED */
 #if WITH_SWAP
   enum {IN_RAM, IN_CFS} location;
   union {
@@ -74,6 +77,7 @@ struct queuebuf {
     int swap_id;
   };
 #endif
+#endif /* QUEUEBUF_PACKED */
 };
 
 /* The actual queuebuf data */
@@ -93,7 +97,9 @@ struct queuebuf_ref {
 
 MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
 MEMB(refbufmem, struct queuebuf_ref, QUEUEBUF_REF_NUM);
+#if !QUEUEBUF_PACKED
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
+#endif /* !QUEUEBUF_PACKED */
 
 #if WITH_SWAP
 
@@ -112,10 +118,33 @@ struct qbuf_file {
   int renewable;
 };
 
-/* A statically allocated queuebuf used as a cache for swapped qbufs */
-static struct queuebuf_data tmpdata;
-/* A pointer to the qbuf associated to the data in tmpdata */
-static struct queuebuf *tmpdata_qbuf = NULL;
+/* Swapped qbufs are appended to the swap files in batches, so that
+   a burst of packets costs one CFS write per batch. */
+#ifdef QUEUEBUF_CONF_SWAP_BATCH
+#define QUEUEBUF_SWAP_BATCH QUEUEBUF_CONF_SWAP_BATCH
+#else
+#define QUEUEBUF_SWAP_BATCH 4
+#endif
+
+/* Swapped qbufs are read back into a cache together with the qbufs
+   that were swapped directly after them, since qbufs are usually
+   dequeued in the order in which they were queued. */
+#ifdef QUEUEBUF_CONF_SWAP_CACHE
+#define QUEUEBUF_SWAP_CACHE QUEUEBUF_CONF_SWAP_CACHE
+#else
+#define QUEUEBUF_SWAP_CACHE 2
+#endif
+
+/* The qbufs that have been swapped but not yet written to CFS. They
+   have consecutive swap ids in the same file, starting at
+   swap_batch_first. */
+static struct queuebuf_data swap_batch[QUEUEBUF_SWAP_BATCH];
+static int swap_batch_first;
+static int swap_batch_len;
+/* Swapped qbufs that have been read from CFS, and their swap ids. */
+static struct queuebuf_data swap_cache[QUEUEBUF_SWAP_CACHE];
+static int swap_cache_id[QUEUEBUF_SWAP_CACHE];
+static int swap_cache_next;
 /* The swap id counter */
 static int next_swap_id = 0;
 /* The swap files */
@@ -123,6 +152,40 @@ static struct qbuf_file qbuf_files[NQBUF_FILES];
 /* The timer used to renew files during inactivity periods */
 static struct ctimer renew_timer;
 
+#elif QUEUEBUF_PACKED
+
+/* Packed qbufs are stored in an arena as large as QUEUEBUFRAM_NUM
+   unpacked ones. A block holds the packet data, followed by the
+   attributes and then the addresses that are set, each as a type
+   byte and a value. Freed blocks are reclaimed by sliding the live
+   blocks down when an allocation does not fit at the end. */
+struct qbuf_block {
+  /* Index of the qbuf in bufmem, or QBUF_FREE */
+  uint16_t owner;
+  uint16_t size;
+  uint16_t len;
+  uint8_t nattrs;
+  uint8_t naddrs;
+};
+
+#define QBUF_ARENA_BLOCKS ((QUEUEBUFRAM_NUM * sizeof(struct queuebuf_data) + \
+                            sizeof(struct qbuf_block) - 1) /      \
+                           sizeof(struct qbuf_block))
+#define QBUF_ARENA_SIZE (QBUF_ARENA_BLOCKS * sizeof(struct qbuf_block))
+#define QBUF_ALIGN(size) (((size) + 1) & ~1)
+#define QBUF_FREE 0xffff
+#define QBUF_OWNER(blk) ((struct queuebuf *)bufmem.mem + (blk)->owner)
+#define QBUF_ATTR_SIZE (1 + sizeof(packetbuf_attr_t))
+#define QBUF_ADDR_SIZE (1 + sizeof(rimeaddr_t))
+
+static struct qbuf_block arena[QBUF_ARENA_BLOCKS];
+#define ARENA ((uint8_t *)arena)
+/* The end of the last block, and the bytes freed below it */
+static uint16_t arena_end;
+static uint16_t arena_freed;
+/* Returned for the addresses that are not stored */
+static rimeaddr_t null_addr;
+
 #endif
 
 #if QUEUEBUF_DEBUG
@@ -182,6 +245,18 @@ qbuf_renew_all(void *unused)
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Drops a swap id from the read cache */
+static void
+swap_cache_remove(int swap_id)
+{
+  int i;
+  for(i = 0; i < QUEUEBUF_SWAP_CACHE; i++) {
+    if(swap_cache_id[i] == swap_id) {
+      swap_cache_id[i] = -1;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* Removes a queuebuf from its swap file */
 static void
 queuebuf_remove_from_file(int swap_id)
@@ -196,11 +271,13 @@ queuebuf_remove_from_file(int swap_id)
       qbuf_files[fileid].renewable = 1;
       /* This file is renewable, set a timer to renew files */
       ctimer_set(&renew_timer, 0, qbuf_renew_all, NULL);
+      /* Nothing in the batch is needed anymore */
+      if(swap_batch_len > 0 && swap_batch_first / NQBUF_PER_FILE == fileid) {
+        swap_batch_len = 0;
+      }
     }
 
-    if(tmpdata_qbuf->swap_id == swap_id) {
-      tmpdata_qbuf->swap_id = -1;
-    }
+    swap_cache_remove(swap_id);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -223,63 +300,333 @@ get_new_swap_id(void)
   return swap_id;
 }
 /*---------------------------------------------------------------------------*/
-/* Flush tmpdata to CFS */
+/* Write the batch of swapped qbufs to CFS */
 static int
-queuebuf_flush_tmpdata(void)
+swap_batch_flush(void)
 {
   int fileid, fd, ret;
   cfs_offset_t offset;
-  if(tmpdata_qbuf) {
-    queuebuf_remove_from_file(tmpdata_qbuf->swap_id);
-    tmpdata_qbuf->swap_id = get_new_swap_id();
-    if(tmpdata_qbuf->swap_id == -1) {
-      return -1;
-    }
-    fileid = tmpdata_qbuf->swap_id / NQBUF_PER_FILE;
-    offset = (tmpdata_qbuf->swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
+  if(swap_batch_len > 0) {
+    fileid = swap_batch_first / NQBUF_PER_FILE;
+    offset = (swap_batch_first % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
     fd = qbuf_files[fileid].fd;
     ret = cfs_seek(fd, offset, CFS_SEEK_SET);
     if(ret == -1) {
-      PRINTF("queuebuf_flush_tmpdata: cfs seek error\n");
+      PRINTF("swap_batch_flush: cfs seek error\n");
       return -1;
     }
-    ret = cfs_write(fd, &tmpdata, sizeof(struct queuebuf_data));
+    ret = cfs_write(fd, swap_batch, swap_batch_len * sizeof(struct queuebuf_data));
     if(ret == -1) {
-      PRINTF("queuebuf_flush_tmpdata: cfs write error\n");
+      PRINTF("swap_batch_flush: cfs write error\n");
       return -1;
     }
+    swap_batch_len = 0;
   }
   return 0;
 }
 /*---------------------------------------------------------------------------*/
-/* If the queuebuf is in CFS, load it to tmpdata */
+/* Give a qbuf a new swap id, and return its place in the batch */
 static struct queuebuf_data *
-queuebuf_load_to_ram(struct queuebuf *b)
+swap_append(struct queuebuf *b)
+{
+  int swap_id;
+  /* A batch is full when it reaches the end of its file */
+  if(swap_batch_len == QUEUEBUF_SWAP_BATCH ||
+     (swap_batch_len > 0 && next_swap_id % NQBUF_PER_FILE == 0)) {
+    if(swap_batch_flush() == -1) {
+      return NULL;
+    }
+  }
+  swap_id = get_new_swap_id();
+  if(swap_id == -1) {
+    return NULL;
+  }
+  /* The id may have been read ahead before it was last freed */
+  swap_cache_remove(swap_id);
+  if(swap_batch_len == 0) {
+    swap_batch_first = swap_id;
+  }
+  b->swap_id = swap_id;
+  return &swap_batch[swap_batch_len++];
+}
+/*---------------------------------------------------------------------------*/
+/* Store a modified swapped qbuf again */
+static int
+swap_rewrite(struct queuebuf *b, struct queuebuf_data *data)
+{
+  struct queuebuf_data *slot;
+  int old_id;
+  if(data >= swap_batch && data < &swap_batch[QUEUEBUF_SWAP_BATCH]) {
+    /* Not written yet, so it was modified in place */
+    return 0;
+  }
+  old_id = b->swap_id;
+  slot = swap_append(b);
+  if(slot == NULL) {
+    b->swap_id = old_id;
+    return -1;
+  }
+  memcpy(slot, data, sizeof(struct queuebuf_data));
+  queuebuf_remove_from_file(old_id);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Read a swapped qbuf and the ones that follow it into the cache */
+static struct queuebuf_data *
+swap_load(int swap_id)
 {
   int fileid, fd, ret;
+  int i, count, end;
   cfs_offset_t offset;
+
+  for(i = 0; i < QUEUEBUF_SWAP_CACHE; i++) {
+    if(swap_cache_id[i] == swap_id) {
+      return &swap_cache[i];
+    }
+  }
+
+  /* Read ahead up to the end of the file or the first id that has
+     not been written to it */
+  end = swap_batch_len > 0 ? swap_batch_first : next_swap_id;
+  for(count = 1; count < QUEUEBUF_SWAP_CACHE; count++) {
+    i = swap_id + count;
+    if(i % NQBUF_PER_FILE == 0 || i == end) {
+      break;
+    }
+  }
+
+  if(swap_cache_next + count > QUEUEBUF_SWAP_CACHE) {
+    swap_cache_next = 0;
+  }
+  i = swap_cache_next;
+  swap_cache_next = (swap_cache_next + count) % QUEUEBUF_SWAP_CACHE;
+
+  fileid = swap_id / NQBUF_PER_FILE;
+  offset = (swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
+  fd = qbuf_files[fileid].fd;
+  ret = cfs_seek(fd, offset, CFS_SEEK_SET);
+  if(ret == -1) {
+    PRINTF("swap_load: cfs seek error\n");
+  }
+  ret = cfs_read(fd, &swap_cache[i], count * sizeof(struct queuebuf_data));
+  if(ret == -1) {
+    PRINTF("swap_load: cfs read error\n");
+  }
+
+  for(end = 0; end < count; end++) {
+    /* Older copies of the ids that were read ahead are stale */
+    swap_cache_remove(swap_id + end);
+    swap_cache_id[i + end] = swap_id + end;
+  }
+  return &swap_cache[i];
+}
+/*---------------------------------------------------------------------------*/
+/* If the queuebuf is in CFS, load it to RAM */
+static struct queuebuf_data *
+queuebuf_load_to_ram(struct queuebuf *b)
+{
   if(b->location == IN_RAM) { /* the qbuf is loacted in RAM */
     return b->ram_ptr;
-  } else { /* the qbuf is located in CFS */
-    if(tmpdata_qbuf && tmpdata_qbuf->swap_id == b->swap_id) { /* the qbuf is already in tmpdata */
-      return &tmpdata;
-    } else { /* the qbuf needs to be loaded from CFS */
-      tmpdata_qbuf = b;
-      /* read the qbuf from CFS */
-      fileid = b->swap_id / NQBUF_PER_FILE;
-      offset = (b->swap_id % NQBUF_PER_FILE) * sizeof(struct queuebuf_data);
-      fd = qbuf_files[fileid].fd;
-      ret = cfs_seek(fd, offset, CFS_SEEK_SET);
-      if(ret == -1) {
-        PRINTF("queuebuf_load_to_ram: cfs seek error\n");
+  } else if(swap_batch_len > 0 && b->swap_id >= swap_batch_first &&
+            b->swap_id < swap_batch_first + swap_batch_len) {
+    /* the qbuf has not been written to CFS yet */
+    return &swap_batch[b->swap_id - swap_batch_first];
+  } else { /* the qbuf needs to be loaded from CFS */
+    return swap_load(b->swap_id);
+  }
+}
+#elif QUEUEBUF_PACKED
+/*---------------------------------------------------------------------------*/
+/* Slide the live blocks down over the freed ones */
+static void
+arena_compact(void)
+{
+  struct qbuf_block *blk;
+  uint16_t from, to, size;
+
+  for(from = to = 0; from < arena_end; from += size) {
+    blk = (struct qbuf_block *)&ARENA[from];
+    size = blk->size;
+    if(blk->owner != QBUF_FREE) {
+      if(to != from) {
+        memmove(&ARENA[to], blk, size);
+        blk = (struct qbuf_block *)&ARENA[to];
+        QBUF_OWNER(blk)->block = blk;
       }
-      ret = cfs_read(fd, &tmpdata, sizeof(struct queuebuf_data));
-      if(ret == -1) {
-        PRINTF("queuebuf_load_to_ram: cfs read error\n");
+      to += size;
+    }
+  }
+  PRINTF("arena_compact: %u bytes reclaimed\n", arena_end - to);
+  arena_end = to;
+  arena_freed = 0;
+}
+/*---------------------------------------------------------------------------*/
+static struct qbuf_block *
+arena_alloc(struct queuebuf *owner, uint16_t size)
+{
+  struct qbuf_block *blk;
+
+  size = QBUF_ALIGN(size);
+  if(arena_end + size > QBUF_ARENA_SIZE) {
+    if(arena_end - arena_freed + size > QBUF_ARENA_SIZE) {
+      return NULL;
+    }
+    arena_compact();
+  }
+  blk = (struct qbuf_block *)&ARENA[arena_end];
+  arena_end += size;
+  blk->owner = owner - (struct queuebuf *)bufmem.mem;
+  blk->size = size;
+  return blk;
+}
+/*---------------------------------------------------------------------------*/
+static void
+arena_free(struct qbuf_block *blk)
+{
+  if((uint8_t *)blk + blk->size == &ARENA[arena_end]) {
+    arena_end -= blk->size;
+  } else {
+    blk->owner = QBUF_FREE;
+    arena_freed += blk->size;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+block_attrs(struct qbuf_block *blk)
+{
+  return (uint8_t *)(blk + 1) + blk->len;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+block_addrs(struct qbuf_block *blk)
+{
+  return block_attrs(blk) + blk->nattrs * QBUF_ATTR_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/* Number of bytes of a block in use, header included */
+static uint16_t
+block_used(struct qbuf_block *blk)
+{
+  return block_addrs(blk) + blk->naddrs * QBUF_ADDR_SIZE - (uint8_t *)blk;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the value of an attribute or address in a block, or NULL
+   if it is not stored */
+static uint8_t *
+block_find(uint8_t *p, uint8_t n, uint8_t entry_size, uint8_t type)
+{
+  for(; n > 0; n--, p += entry_size) {
+    if(*p == type) {
+      return p + 1;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+reverse(uint8_t *p, uint16_t size)
+{
+  uint8_t *q, c;
+
+  for(q = p + size - 1; p < q; p++, q--) {
+    c = *p;
+    *p = *q;
+    *q = c;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Move a block behind all others by rotating the blocks after it
+   down, which needs no room in the arena. The arena must have been
+   compacted. */
+static struct qbuf_block *
+block_move_last(struct qbuf_block *blk)
+{
+  uint8_t *start = (uint8_t *)blk;
+  uint16_t size = blk->size;
+  uint16_t rest = &ARENA[arena_end] - start - size;
+  uint16_t offset;
+
+  if(rest > 0) {
+    reverse(start, size);
+    reverse(start + size, rest);
+    reverse(start, size + rest);
+    for(offset = start - ARENA; offset < arena_end; offset += blk->size) {
+      blk = (struct qbuf_block *)&ARENA[offset];
+      QBUF_OWNER(blk)->block = blk;
+    }
+  }
+  return blk;
+}
+/*---------------------------------------------------------------------------*/
+/* Make the block of a qbuf at least size bytes large, moving it to a
+   new block if needed */
+static struct qbuf_block *
+block_resize(struct queuebuf *b, uint16_t size)
+{
+  struct qbuf_block *blk, *old;
+
+  if(size <= b->block->size) {
+    return b->block;
+  }
+  size = QBUF_ALIGN(size);
+  if(arena_end + size > QBUF_ARENA_SIZE) {
+    /* There is no room for a copy, so the block is grown where it is
+       after it has been moved to the end. */
+    if(arena_end - arena_freed - b->block->size + size > QBUF_ARENA_SIZE) {
+      PRINTF("block_resize: could not allocate %u bytes\n", size);
+      return NULL;
+    }
+    arena_compact();
+    blk = block_move_last(b->block);
+    arena_end += size - blk->size;
+    blk->size = size;
+    return blk;
+  }
+  blk = arena_alloc(b, size);
+  old = b->block;
+  blk->len = old->len;
+  blk->nattrs = old->nattrs;
+  blk->naddrs = old->naddrs;
+  memcpy(blk + 1, old + 1, block_used(old) - sizeof(struct qbuf_block));
+  arena_free(old);
+  b->block = blk;
+  return blk;
+}
+/*---------------------------------------------------------------------------*/
+/* Store the attributes and addresses of the packetbuf that are set
+   to p, or only count them if p is NULL. Returns their size. */
+static uint16_t
+pack_attrs(uint8_t *p, uint8_t *nattrs, uint8_t *naddrs)
+{
+  const rimeaddr_t *addr;
+  packetbuf_attr_t val;
+  uint8_t i;
+
+  *nattrs = *naddrs = 0;
+  for(i = 0; i < PACKETBUF_NUM_ATTRS; i++) {
+    val = packetbuf_attr(i);
+    if(val != 0) {
+      if(p != NULL) {
+        *p++ = i;
+        memcpy(p, &val, sizeof(val));
+        p += sizeof(val);
       }
-      return &tmpdata;
+      ++*nattrs;
     }
   }
+  for(i = PACKETBUF_ADDR_FIRST;
+      i < PACKETBUF_ADDR_FIRST + PACKETBUF_NUM_ADDRS; i++) {
+    addr = packetbuf_addr(i);
+    if(!rimeaddr_cmp(addr, &rimeaddr_null)) {
+      if(p != NULL) {
+        *p++ = i;
+        rimeaddr_copy((rimeaddr_t *)p, addr);
+        p += sizeof(rimeaddr_t);
+      }
+      ++*naddrs;
+    }
+  }
+  return *nattrs * QBUF_ATTR_SIZE + *naddrs * QBUF_ADDR_SIZE;
 }
 #else /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
@@ -299,8 +646,15 @@ queuebuf_init(void)
     qbuf_files[i].renewable = 1;
     qbuf_renew_file(i);
   }
+  for(i = 0; i < QUEUEBUF_SWAP_CACHE; i++) {
+    swap_cache_id[i] = -1;
+  }
 #endif
+#if QUEUEBUF_PACKED
+  arena_end = arena_freed = 0;
+#else /* QUEUEBUF_PACKED */
   memb_init(&buframmem);
+#endif /* QUEUEBUF_PACKED */
   memb_init(&bufmem);
   memb_init(&refbufmem);
 #if QUEUEBUF_STATS
@@ -333,7 +687,9 @@ queuebuf_new_from_packetbuf(void)
     }
     return (struct queuebuf *)rbuf;
   } else {
+#if !QUEUEBUF_PACKED
     struct queuebuf_data *buframptr;
+#endif /* !QUEUEBUF_PACKED */
     buf = memb_alloc(&bufmem);
     if(buf != NULL) {
 #if QUEUEBUF_DEBUG
@@ -342,6 +698,28 @@ queuebuf_new_from_packetbuf(void)
       buf->line = line;
       buf->time = clock_time();
 #endif /* QUEUEBUF_DEBUG */
+#if QUEUEBUF_PACKED
+      {
+        struct qbuf_block *blk;
+        uint8_t nattrs, naddrs;
+        uint16_t attrlen = pack_attrs(NULL, &nattrs, &naddrs);
+        blk = arena_alloc(buf, sizeof(struct qbuf_block) +
+                          packetbuf_totlen() + attrlen);
+        if(blk == NULL) {
+          PRINTF("queuebuf_new_from_packetbuf: could not allocate queuebuf data\n");
+#if QUEUEBUF_DEBUG
+          list_remove(queuebuf_list, buf);
+#endif /* QUEUEBUF_DEBUG */
+          memb_free(&bufmem, buf);
+          return NULL;
+        }
+        buf->block = blk;
+        blk->len = packetbuf_copyto(blk + 1);
+        blk->nattrs = nattrs;
+        blk->naddrs = naddrs;
+        pack_attrs(block_attrs(blk), &nattrs, &naddrs);
+      }
+#else /* QUEUEBUF_PACKED */
       buf->ram_ptr = memb_alloc(&buframmem);
 #if WITH_SWAP
       /* If the allocation failed, store the qbuf in swap files */
@@ -350,9 +728,12 @@ queuebuf_new_from_packetbuf(void)
         buframptr = buf->ram_ptr;
       } else {
         buf->location = IN_CFS;
-        buf->swap_id = -1;
-        tmpdata_qbuf = buf;
-        buframptr = &tmpdata;
+        buframptr = swap_append(buf);
+        if(buframptr == NULL) {
+          /* We were unable to make room in the swap */
+          memb_free(&bufmem, buf);
+          return NULL;
+        }
       }
 #else
       if(buf->ram_ptr == NULL) {
@@ -364,16 +745,7 @@ queuebuf_new_from_packetbuf(void)
 
       buframptr->len = packetbuf_copyto(buframptr->data);
       packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
-
-#if WITH_SWAP
-      if(buf->location == IN_CFS) {
-        if(queuebuf_flush_tmpdata() == -1) {
-          /* We were unable to write the data in the swap */
-          memb_free(&bufmem, buf);
-          return NULL;
-        }
-      }
-#endif
+#endif /* QUEUEBUF_PACKED */
 
 #if QUEUEBUF_STATS
       ++queuebuf_len;
@@ -396,20 +768,35 @@ queuebuf_new_from_packetbuf(void)
 void
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
+#if QUEUEBUF_PACKED
+  struct qbuf_block *blk;
+  uint8_t nattrs, naddrs;
+  uint16_t attrlen = pack_attrs(NULL, &nattrs, &naddrs);
+  blk = block_resize(buf, sizeof(struct qbuf_block) + buf->block->len +
+                     attrlen);
+  if(blk != NULL) {
+    blk->nattrs = nattrs;
+    blk->naddrs = naddrs;
+    pack_attrs(block_attrs(blk), &nattrs, &naddrs);
+  }
+#else /* QUEUEBUF_PACKED */
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
-    queuebuf_flush_tmpdata();
+    swap_rewrite(buf, buframptr);
   }
 #endif
+#endif /* QUEUEBUF_PACKED */
 }
 /*---------------------------------------------------------------------------*/
 void
 queuebuf_free(struct queuebuf *buf)
 {
   if(memb_inmemb(&bufmem, buf)) {
-#if WITH_SWAP
+#if QUEUEBUF_PACKED
+    arena_free(buf->block);
+#elif WITH_SWAP
     if(buf->location == IN_RAM) {
       memb_free(&buframmem, buf->ram_ptr);
     } else {
@@ -439,9 +826,25 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   struct queuebuf_ref *r;
   if(memb_inmemb(&bufmem, b)) {
+#if QUEUEBUF_PACKED
+    struct qbuf_block *blk = b->block;
+    packetbuf_attr_t val;
+    uint8_t *p;
+    uint8_t i;
+    packetbuf_copyfrom(blk + 1, blk->len);
+    p = block_attrs(blk);
+    for(i = 0; i < blk->nattrs; i++, p += QBUF_ATTR_SIZE) {
+      memcpy(&val, p + 1, sizeof(val));
+      packetbuf_set_attr(*p, val);
+    }
+    for(i = 0; i < blk->naddrs; i++, p += QBUF_ADDR_SIZE) {
+      packetbuf_set_addr(*p, (rimeaddr_t *)(p + 1));
+    }
+#else /* QUEUEBUF_PACKED */
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
     packetbuf_copyfrom(buframptr->data, buframptr->len);
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+#endif /* QUEUEBUF_PACKED */
   } else if(memb_inmemb(&refbufmem, b)) {
     r = (struct queuebuf_ref *)b;
     packetbuf_clear();
@@ -457,8 +860,12 @@ queuebuf_dataptr(struct queuebuf *b)
   struct queuebuf_ref *r;
 
   if(memb_inmemb(&bufmem, b)) {
+#if QUEUEBUF_PACKED
+    return b->block + 1;
+#else /* QUEUEBUF_PACKED */
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
     return buframptr->data;
+#endif /* QUEUEBUF_PACKED */
   } else if(memb_inmemb(&refbufmem, b)) {
     r = (struct queuebuf_ref *)b;
     return r->ref;
@@ -469,22 +876,77 @@ queuebuf_dataptr(struct queuebuf *b)
 int
 queuebuf_datalen(struct queuebuf *b)
 {
+#if QUEUEBUF_PACKED
+  return b->block->len;
+#else /* QUEUEBUF_PACKED */
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
   return buframptr->len;
+#endif /* QUEUEBUF_PACKED */
 }
 /*---------------------------------------------------------------------------*/
 rimeaddr_t *
 queuebuf_addr(struct queuebuf *b, uint8_t type)
 {
+#if QUEUEBUF_PACKED
+  uint8_t *p = block_find(block_addrs(b->block), b->block->naddrs,
+                          QBUF_ADDR_SIZE, type);
+  if(p == NULL) {
+    rimeaddr_copy(&null_addr, &rimeaddr_null);
+    return &null_addr;
+  }
+  return (rimeaddr_t *)p;
+#else /* QUEUEBUF_PACKED */
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
   return &buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr;
+#endif /* QUEUEBUF_PACKED */
+}
+/*---------------------------------------------------------------------------*/
+void
+queuebuf_set_addr(struct queuebuf *b, uint8_t type, const rimeaddr_t *addr)
+{
+#if QUEUEBUF_PACKED
+  struct qbuf_block *blk = b->block;
+  uint8_t *p = block_find(block_addrs(blk), blk->naddrs,
+                          QBUF_ADDR_SIZE, type);
+  if(p == NULL) {
+    if(rimeaddr_cmp(addr, &rimeaddr_null)) {
+      return;
+    }
+    blk = block_resize(b, block_used(blk) + QBUF_ADDR_SIZE);
+    if(blk == NULL) {
+      return;
+    }
+    p = block_addrs(blk) + blk->naddrs * QBUF_ADDR_SIZE;
+    *p++ = type;
+    blk->naddrs++;
+  }
+  rimeaddr_copy((rimeaddr_t *)p, addr);
+#else /* QUEUEBUF_PACKED */
+  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  rimeaddr_copy(&buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr, addr);
+#if WITH_SWAP
+  if(b->location == IN_CFS) {
+    swap_rewrite(b, buframptr);
+  }
+#endif
+#endif /* QUEUEBUF_PACKED */
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 queuebuf_attr(struct queuebuf *b, uint8_t type)
 {
+#if QUEUEBUF_PACKED
+  packetbuf_attr_t val = 0;
+  uint8_t *p = block_find(block_attrs(b->block), b->block->nattrs,
+                          QBUF_ATTR_SIZE, type);
+  if(p != NULL) {
+    memcpy(&val, p, sizeof(val));
+  }
+  return val;
+#else /* QUEUEBUF_PACKED */
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
   return buframptr->attrs[type].val;
+#endif /* QUEUEBUF_PACKED */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -63,6 +63,18 @@
 #define QUEUEBUF_NUM 8
 #endif
 
+/* QUEUEBUF_PACKED stores each queuebuf in a RAM arena using only as
+   many bytes as its data and its non-zero attributes and addresses
+   need, instead of a full PACKETBUF_SIZE buffer with every attribute.
+   QUEUEBUFRAM_NUM then sets the size of the arena, counted in
+   unpacked queuebufs, and QUEUEBUF_NUM the number of queuebufs that
+   may be stored in it. Swapping is disabled. */
+#ifdef QUEUEBUF_CONF_PACKED
+#define QUEUEBUF_PACKED QUEUEBUF_CONF_PACKED
+#else
+#define QUEUEBUF_PACKED 0
+#endif
+
 /* QUEUEBUFRAM_NUM is the number of queuebufs stored in RAM.
    If QUEUEBUFRAM_CONF_NUM is set lower than QUEUEBUF_NUM,
    swapping is enabled and queuebufs are stored either in RAM of CFS.
@@ -73,7 +85,7 @@
     #error "QUEUEBUFRAM_CONF_NUM cannot be greater than QUEUEBUF_NUM"
   #else
     #define QUEUEBUFRAM_NUM QUEUEBUFRAM_CONF_NUM
-    #define WITH_SWAP (QUEUEBUFRAM_NUM < QUEUEBUF_NUM)
+    #define WITH_SWAP (QUEUEBUFRAM_NUM < QUEUEBUF_NUM && !QUEUEBUF_PACKED)
   #endif
 #else /* QUEUEBUFRAM_CONF_NUM */
   #define QUEUEBUFRAM_NUM QUEUEBUF_NUM
@@ -101,10 +113,21 @@ void queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
 void queuebuf_to_packetbuf(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
 
+/* queuebuf_dataptr() and queuebuf_addr() return pointers into the
+   storage of a queuebuf, which are only valid until the next call to
+   queuebuf_new_from_packetbuf(), queuebuf_update_attr_from_packetbuf(),
+   queuebuf_set_addr() or queuebuf_free(), on any queuebuf. With
+   QUEUEBUF_PACKED these calls may move the blocks in the arena, and
+   with swapping a queuebuf in CFS is read into a cache that the next
+   access may reuse. Writing through the pointers is only safe for
+   queuebufs in RAM, within the data length they were created with.
+   Callers must not keep the pointers across those calls, nor across
+   a process wait. */
 void *queuebuf_dataptr(struct queuebuf *b);
 int queuebuf_datalen(struct queuebuf *b);
 
 rimeaddr_t *queuebuf_addr(struct queuebuf *b, uint8_t type);
+void queuebuf_set_addr(struct queuebuf *b, uint8_t type, const rimeaddr_t *addr);
 packetbuf_attr_t queuebuf_attr(struct queuebuf *b, uint8_t type);
 
 void queuebuf_debug_print(void);
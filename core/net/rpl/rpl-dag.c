@@ -57,10 +57,11 @@
 #include "net/uip-debug.h"
 
 #include "net/neighbor-info.h"
+#include "net/neighbor-attr.h"
 
 /************************************************************************/
 extern rpl_of_t RPL_OF;
-static rpl_of_t * const objective_functions[] = {&RPL_OF};
+static rpl_of_t * const objective_functions[] = RPL_SUPPORTED_OFS;
 
 /************************************************************************/
 #ifndef RPL_CONF_MAX_PARENTS_PER_DODAG
@@ -94,11 +95,65 @@ static rpl_of_t * const objective_functions[] = {&RPL_OF};
 /* Allocate parents from the same static MEMB chunk to reduce memory waste. */
 MEMB(parent_memb, struct rpl_parent, RPL_MAX_PARENTS_PER_DODAG*RPL_MAX_INSTANCES*RPL_MAX_DODAG_PER_INSTANCE);
 
+/* Parents are found through the neighbor table, keyed by the link
+   address that their link-local address is derived from. A neighbor
+   is a parent in at most one DODAG of an instance. */
+struct rpl_neighbor {
+  rpl_parent_t *parents[RPL_MAX_INSTANCES];
+};
+NEIGHBOR_ATTRIBUTE(struct rpl_neighbor, rpl_neighbors, NULL);
+
 /************************************************************************/
 /* Allocate instance table. */
 rpl_instance_t instance_table[RPL_MAX_INSTANCES];
 rpl_instance_t *default_instance;
 
+/************************************************************************/
+static const rimeaddr_t *
+parent_key(uip_ipaddr_t *addr)
+{
+  static rimeaddr_t key;
+
+  memset(&key, 0, sizeof(key));
+  uip_ds6_get_addr_iid(addr, (uip_lladdr_t *)&key);
+  return &key;
+}
+/************************************************************************/
+static rpl_parent_t **
+parent_slot(rpl_instance_t *instance, uip_ipaddr_t *addr)
+{
+  struct rpl_neighbor *n;
+
+  n = neighbor_attr_get_data(&rpl_neighbors, parent_key(addr));
+  if(n == NULL) {
+    return NULL;
+  }
+  return &n->parents[instance - instance_table];
+}
+/************************************************************************/
+/* The neighbor table keeps the link state of our parents, which it
+   would otherwise evict for more recently heard neighbors. */
+static int
+rpl_neighbor_veto(void *data)
+{
+  struct rpl_neighbor *n;
+  int i;
+
+  n = data;
+  for(i = 0; i < RPL_MAX_INSTANCES; i++) {
+    if(n->parents[i] != NULL) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/************************************************************************/
+void
+rpl_dag_init(void)
+{
+  neighbor_attr_register(&rpl_neighbors);
+  neighbor_attr_set_evict_veto(&rpl_neighbors, rpl_neighbor_veto);
+}
 /************************************************************************/
 /* Remove DAG parents with a rank that is at least the same as minimum_rank. */
 static void
@@ -468,12 +523,24 @@ rpl_parent_t *
 rpl_add_parent(rpl_dag_t *dag, rpl_dio_t *dio, uip_ipaddr_t *addr)
 {
   rpl_parent_t *p;
+  rpl_parent_t **slot;
+
+  if(neighbor_attr_add_neighbor(parent_key(addr)) < 0) {
+    RPL_STAT(rpl_stats.mem_overflows++);
+    return NULL;
+  }
+  slot = parent_slot(dag->instance, addr);
+  if(*slot != NULL) {
+    /* The neighbor was a parent in another DODAG of the instance. */
+    rpl_remove_parent((*slot)->dag, *slot);
+  }
 
   p = memb_alloc(&parent_memb);
   if(p == NULL) {
     RPL_STAT(rpl_stats.mem_overflows++);
     return NULL;
   }
+  *slot = p;
   memcpy(&p->addr, addr, sizeof(p->addr));
   p->dag = dag;
   p->rank = dio->rank;
@@ -489,10 +556,9 @@ rpl_find_parent(rpl_dag_t *dag, uip_ipaddr_t *addr)
 {
   rpl_parent_t *p;
 
-  for(p = list_head(dag->parents); p != NULL; p = p->next) {
-    if(uip_ipaddr_cmp(&p->addr, addr)) {
-      return p;
-    }
+  p = rpl_find_parent_any_dag(dag->instance, addr);
+  if(p != NULL && p->dag == dag) {
+    return p;
   }
   return NULL;
 }
@@ -502,34 +568,19 @@ rpl_dag_t *
 rpl_find_parent_dag(rpl_instance_t *instance, uip_ipaddr_t *addr)
 {
   rpl_parent_t *p;
-  rpl_dag_t *dag, *end;
 
-  for(dag = &instance->dag_table[0], end = dag + RPL_MAX_DODAG_PER_INSTANCE; dag < end; ++dag) {
-    if(dag->used) {
-      for(p = list_head(dag->parents); p != NULL; p = p->next) {
-        if(uip_ipaddr_cmp(&p->addr, addr)) {
-          return dag;
-        }
-      }
-    }
-  }
-  return NULL;
+  p = rpl_find_parent_any_dag(instance, addr);
+  return p == NULL ? NULL : p->dag;
 }
 /************************************************************************/
 rpl_parent_t *
 rpl_find_parent_any_dag(rpl_instance_t *instance, uip_ipaddr_t *addr)
 {
-  rpl_parent_t *p;
-  rpl_dag_t *dag, *end;
+  rpl_parent_t **slot;
 
-  for(dag = &instance->dag_table[0], end = dag + RPL_MAX_DODAG_PER_INSTANCE; dag < end; ++dag) {
-    if(dag->used) {
-      for(p = list_head(dag->parents); p != NULL; p = p->next) {
-        if(uip_ipaddr_cmp(&p->addr, addr)) {
-          return p;
-        }
-      }
-    }
+  slot = parent_slot(instance, addr);
+  if(slot != NULL && *slot != NULL && uip_ipaddr_cmp(&(*slot)->addr, addr)) {
+    return *slot;
   }
   return NULL;
 }
@@ -608,6 +659,8 @@ rpl_select_dodag(rpl_instance_t *instance, rpl_parent_t *p)
     PRINTF("RPL: Changed preferred parent, rank changed from %u to %u\n",
   	(unsigned)old_rank, best_dag->rank);
     RPL_STAT(rpl_stats.parent_switch++);
+    RPL_TRACE(RPL_TRACE_PARENT_SWITCH,
+              RPL_TRACE_ADDR(&best_dag->preferred_parent->addr));
     if(instance->mop != RPL_MOP_NO_DOWNWARD_ROUTES) {
       if(last_parent != NULL) {
         /* Send a No-Path DAO to the removed preferred parent. */
@@ -653,6 +706,8 @@ rpl_select_parent(rpl_dag_t *dag)
 void
 rpl_remove_parent(rpl_dag_t *dag, rpl_parent_t *parent)
 {
+  rpl_parent_t **slot;
+
   rpl_nullify_parent(dag, parent);
 
   PRINTF("RPL: Removing parent ");
@@ -660,6 +715,10 @@ rpl_remove_parent(rpl_dag_t *dag, rpl_parent_t *parent)
   PRINTF("\n");
 
   list_remove(dag->parents, parent);
+  slot = parent_slot(dag->instance, &parent->addr);
+  if(slot != NULL && *slot == parent) {
+    *slot = NULL;
+  }
   memb_free(&parent_memb, parent);
 }
 /************************************************************************/
@@ -981,6 +1040,7 @@ global_repair(uip_ipaddr_t *from, rpl_dag_t *dag, rpl_dio_t *dio)
          dag->version, dag->rank);
 
   RPL_STAT(rpl_stats.global_repairs++);
+  RPL_TRACE(RPL_TRACE_GLOBAL_REPAIR, dag->version);
 }
 /************************************************************************/
 void
@@ -992,6 +1052,10 @@ rpl_local_repair(rpl_instance_t *instance)
   for(i = 0; i < RPL_MAX_DODAG_PER_INSTANCE; i++) {
     if(instance->dag_table[i].used) {
       instance->dag_table[i].rank = INFINITE_RANK;
+      /* Having detached, we may rejoin deeper than we were (RFC 6550,
+         8.2.2.5); otherwise a node whose only good parent failed
+         stays detached until the next DODAG version. */
+      instance->dag_table[i].min_rank = INFINITE_RANK;
       nullify_parents(&instance->dag_table[i], 0);
     }
   }
@@ -999,6 +1063,7 @@ rpl_local_repair(rpl_instance_t *instance)
   rpl_reset_dio_timer(instance, 0);
 
   RPL_STAT(rpl_stats.local_repairs++);
+  RPL_TRACE(RPL_TRACE_LOCAL_REPAIR, instance->instance_id);
 }
 /************************************************************************/
 void
@@ -153,6 +153,9 @@ dis_input(void)
   PRINT6ADDR(&UIP_IP_BUF->srcipaddr);
   PRINTF("\n");
 
+  RPL_STAT(rpl_stats.dis_in++);
+  RPL_TRACE(RPL_TRACE_DIS_IN, RPL_TRACE_ADDR(&UIP_IP_BUF->srcipaddr));
+
   for(instance = &instance_table[0], end = instance + RPL_MAX_INSTANCES; instance < end; ++instance) {
     if(instance->used == 1 ) {
 #if RPL_LEAF_ONLY
@@ -193,6 +196,8 @@ dis_output(uip_ipaddr_t *addr)
   } else {
     PRINTF("RPL: Sending a unicast DIS\n");
   }
+  RPL_STAT(rpl_stats.dis_out++);
+  RPL_TRACE(RPL_TRACE_DIS_OUT, RPL_TRACE_ADDR(addr));
   uip_icmp6_send(addr, ICMP6_RPL, RPL_CODE_DIS, 2);
 }
 /*---------------------------------------------------------------------------*/
@@ -200,7 +205,7 @@ static void
 dio_input(void)
 {
   unsigned char *buffer;
-  uint8_t buffer_length;
+  uint16_t buffer_length;
   rpl_dio_t dio;
   uint8_t subopt_type;
   int i;
@@ -221,6 +226,9 @@ dio_input(void)
   PRINT6ADDR(&from);
   PRINTF("\n");
 
+  RPL_STAT(rpl_stats.dio_in++);
+  RPL_TRACE(RPL_TRACE_DIO_IN, RPL_TRACE_ADDR(&from));
+
   if((nbr = uip_ds6_nbr_lookup(&from)) == NULL) {
     if((nbr = uip_ds6_nbr_add(&from, (uip_lladdr_t *)
                               packetbuf_addr(PACKETBUF_ADDR_SENDER),
@@ -295,29 +303,9 @@ dio_input(void)
 	RPL_STAT(rpl_stats.malformed_msgs++);
         return;
       }
-      dio.mc.type = buffer[i + 2];
-      dio.mc.flags = buffer[i + 3] << 1;
-      dio.mc.flags |= buffer[i + 4] >> 7;
-      dio.mc.aggr = (buffer[i + 4] >> 4) & 0x3;
-      dio.mc.prec = buffer[i + 4] & 0xf;
-      dio.mc.length = buffer[i + 5];
-
-      if(dio.mc.type == RPL_DAG_MC_ETX) {
-        dio.mc.obj.etx = get16(buffer, i + 6);
-
-        PRINTF("RPL: DAG MC: type %u, flags %u, aggr %u, prec %u, length %u, ETX %u\n",
-	       (unsigned)dio.mc.type,  
-	       (unsigned)dio.mc.flags, 
-	       (unsigned)dio.mc.aggr, 
-	       (unsigned)dio.mc.prec, 
-	       (unsigned)dio.mc.length, 
-	       (unsigned)dio.mc.obj.etx);
-      } else if(dio.mc.type == RPL_DAG_MC_ENERGY) {
-        dio.mc.obj.energy.flags = buffer[i + 6];
-        dio.mc.obj.energy.energy_est = buffer[i + 7];
-      } else {
-       PRINTF("RPL: Unhandled DAG MC type: %u\n", (unsigned)dio.mc.type);
-       return;
+      if(rpl_mc_decode(&buffer[i + 2], len - 2, &dio.mc) < 0) {
+	RPL_STAT(rpl_stats.malformed_msgs++);
+        return;
       }
       break;
     case RPL_OPTION_ROUTE_INFO:
@@ -400,6 +388,7 @@ dio_output(rpl_instance_t *instance, uip_ipaddr_t *uc_addr)
   unsigned char *buffer;
   int pos;
 #if !RPL_LEAF_ONLY
+  int len;
   uip_ipaddr_t addr;
 #endif /* !RPL_LEAF_ONLY */
 
@@ -412,6 +401,9 @@ dio_output(rpl_instance_t *instance, uip_ipaddr_t *uc_addr)
 
   rpl_dag_t *dag = instance->current_dag;
 
+  RPL_STAT(rpl_stats.dio_out++);
+  RPL_TRACE(RPL_TRACE_DIO_OUT, uc_addr == NULL ? 0 : RPL_TRACE_ADDR(uc_addr));
+
   /* DAG Information Object */
   pos = 0;
 
@@ -452,25 +444,13 @@ dio_output(rpl_instance_t *instance, uip_ipaddr_t *uc_addr)
   if(instance->mc.type != RPL_DAG_MC_NONE) {
     instance->of->update_metric_container(instance);
 
-    buffer[pos++] = RPL_OPTION_DAG_METRIC_CONTAINER;
-    buffer[pos++] = 6;
-    buffer[pos++] = instance->mc.type;
-    buffer[pos++] = instance->mc.flags >> 1;
-    buffer[pos] = (instance->mc.flags & 1) << 7;
-    buffer[pos++] |= (instance->mc.aggr << 4) | instance->mc.prec;
-    if(instance->mc.type == RPL_DAG_MC_ETX) {
-      buffer[pos++] = 2;
-      set16(buffer, pos, instance->mc.obj.etx);
-      pos += 2;
-    } else if(instance->mc.type == RPL_DAG_MC_ENERGY) {
-      buffer[pos++] = 2;
-      buffer[pos++] = instance->mc.obj.energy.flags;
-      buffer[pos++] = instance->mc.obj.energy.energy_est;
-    } else {
+    len = rpl_mc_encode(&buffer[pos], &instance->mc);
+    if(len < 0) {
       PRINTF("RPL: Unable to send DIO because of unhandled DAG MC type %u\n",
 	(unsigned)instance->mc.type);
       return;
     }
+    pos += len;
   }
 #endif /* !RPL_LEAF_ONLY */
 
@@ -538,6 +518,75 @@ dio_output(rpl_instance_t *instance, uip_ipaddr_t *uc_addr)
 #endif /* RPL_LEAF_ONLY */
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Installs or refreshes the route (or multicast route) for a single DAO
+ * target. Returns 1 if the routing state towards the target changed.
+ */
+static int
+dao_process_target(rpl_dag_t *dag, uip_ipaddr_t *prefix, uint8_t prefixlen,
+                   uint8_t lifetime, uip_ipaddr_t *dao_sender_addr,
+                   int learned_from)
+{
+  rpl_instance_t *instance;
+  uip_ds6_route_t *rep;
+  int changed;
+
+  instance = dag->instance;
+
+  PRINTF("RPL: DAO lifetime: %u, prefix length: %u prefix: ",
+          (unsigned)lifetime, (unsigned)prefixlen);
+  PRINT6ADDR(prefix);
+  PRINTF("\n");
+
+#if UIP_IPV6_MULTICAST_RPL
+  if(uip_is_addr_mcast_global(prefix)) {
+    changed = uip_ds6_mcast_route_lookup(prefix) == NULL;
+    mcast_group = uip_ds6_mcast_route_add(prefix);
+    if(mcast_group) {
+      mcast_group->dag = dag;
+      mcast_group->lifetime = RPL_LIFETIME(instance, lifetime);
+    }
+    return changed;
+  }
+#endif
+
+  rep = uip_ds6_route_lookup(prefix);
+
+  if(lifetime == ZERO_LIFETIME) {
+    /* No-Path DAO received; invoke the route purging routine. A No-Path
+       from a node that is not our next hop towards the target is stale:
+       the target has moved to another child. */
+    if(rep != NULL && rep->state.saved_lifetime == 0 &&
+       rep->length == prefixlen &&
+       uip_ipaddr_cmp(&rep->nexthop, dao_sender_addr)) {
+      PRINTF("RPL: Setting expiration timer for prefix ");
+      PRINT6ADDR(prefix);
+      PRINTF("\n");
+      rep->state.saved_lifetime = rep->state.lifetime;
+      rep->state.lifetime = DAO_EXPIRATION_TIMEOUT;
+      return 1;
+    }
+    return 0;
+  }
+
+  changed = rep == NULL || rep->length != prefixlen ||
+            !uip_ipaddr_cmp(&rep->nexthop, dao_sender_addr);
+
+  rep = rpl_add_route(dag, prefix, prefixlen, dao_sender_addr);
+  if(rep == NULL) {
+    RPL_STAT(rpl_stats.mem_overflows++);
+    PRINTF("RPL: Could not add a route after receiving a DAO\n");
+    return 0;
+  }
+
+  /* A fresh DAO cancels the expiration started by a No-Path DAO. */
+  changed |= rep->state.saved_lifetime != 0;
+  rep->state.saved_lifetime = 0;
+  rep->state.lifetime = RPL_LIFETIME(instance, lifetime);
+  rep->state.learned_from = learned_from;
+  return changed;
+}
+/*---------------------------------------------------------------------------*/
 static void
 dao_input(void)
 {
@@ -551,19 +600,20 @@ dao_input(void)
   uint8_t prefixlen;
   uint8_t flags;
   uint8_t subopt_type;
-  uint8_t pathcontrol;
-  uint8_t pathsequence;
   uip_ipaddr_t prefix;
-  uip_ds6_route_t *rep;
-  uint8_t buffer_length;
+  uint16_t buffer_length;
   int pos;
   int len;
   int i;
+  int j;
   int learned_from;
+  int targets;
+  int nopaths;
+#if RPL_DAO_AGGREGATE
+  int changed;
+#endif /* RPL_DAO_AGGREGATE */
   rpl_parent_t *p;
 
-  prefixlen = 0;
-
   uip_ipaddr_copy(&dao_sender_addr, &UIP_IP_BUF->srcipaddr);
 
   /* Destination Advertisement Object */
@@ -571,6 +621,9 @@ dao_input(void)
   PRINT6ADDR(&dao_sender_addr);
   PRINTF("\n");
 
+  RPL_STAT(rpl_stats.dao_in++);
+  RPL_TRACE(RPL_TRACE_DAO_IN, RPL_TRACE_ADDR(&dao_sender_addr));
+
   buffer = UIP_ICMP_PAYLOAD;
   buffer_length = uip_len - uip_l2_l3_icmp_hdr_len;
 
@@ -587,8 +640,6 @@ dao_input(void)
     return;
   }
 
-  lifetime = instance->default_lifetime;
-
   flags = buffer[pos++];
   /* reserved */
   pos++;
@@ -623,9 +674,16 @@ dao_input(void)
     }
   }
 
-  /* Check if there are any RPL options present. */
-  i = pos;
-  for(; i < buffer_length; i += len) {
+  /*
+   * A DAO may carry several target options. Each group of targets is
+   * followed by the transit information option that applies to it.
+   */
+  targets = 0;
+  nopaths = 0;
+#if RPL_DAO_AGGREGATE
+  changed = 0;
+#endif /* RPL_DAO_AGGREGATE */
+  for(i = pos; i < buffer_length; i += len) {
     subopt_type = buffer[i];
     if(subopt_type == RPL_OPTION_PAD1) {
       len = 1;
@@ -634,114 +692,134 @@ dao_input(void)
       len = 2 + buffer[i + 1];
     }
 
-    switch(subopt_type) {
-    case RPL_OPTION_TARGET:
-      /* Handle the target option. */
-      prefixlen = buffer[i + 3];
-      memset(&prefix, 0, sizeof(prefix));
-      memcpy(&prefix, buffer + i + 4, (prefixlen + 7) / CHAR_BIT);
-      break;
-    case RPL_OPTION_TRANSIT:
-      /* The path sequence and control are ignored. */
-      pathcontrol = buffer[i + 3];
-      pathsequence = buffer[i + 4];
-      lifetime = buffer[i + 5];
-      /* The parent address is also ignored. */
-      break;
+    if(len + i > buffer_length) {
+      PRINTF("RPL: Invalid DAO packet\n");
+      RPL_STAT(rpl_stats.malformed_msgs++);
+      return;
     }
-  }
 
-  PRINTF("RPL: DAO lifetime: %u, prefix length: %u prefix: ",
-          (unsigned)lifetime, (unsigned)prefixlen);
-  PRINT6ADDR(&prefix);
-  PRINTF("\n");
+    if(subopt_type != RPL_OPTION_TARGET) {
+      continue;
+    }
 
-#if UIP_IPV6_MULTICAST_RPL
-  if(uip_is_addr_mcast_global(&prefix)) {
-    mcast_group = uip_ds6_mcast_route_add(&prefix);
-    if(mcast_group) {
-      mcast_group->dag = dag;
-      mcast_group->lifetime = RPL_LIFETIME(instance, lifetime);
+    /* Handle the target option. */
+    prefixlen = buffer[i + 3];
+    if(prefixlen > 128 || len < 4 + (prefixlen + 7) / CHAR_BIT) {
+      PRINTF("RPL: Invalid DAO target option, len = %d\n", len);
+      RPL_STAT(rpl_stats.malformed_msgs++);
+      return;
+    }
+    memset(&prefix, 0, sizeof(prefix));
+    memcpy(&prefix, buffer + i + 4, (prefixlen + 7) / CHAR_BIT);
+
+    /* The lifetime is found in the next transit information option. */
+    lifetime = instance->default_lifetime;
+    for(j = i + len; j + 1 < buffer_length; j += buffer[j] == RPL_OPTION_PAD1 ? 1 : 2 + buffer[j + 1]) {
+      if(buffer[j] == RPL_OPTION_TRANSIT) {
+        /* The path sequence, control and parent address are ignored. */
+        if(j + 5 < buffer_length) {
+          lifetime = buffer[j + 5];
+        }
+        break;
+      }
     }
-  } else
-#endif
-  {
-  rep = uip_ds6_route_lookup(&prefix);
 
-  if(lifetime == ZERO_LIFETIME) {
-    /* No-Path DAO received; invoke the route purging routine. */
-    if(rep != NULL && rep->state.saved_lifetime == 0 && rep->length == prefixlen) {
-      PRINTF("RPL: Setting expiration timer for prefix ");
-      PRINT6ADDR(&prefix);
-      PRINTF("\n");
-      rep->state.saved_lifetime = rep->state.lifetime;
-      rep->state.lifetime = DAO_EXPIRATION_TIMEOUT;
+    if(dao_process_target(dag, &prefix, prefixlen, lifetime,
+                          &dao_sender_addr, learned_from)) {
+#if RPL_DAO_AGGREGATE
+      changed = 1;
+#endif /* RPL_DAO_AGGREGATE */
+      if(lifetime == ZERO_LIFETIME) {
+        nopaths++;
+      }
+    }
+    if(lifetime != ZERO_LIFETIME) {
+      targets++;
     }
-    return;
   }
 
-  rep = rpl_add_route(dag, &prefix, prefixlen, &dao_sender_addr);
-  if(rep == NULL) {
-    RPL_STAT(rpl_stats.mem_overflows++);
-    PRINTF("RPL: Could not add a route after receiving a DAO\n");
+  if(learned_from != RPL_ROUTE_FROM_UNICAST_DAO) {
     return;
   }
 
-  rep->state.lifetime = RPL_LIFETIME(instance, lifetime);
-  rep->state.learned_from = learned_from;
-  }
-
-  if(learned_from == RPL_ROUTE_FROM_UNICAST_DAO) {
+  /* With no targets, or only No-Path targets that we do not route
+     through the sender, our parent need not hear of the DAO. The
+     sender may still ask for an acknowledgment. */
+  if(targets != 0 || nopaths != 0) {
+#if RPL_DAO_AGGREGATE
+    /* Our own DAOs carry the targets of the sub-DODAG, and No-Path
+       targets for the routes that are expiring. */
+    if(changed && dag->preferred_parent) {
+      rpl_schedule_dao(instance);
+    }
+#else /* RPL_DAO_AGGREGATE */
     if(dag->preferred_parent) {
       PRINTF("RPL: Forwarding DAO to parent ");
       PRINT6ADDR(&dag->preferred_parent->addr);
       PRINTF("\n");
+      /* The DAO is acknowledged hop-by-hop, by us. */
+      buffer[1] &= ~RPL_DAO_K_FLAG;
+      RPL_STAT(rpl_stats.dao_out++);
+      RPL_TRACE(RPL_TRACE_DAO_OUT,
+                RPL_TRACE_ADDR(&dag->preferred_parent->addr));
       uip_icmp6_send(&dag->preferred_parent->addr,
                      ICMP6_RPL, RPL_CODE_DAO, buffer_length);
     }
-    if(flags & RPL_DAO_K_FLAG) {
-      dao_ack_output(instance, &dao_sender_addr, sequence);
-    }
+#endif /* RPL_DAO_AGGREGATE */
+  }
+  /* The acknowledgment is built in uip_buf, after the forwarded DAO
+     has been sent from it. */
+  if(flags & RPL_DAO_K_FLAG) {
+    dao_ack_output(instance, &dao_sender_addr, sequence);
   }
 }
 /*---------------------------------------------------------------------------*/
-void
-dao_output(rpl_parent_t *n, uint8_t lifetime, uip_ipaddr_t * target)
+/*
+ * A DAO message is built incrementally in uip_buf. Consecutive targets
+ * with the same lifetime share one transit information option, and the
+ * message is sent as soon as the next target would not fit in
+ * RPL_DAO_MAX_PAYLOAD bytes.
+ */
+static rpl_parent_t *dao_batch_parent;
+static rpl_dag_t *dao_batch_dag;
+static int dao_batch_pos;
+static uint8_t dao_batch_lifetime;
+static uint8_t dao_batch_group;
+#if RPL_CONF_DAO_ACK
+static uint8_t dao_batch_track;
+#endif /* RPL_CONF_DAO_ACK */
+/*---------------------------------------------------------------------------*/
+static void
+dao_batch_init(rpl_parent_t *n)
 {
-  rpl_dag_t *dag;
-  rpl_instance_t *instance;
-  unsigned char *buffer;
-  uint8_t prefixlen;
-  uip_ipaddr_t addr;
-  int pos;
-
-  /* Destination Advertisement Object */
-  if(target == NULL) {
-    /* Caller didn't specify a target, try to use our own unicast global */
-    target = get_global_addr();
-  }
-
-  if(target == NULL) {
-    PRINTF("RPL: No global address set for this node - suppressing DAO\n");
-    return;
-  }
+  dao_batch_parent = n;
+  dao_batch_pos = 0;
+  dao_batch_group = 0;
 
   if(n == NULL) {
-    dag = rpl_get_any_dag();
-    if(dag == NULL) {
+    dao_batch_dag = rpl_get_any_dag();
+    if(dao_batch_dag == NULL) {
       PRINTF("RPL: Did not join a DAG before sending DAO\n");
-      return;
     }
   } else {
-    dag = n->dag;
+    dao_batch_dag = n->dag;
   }
 
-  instance = dag->instance;
-
 #ifdef RPL_DEBUG_DAO_OUTPUT
-  RPL_DEBUG_DAO_OUTPUT(n);
+  if(dao_batch_dag != NULL) {
+    RPL_DEBUG_DAO_OUTPUT(n);
+  }
 #endif
+}
+/*---------------------------------------------------------------------------*/
+static void
+dao_batch_open(void)
+{
+  rpl_instance_t *instance;
+  unsigned char *buffer;
+  int pos;
 
+  instance = dao_batch_dag->instance;
   buffer = UIP_ICMP_PAYLOAD;
 
   RPL_LOLLIPOP_INCREMENT(dao_sequence);
@@ -759,54 +837,180 @@ dao_output(rpl_parent_t *n, uint8_t lifetime, uip_ipaddr_t * target)
   buffer[pos++] = 0; /* reserved */
   buffer[pos++] = dao_sequence;
 #if RPL_DAO_SPECIFY_DODAG
-  memcpy(buffer + pos, &dag->dag_id, sizeof(dag->dag_id));
-  pos+=sizeof(dag->dag_id);
+  memcpy(buffer + pos, &dao_batch_dag->dag_id, sizeof(dao_batch_dag->dag_id));
+  pos+=sizeof(dao_batch_dag->dag_id);
 #endif /* RPL_DAO_SPECIFY_DODAG */
 
-  /* create target subopt */
-  prefixlen = sizeof(uip_ipaddr_t) * CHAR_BIT;
-  buffer[pos++] = RPL_OPTION_TARGET;
-  buffer[pos++] = 2 + ((prefixlen + 7) / CHAR_BIT);
-  buffer[pos++] = 0; /* reserved */
-  buffer[pos++] = prefixlen;
-  memcpy(buffer + pos, target, (prefixlen + 7) / CHAR_BIT);
-  pos += ((prefixlen + 7) / CHAR_BIT);
+  dao_batch_pos = pos;
+  dao_batch_group = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dao_batch_close_group(void)
+{
+  unsigned char *buffer;
+
+  if(dao_batch_group == 0) {
+    return;
+  }
+
+  buffer = UIP_ICMP_PAYLOAD;
 
   /* Create a transit information sub-option. */
-  buffer[pos++] = RPL_OPTION_TRANSIT;
-  buffer[pos++] = 4;
-  buffer[pos++] = 0; /* flags - ignored */
-  buffer[pos++] = 0; /* path control - ignored */
-  buffer[pos++] = 0; /* path seq - ignored */
-  buffer[pos++] = lifetime;
+  buffer[dao_batch_pos++] = RPL_OPTION_TRANSIT;
+  buffer[dao_batch_pos++] = 4;
+  buffer[dao_batch_pos++] = 0; /* flags - ignored */
+  buffer[dao_batch_pos++] = 0; /* path control - ignored */
+  buffer[dao_batch_pos++] = 0; /* path seq - ignored */
+  buffer[dao_batch_pos++] = dao_batch_lifetime;
+
+  dao_batch_group = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dao_batch_send(void)
+{
+  uip_ipaddr_t addr;
+#if RPL_CONF_DAO_ACK
+  rpl_instance_t *instance;
+#endif /* RPL_CONF_DAO_ACK */
 
-  if(n == NULL) {
+  if(dao_batch_pos == 0) {
+    return;
+  }
+
+  dao_batch_close_group();
+
+  if(dao_batch_parent == NULL) {
     uip_create_linklocal_rplnodes_mcast(&addr);
   } else {
-    uip_ipaddr_copy(&addr, &n->addr);
+    uip_ipaddr_copy(&addr, &dao_batch_parent->addr);
   }
 
-  PRINTF("RPL: Sending DAO with prefix ");
-  PRINT6ADDR(&prefix);
-  PRINTF(" to ");
-  if(n != NULL) {
-    PRINT6ADDR(&n->addr);
+  PRINTF("RPL: Sending DAO with sequence %u to ", dao_sequence);
+  if(dao_batch_parent != NULL) {
+    PRINT6ADDR(&dao_batch_parent->addr);
   } else {
     PRINTF("multicast address");
   }
   PRINTF("\n");
 
-  uip_icmp6_send(&addr, ICMP6_RPL, RPL_CODE_DAO, pos);
+#if RPL_CONF_DAO_ACK
+  /* Remember which DAOs of this round are waiting for an acknowledgement. */
+  instance = dao_batch_dag->instance;
+  if(dao_batch_track && instance->dao_seq_count < 32) {
+    if(instance->dao_seq_count == 0) {
+      instance->dao_seq_first = dao_sequence;
+    }
+    instance->dao_ack_pending |= 1UL << instance->dao_seq_count;
+    instance->dao_seq_count++;
+  }
+#endif /* RPL_CONF_DAO_ACK */
+
+  RPL_STAT(rpl_stats.dao_out++);
+  RPL_TRACE(RPL_TRACE_DAO_OUT, RPL_TRACE_ADDR(&addr));
+  uip_icmp6_send(&addr, ICMP6_RPL, RPL_CODE_DAO, dao_batch_pos);
+  dao_batch_pos = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+dao_batch_start(rpl_parent_t *n)
+{
+  dao_batch_init(n);
+#if RPL_CONF_DAO_ACK
+  dao_batch_track = 1;
+  if(dao_batch_dag != NULL) {
+    dao_batch_dag->instance->dao_ack_pending = 0;
+    dao_batch_dag->instance->dao_seq_count = 0;
+  }
+#endif /* RPL_CONF_DAO_ACK */
+}
+/*---------------------------------------------------------------------------*/
+void
+dao_batch_add(uip_ipaddr_t *target, uint8_t prefixlen, uint8_t lifetime)
+{
+  unsigned char *buffer;
+  int needed;
+
+  if(dao_batch_dag == NULL) {
+    return;
+  }
+
+  if(target == NULL) {
+    /* Caller didn't specify a target, try to use our own unicast global */
+    target = get_global_addr();
+    if(target == NULL) {
+      PRINTF("RPL: No global address set for this node - suppressing DAO\n");
+      return;
+    }
+  }
+
+  /* Space needed for the target, its transit option and ending the
+     group that is currently open, if this target cannot join it. */
+  needed = 4 + (prefixlen + 7) / CHAR_BIT + 6;
+  if(dao_batch_group > 0 && lifetime != dao_batch_lifetime) {
+    needed += 6;
+  }
+
+  if(dao_batch_pos > 0 && dao_batch_pos + needed > RPL_DAO_MAX_PAYLOAD) {
+    dao_batch_send();
+  }
+  if(dao_batch_pos == 0) {
+    dao_batch_open();
+  }
+
+  if(dao_batch_group > 0 && lifetime != dao_batch_lifetime) {
+    dao_batch_close_group();
+  }
+
+  buffer = UIP_ICMP_PAYLOAD;
+
+  /* create target subopt */
+  buffer[dao_batch_pos++] = RPL_OPTION_TARGET;
+  buffer[dao_batch_pos++] = 2 + ((prefixlen + 7) / CHAR_BIT);
+  buffer[dao_batch_pos++] = 0; /* reserved */
+  buffer[dao_batch_pos++] = prefixlen;
+  memcpy(buffer + dao_batch_pos, target, (prefixlen + 7) / CHAR_BIT);
+  dao_batch_pos += ((prefixlen + 7) / CHAR_BIT);
+
+  dao_batch_lifetime = lifetime;
+  dao_batch_group++;
+}
+/*---------------------------------------------------------------------------*/
+void
+dao_batch_flush(void)
+{
+  if(dao_batch_dag != NULL) {
+    dao_batch_send();
+  }
+  dao_batch_dag = NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+dao_output(rpl_parent_t *n, uint8_t lifetime, uip_ipaddr_t * target)
+{
+  /* A single DAO outside of a batch round, e.g. a No-Path DAO. */
+  dao_batch_init(n);
+#if RPL_CONF_DAO_ACK
+  dao_batch_track = 0;
+#endif /* RPL_CONF_DAO_ACK */
+  dao_batch_add(target, sizeof(uip_ipaddr_t) * CHAR_BIT, lifetime);
+  dao_batch_flush();
 }
 /*---------------------------------------------------------------------------*/
 static void
 dao_ack_input(void)
 {
   unsigned char *buffer;
-  uint8_t buffer_length;
+  uint16_t buffer_length;
   uint8_t instance_id;
   uint8_t sequence;
   uint8_t status;
+#if RPL_CONF_DAO_ACK
+  rpl_instance_t *instance;
+  uint8_t seq;
+  uint8_t i;
+#endif /* RPL_CONF_DAO_ACK */
 
   buffer = UIP_ICMP_PAYLOAD;
   buffer_length = uip_len - uip_l2_l3_icmp_hdr_len;
@@ -819,6 +1023,29 @@ dao_ack_input(void)
     sequence, status);
   PRINT6ADDR(&UIP_IP_BUF->srcipaddr);
   PRINTF("\n");
+
+  RPL_STAT(rpl_stats.dao_ack_in++);
+  RPL_TRACE(RPL_TRACE_DAO_ACK_IN, RPL_TRACE_ADDR(&UIP_IP_BUF->srcipaddr));
+
+#if RPL_CONF_DAO_ACK
+  instance = rpl_get_instance(instance_id);
+  if(instance == NULL || status >= 128) {
+    /* Unknown instance, or the parent rejected the DAO. */
+    return;
+  }
+
+  seq = instance->dao_seq_first;
+  for(i = 0; i < instance->dao_seq_count; i++) {
+    if(seq == sequence) {
+      instance->dao_ack_pending &= ~(1UL << i);
+      if(instance->dao_ack_pending == 0) {
+        rpl_dao_acked(instance);
+      }
+      break;
+    }
+    RPL_LOLLIPOP_INCREMENT(seq);
+  }
+#endif /* RPL_CONF_DAO_ACK */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -837,6 +1064,8 @@ dao_ack_output(rpl_instance_t *instance, uip_ipaddr_t *dest, uint8_t sequence)
   buffer[2] = sequence;
   buffer[3] = 0;
 
+  RPL_STAT(rpl_stats.dao_ack_out++);
+  RPL_TRACE(RPL_TRACE_DAO_ACK_OUT, RPL_TRACE_ADDR(dest));
   uip_icmp6_send(dest, ICMP6_RPL, RPL_CODE_DAO_ACK, 4);
 }
 /*---------------------------------------------------------------------------*/
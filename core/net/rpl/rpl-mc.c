@@ -0,0 +1,282 @@
+/**
+ * \addtogroup uip6
+ * @{
+ */
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+/**
+ * \file
+ *         Encoding and decoding of DAG Metric Containers (RFC 6551)
+ *         carrying one or more metric objects.
+ */
+
+#include "net/rpl/rpl-private.h"
+
+#include <string.h>
+
+#define DEBUG DEBUG_NONE
+#include "net/uip-debug.h"
+
+/*---------------------------------------------------------------------------*/
+/* Returns the length of the object body, or 0 for unsupported objects. */
+static uint8_t
+object_length(uint8_t type)
+{
+  switch(type) {
+  case RPL_DAG_MC_ETX:
+    return 2;
+  case RPL_DAG_MC_ENERGY:
+    return 2;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  case RPL_DAG_MC_LATENCY:
+    return 4;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+  default:
+    return 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+encode_object(unsigned char *buffer, uint8_t type, uint8_t flags,
+              uint8_t aggr, uint8_t prec, union metric_object *obj)
+{
+  int pos;
+  uint8_t length;
+
+  length = object_length(type);
+  if(length == 0) {
+    PRINTF("RPL: Unable to encode DAG MC object of type %u\n", (unsigned)type);
+    return -1;
+  }
+
+  pos = 0;
+  buffer[pos++] = type;
+  buffer[pos++] = flags >> 1;
+  buffer[pos] = (flags & 1) << 7;
+  buffer[pos++] |= (aggr << 4) | prec;
+  buffer[pos++] = length;
+
+  switch(type) {
+  case RPL_DAG_MC_ETX:
+    buffer[pos++] = obj->etx >> 8;
+    buffer[pos++] = obj->etx & 0xff;
+    break;
+  case RPL_DAG_MC_ENERGY:
+    buffer[pos++] = obj->energy.flags;
+    buffer[pos++] = obj->energy.energy_est;
+    break;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  case RPL_DAG_MC_LATENCY:
+    buffer[pos++] = obj->latency >> 24;
+    buffer[pos++] = (obj->latency >> 16) & 0xff;
+    buffer[pos++] = (obj->latency >> 8) & 0xff;
+    buffer[pos++] = obj->latency & 0xff;
+    break;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+  }
+
+  return pos;
+}
+/*---------------------------------------------------------------------------*/
+static void
+decode_object(unsigned char *buffer, uint8_t type, union metric_object *obj)
+{
+  switch(type) {
+  case RPL_DAG_MC_ETX:
+    obj->etx = (uint16_t)buffer[0] << 8 | buffer[1];
+    break;
+  case RPL_DAG_MC_ENERGY:
+    obj->energy.flags = buffer[0];
+    obj->energy.energy_est = buffer[1];
+    break;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  case RPL_DAG_MC_LATENCY:
+    obj->latency = (uint32_t)buffer[0] << 24 | (uint32_t)buffer[1] << 16 |
+                   (uint32_t)buffer[2] << 8 | buffer[3];
+    break;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+rpl_mc_encode(unsigned char *buffer, rpl_metric_container_t *mc)
+{
+  int pos;
+  int len;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  int i;
+  struct rpl_metric_object *o;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  if(mc->type == RPL_DAG_MC_NONE) {
+    return 0;
+  }
+
+  /* The option header is filled in when the length is known. */
+  pos = 2;
+
+  len = encode_object(&buffer[pos], mc->type, mc->flags, mc->aggr,
+                      mc->prec, &mc->obj);
+  if(len < 0) {
+    return -1;
+  }
+  pos += len;
+
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  for(i = 0; i < mc->extra_count; i++) {
+    o = &mc->extra[i];
+    len = encode_object(&buffer[pos], o->type, o->flags, o->aggr,
+                        o->prec, &o->obj);
+    if(len < 0) {
+      return -1;
+    }
+    pos += len;
+  }
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  buffer[0] = RPL_OPTION_DAG_METRIC_CONTAINER;
+  buffer[1] = pos - 2;
+
+  return pos;
+}
+/*---------------------------------------------------------------------------*/
+int
+rpl_mc_decode(unsigned char *buffer, int len, rpl_metric_container_t *mc)
+{
+  int pos;
+  uint8_t type;
+  uint8_t flags;
+  uint8_t aggr;
+  uint8_t prec;
+  uint8_t length;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  struct rpl_metric_object *o;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  memset(mc, 0, sizeof(*mc));
+  mc->type = RPL_DAG_MC_NONE;
+
+  for(pos = 0; pos + 4 <= len; pos += 4 + length) {
+    type = buffer[pos];
+    flags = buffer[pos + 1] << 1;
+    flags |= buffer[pos + 2] >> 7;
+    aggr = (buffer[pos + 2] >> 4) & 0x3;
+    prec = buffer[pos + 2] & 0xf;
+    length = buffer[pos + 3];
+
+    if(pos + 4 + length > len) {
+      PRINTF("RPL: Invalid DAG MC object, len = %d\n", len);
+      return -1;
+    }
+
+    if(object_length(type) == 0 || object_length(type) != length) {
+      /* Unknown objects are skipped. */
+      PRINTF("RPL: Unhandled DAG MC type: %u\n", (unsigned)type);
+      continue;
+    }
+
+    if(mc->type == RPL_DAG_MC_NONE) {
+      mc->type = type;
+      mc->flags = flags;
+      mc->aggr = aggr;
+      mc->prec = prec;
+      mc->length = length;
+      decode_object(&buffer[pos + 4], type, &mc->obj);
+      PRINTF("RPL: DAG MC: type %u, flags %u, aggr %u, prec %u, length %u\n",
+             (unsigned)type, (unsigned)flags, (unsigned)aggr,
+             (unsigned)prec, (unsigned)length);
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+    } else if(mc->extra_count < RPL_DAG_MC_MAX_OBJECTS - 1) {
+      o = &mc->extra[mc->extra_count++];
+      o->type = type;
+      o->flags = flags;
+      o->aggr = aggr;
+      o->prec = prec;
+      decode_object(&buffer[pos + 4], type, &o->obj);
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+    } else {
+      PRINTF("RPL: No room for DAG MC object of type %u\n", (unsigned)type);
+    }
+  }
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+union metric_object *
+rpl_mc_find(rpl_metric_container_t *mc, uint8_t type)
+{
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  int i;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  if(mc->type == type) {
+    return &mc->obj;
+  }
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  for(i = 0; i < mc->extra_count; i++) {
+    if(mc->extra[i].type == type) {
+      return &mc->extra[i].obj;
+    }
+  }
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+union metric_object *
+rpl_mc_add(rpl_metric_container_t *mc, uint8_t type, uint8_t flags,
+           uint8_t aggr)
+{
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  struct rpl_metric_object *o;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  if(mc->type == RPL_DAG_MC_NONE) {
+    mc->type = type;
+    mc->flags = flags;
+    mc->aggr = aggr;
+    mc->prec = 0;
+    mc->length = object_length(type);
+    return &mc->obj;
+  }
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  if(mc->extra_count < RPL_DAG_MC_MAX_OBJECTS - 1) {
+    o = &mc->extra[mc->extra_count++];
+    o->type = type;
+    o->flags = flags;
+    o->aggr = aggr;
+    o->prec = 0;
+    return &o->obj;
+  }
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
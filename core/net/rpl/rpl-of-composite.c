@@ -0,0 +1,391 @@
+/**
+ * \addtogroup uip6
+ * @{
+ */
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+/**
+ * \file
+ *         A composite objective function that selects parents by a
+ *         weighted sum of path ETX, residual energy and latency.
+ *
+ *         The DIOs carry one metric object per metric, so nodes using this
+ *         objective function should set RPL_CONF_DAG_MC_MAX_OBJECTS to 3.
+ *         With fewer objects, the metrics that do not fit are not
+ *         advertised and count as zero.
+ *
+ *         Residual energy is estimated from the radio duty cycle measured
+ *         by Energest unless a platform provides its own estimate through
+ *         RPL_OF_COMPOSITE_CONF_NODE_ENERGY(). Latency is estimated from
+ *         the link ETX and a per-transmission latency.
+ */
+
+#include "net/rpl/rpl-private.h"
+#include "net/neighbor-info.h"
+#include "sys/energest.h"
+
+#include <limits.h>
+
+#define DEBUG DEBUG_NONE
+#include "net/uip-debug.h"
+
+static void reset(rpl_dag_t *);
+static rpl_parent_t *best_parent(rpl_parent_t *, rpl_parent_t *);
+static rpl_dag_t *best_dag(rpl_dag_t *, rpl_dag_t *);
+static rpl_rank_t calculate_rank(rpl_parent_t *, rpl_rank_t);
+static void update_metric_container(rpl_instance_t *);
+
+/* The objective code point is not assigned by IANA. All nodes in a DAG
+   must use the same value. */
+#ifdef RPL_OF_COMPOSITE_CONF_OCP
+#define RPL_OF_COMPOSITE_OCP RPL_OF_COMPOSITE_CONF_OCP
+#else
+#define RPL_OF_COMPOSITE_OCP 2
+#endif
+
+rpl_of_t rpl_of_composite = {
+  reset,
+  NULL,
+  best_parent,
+  best_dag,
+  calculate_rank,
+  update_metric_container,
+  RPL_OF_COMPOSITE_OCP
+};
+
+/*
+ * Weights of the path metrics. The metrics are first brought to the
+ * scale of the path ETX, in 1/RPL_DAG_MC_ETX_DIVISOR units: latency
+ * counts in link-layer transmissions of TX_LATENCY each, and a path
+ * through a node with no energy left costs ENERGY_COST transmissions.
+ * The path cost is the weighted mean of the three.
+ */
+#ifdef RPL_OF_COMPOSITE_CONF_W_ETX
+#define W_ETX RPL_OF_COMPOSITE_CONF_W_ETX
+#else
+#define W_ETX 1
+#endif
+
+#ifdef RPL_OF_COMPOSITE_CONF_W_ENERGY
+#define W_ENERGY RPL_OF_COMPOSITE_CONF_W_ENERGY
+#else
+#define W_ENERGY 1
+#endif
+
+#ifdef RPL_OF_COMPOSITE_CONF_W_LATENCY
+#define W_LATENCY RPL_OF_COMPOSITE_CONF_W_LATENCY
+#else
+#define W_LATENCY 1
+#endif
+
+/* Latency of a single link-layer transmission, in microseconds. */
+#ifdef RPL_OF_COMPOSITE_CONF_TX_LATENCY
+#define TX_LATENCY RPL_OF_COMPOSITE_CONF_TX_LATENCY
+#else
+#define TX_LATENCY 8000UL
+#endif
+
+/* Cost of a path through a drained node, in transmissions. */
+#ifdef RPL_OF_COMPOSITE_CONF_ENERGY_COST
+#define ENERGY_COST RPL_OF_COMPOSITE_CONF_ENERGY_COST
+#else
+#define ENERGY_COST 10
+#endif
+
+#ifdef RPL_OF_COMPOSITE_CONF_NODE_ENERGY
+#define NODE_ENERGY() RPL_OF_COMPOSITE_CONF_NODE_ENERGY()
+#else
+#define NODE_ENERGY() node_energy()
+#endif
+
+#define NI_ETX_TO_RPL_ETX(etx)						\
+	((etx) * (RPL_DAG_MC_ETX_DIVISOR / NEIGHBOR_INFO_ETX_DIVISOR))
+
+/* Reject parents that have a higher path ETX than the following. */
+#define MAX_PATH_COST			100
+
+/* The latency advertised without a path, in microseconds. */
+#define MAX_PATH_LATENCY		(MAX_PATH_COST * TX_LATENCY)
+
+/* A parent must be this much cheaper to replace the preferred parent. */
+#define PARENT_SWITCH_THRESHOLD		(RPL_DAG_MC_ETX_DIVISOR / 2)
+
+#define MAX_ENERGY			255
+
+/*---------------------------------------------------------------------------*/
+#ifndef RPL_OF_COMPOSITE_CONF_NODE_ENERGY
+/* Estimates the residual energy from the share of time the radio was on. */
+static uint8_t
+node_energy(void)
+{
+  unsigned long radio;
+  unsigned long total;
+
+  energest_flush();
+  radio = energest_type_time(ENERGEST_TYPE_LISTEN) +
+          energest_type_time(ENERGEST_TYPE_TRANSMIT);
+  total = energest_type_time(ENERGEST_TYPE_CPU) +
+          energest_type_time(ENERGEST_TYPE_LPM);
+
+  if(total == 0) {
+    return MAX_ENERGY;
+  }
+  if(radio >= total) {
+    return 0;
+  }
+  while(total > ULONG_MAX / MAX_ENERGY) {
+    radio >>= 1;
+    total >>= 1;
+  }
+  return MAX_ENERGY - (uint8_t)(radio * MAX_ENERGY / total);
+}
+#endif /* RPL_OF_COMPOSITE_CONF_NODE_ENERGY */
+/*---------------------------------------------------------------------------*/
+static uint16_t
+path_etx(rpl_parent_t *p)
+{
+  union metric_object *o;
+
+  o = rpl_mc_find(&p->mc, RPL_DAG_MC_ETX);
+  if(o == NULL || (o->etx == 0 && p->rank > ROOT_RANK(p->dag->instance))) {
+    return MAX_PATH_COST * RPL_DAG_MC_ETX_DIVISOR;
+  }
+  return o->etx + NI_ETX_TO_RPL_ETX(p->link_metric);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+path_energy(rpl_parent_t *p)
+{
+  union metric_object *o;
+
+  o = rpl_mc_find(&p->mc, RPL_DAG_MC_ENERGY);
+  return o == NULL ? MAX_ENERGY : o->energy.energy_est;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+path_latency(rpl_parent_t *p)
+{
+  uint32_t latency;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  union metric_object *o;
+
+  o = rpl_mc_find(&p->mc, RPL_DAG_MC_LATENCY);
+  latency = o == NULL ? 0 : o->latency;
+#else
+  latency = 0;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+  return latency + (uint32_t)p->link_metric * TX_LATENCY /
+                   NEIGHBOR_INFO_ETX_DIVISOR;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+path_cost(rpl_parent_t *p)
+{
+  uint32_t energy;
+  uint32_t latency;
+
+  if(p == NULL) {
+    return UINT32_MAX;
+  }
+  energy = (uint32_t)(MAX_ENERGY - path_energy(p)) *
+    ENERGY_COST * RPL_DAG_MC_ETX_DIVISOR / MAX_ENERGY;
+  latency = path_latency(p);
+  if(latency > MAX_PATH_LATENCY) {
+    latency = MAX_PATH_LATENCY;
+  }
+  latency = latency * RPL_DAG_MC_ETX_DIVISOR / TX_LATENCY;
+  return ((uint32_t)W_ETX * path_etx(p) + W_ENERGY * energy +
+          W_LATENCY * latency) / (W_ETX + W_ENERGY + W_LATENCY);
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset(rpl_dag_t *dag)
+{
+}
+/*---------------------------------------------------------------------------*/
+static rpl_rank_t
+calculate_rank(rpl_parent_t *p, rpl_rank_t base_rank)
+{
+  rpl_rank_t new_rank;
+  rpl_rank_t rank_increase;
+
+  if(p == NULL) {
+    if(base_rank == 0) {
+      return INFINITE_RANK;
+    }
+    rank_increase = NEIGHBOR_INFO_FIX2ETX(INITIAL_LINK_METRIC) * DEFAULT_MIN_HOPRANKINC;
+  } else {
+    rank_increase = NEIGHBOR_INFO_FIX2ETX(p->link_metric) * p->dag->instance->min_hoprankinc;
+    if(base_rank == 0) {
+      base_rank = p->rank;
+    }
+  }
+
+  if(INFINITE_RANK - base_rank < rank_increase) {
+    /* Reached the maximum rank. */
+    new_rank = INFINITE_RANK;
+  } else {
+    new_rank = base_rank + rank_increase;
+  }
+
+  return new_rank;
+}
+/*---------------------------------------------------------------------------*/
+static rpl_dag_t *
+best_dag(rpl_dag_t *d1, rpl_dag_t *d2)
+{
+  if(d1->grounded) {
+    if (!d2->grounded) {
+      return d1;
+    }
+  } else if(d2->grounded) {
+    return d2;
+  }
+
+  if(d1->preference < d2->preference) {
+    return d2;
+  } else {
+    if(d1->preference > d2->preference) {
+      return d1;
+    }
+  }
+
+  if(d2->rank < d1->rank) {
+    return d2;
+  } else {
+    return d1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static rpl_parent_t *
+best_parent(rpl_parent_t *p1, rpl_parent_t *p2)
+{
+  rpl_dag_t *dag;
+  uint32_t p1_cost;
+  uint32_t p2_cost;
+
+  dag = p1->dag; /* Both parents must be in the same DAG. */
+
+  /* A parent beyond MAX_PATH_COST is only taken if there is no other. */
+  if(path_etx(p1) >= MAX_PATH_COST * RPL_DAG_MC_ETX_DIVISOR &&
+     path_etx(p2) < MAX_PATH_COST * RPL_DAG_MC_ETX_DIVISOR) {
+    return p2;
+  }
+  if(path_etx(p2) >= MAX_PATH_COST * RPL_DAG_MC_ETX_DIVISOR &&
+     path_etx(p1) < MAX_PATH_COST * RPL_DAG_MC_ETX_DIVISOR) {
+    return p1;
+  }
+
+  p1_cost = path_cost(p1);
+  p2_cost = path_cost(p2);
+
+  /* Maintain stability of the preferred parent in case of similar costs. */
+  if(p1 == dag->preferred_parent || p2 == dag->preferred_parent) {
+    if(p1_cost < p2_cost + PARENT_SWITCH_THRESHOLD &&
+       p1_cost + PARENT_SWITCH_THRESHOLD > p2_cost) {
+      PRINTF("RPL: Composite OF hysteresis: %lu ~ %lu\n",
+             (unsigned long)p1_cost, (unsigned long)p2_cost);
+      return dag->preferred_parent;
+    }
+  }
+
+  return p1_cost < p2_cost ? p1 : p2;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_metric_container(rpl_instance_t *instance)
+{
+  rpl_dag_t *dag;
+  rpl_parent_t *p;
+  union metric_object *o;
+  uint8_t energy;
+
+  dag = instance->current_dag;
+
+  if (!dag->joined) {
+    return;
+  }
+
+  p = dag->preferred_parent;
+
+  instance->mc.type = RPL_DAG_MC_NONE;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  instance->mc.extra_count = 0;
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  o = rpl_mc_add(&instance->mc, RPL_DAG_MC_ETX, RPL_DAG_MC_FLAG_P,
+                 RPL_DAG_MC_AGGR_ADDITIVE);
+  if(o != NULL) {
+    if(dag->rank == ROOT_RANK(instance)) {
+      o->etx = 0;
+    } else if(p == NULL) {
+      /* No parent, e.g. during local repair: advertise the worst path. */
+      o->etx = MAX_PATH_COST * RPL_DAG_MC_ETX_DIVISOR;
+    } else {
+      o->etx = path_etx(p);
+    }
+  }
+
+  o = rpl_mc_add(&instance->mc, RPL_DAG_MC_ENERGY, RPL_DAG_MC_FLAG_P,
+                 RPL_DAG_MC_AGGR_MINIMUM);
+  if(o != NULL) {
+    energy = NODE_ENERGY();
+    if(dag->rank == ROOT_RANK(instance)) {
+      o->energy.flags = RPL_DAG_MC_ENERGY_TYPE_MAINS << RPL_DAG_MC_ENERGY_TYPE;
+      energy = MAX_ENERGY;
+    } else {
+      o->energy.flags = RPL_DAG_MC_ENERGY_TYPE_BATTERY << RPL_DAG_MC_ENERGY_TYPE;
+      if(p != NULL && path_energy(p) < energy) {
+        energy = path_energy(p);
+      }
+    }
+    o->energy.energy_est = energy;
+  }
+
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  o = rpl_mc_add(&instance->mc, RPL_DAG_MC_LATENCY, RPL_DAG_MC_FLAG_P,
+                 RPL_DAG_MC_AGGR_ADDITIVE);
+  if(o != NULL) {
+    if(dag->rank == ROOT_RANK(instance)) {
+      o->latency = 0;
+    } else if(p == NULL) {
+      /* As for the ETX, advertise the worst path. */
+      o->latency = MAX_PATH_LATENCY;
+    } else {
+      o->latency = path_latency(p);
+    }
+  }
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+
+  PRINTF("RPL: Composite OF path cost %lu\n",
+         (unsigned long)(p == NULL ? 0 : path_cost(p)));
+}
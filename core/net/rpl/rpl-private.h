@@ -114,10 +114,18 @@
 #define ZERO_LIFETIME                   0
 
 /* Default route lifetime unit. */
+#ifdef RPL_CONF_DEFAULT_LIFETIME_UNIT
+#define RPL_DEFAULT_LIFETIME_UNIT       RPL_CONF_DEFAULT_LIFETIME_UNIT
+#else
 #define RPL_DEFAULT_LIFETIME_UNIT       0xffff
+#endif
 
 /* Default route lifetime as a multiple of the lifetime unit. */
-#define RPL_DEFAULT_LIFETIME        0xff
+#ifdef RPL_CONF_DEFAULT_LIFETIME
+#define RPL_DEFAULT_LIFETIME            RPL_CONF_DEFAULT_LIFETIME
+#else
+#define RPL_DEFAULT_LIFETIME            0xff
+#endif
 
 #define RPL_LIFETIME(instance, lifetime) \
           (((unsigned long)(instance)->lifetime_unit) * lifetime)
@@ -167,6 +175,68 @@
 
 /* Expire DAOs from neighbors that do not respond in this time. (seconds) */
 #define DAO_EXPIRATION_TIMEOUT          60
+
+/*
+ * Upper bound on the ICMPv6 payload of an outgoing DAO. Targets are packed
+ * into the same message until the next one would exceed this size. The
+ * DAO base object takes 4 bytes (20 with the DODAGID), a target with a
+ * full address 20 bytes, and each run of targets with the same lifetime
+ * shares a 6-byte transit information option.
+ *
+ * By default a DAO fills one 802.15.4 frame: the 102 bytes of MAC payload
+ * left for 6LoWPAN, less up to 4 bytes of compressed IPv6 header between
+ * link-local addresses and the ICMPv6 header. This fits four targets.
+ * With 6LoWPAN fragmentation the bound may be raised up to the link MTU,
+ * at the cost of resending the whole DAO when one fragment is lost.
+ */
+#ifdef RPL_CONF_DAO_MAX_PAYLOAD
+#define RPL_DAO_MAX_PAYLOAD             RPL_CONF_DAO_MAX_PAYLOAD
+#else
+#define RPL_DAO_MAX_PAYLOAD             (102 - 4 - UIP_ICMPH_LEN)
+#endif
+#if RPL_DAO_MAX_PAYLOAD > UIP_LINK_MTU - UIP_IPH_LEN - UIP_ICMPH_LEN
+#error "RPL_CONF_DAO_MAX_PAYLOAD does not fit in the link MTU"
+#endif
+
+/*
+ * In storing mode, advertise the targets of our sub-DODAG in our own
+ * (batched) DAOs instead of forwarding every DAO received from a child.
+ */
+#ifdef RPL_CONF_DAO_AGGREGATE
+#define RPL_DAO_AGGREGATE               RPL_CONF_DAO_AGGREGATE
+#else
+#define RPL_DAO_AGGREGATE               0
+#endif
+
+/* Time to wait for a DAO-ACK before the DAOs are sent again. */
+#ifdef RPL_CONF_DAO_RETRANSMISSION_TIMEOUT
+#define RPL_DAO_RETRANSMISSION_TIMEOUT  RPL_CONF_DAO_RETRANSMISSION_TIMEOUT
+#else
+#define RPL_DAO_RETRANSMISSION_TIMEOUT  (CLOCK_SECOND * 5)
+#endif
+
+/* Number of times unacknowledged DAOs are sent again before giving up. */
+#ifdef RPL_CONF_DAO_MAX_RETRANSMISSIONS
+#define RPL_DAO_MAX_RETRANSMISSIONS     RPL_CONF_DAO_MAX_RETRANSMISSIONS
+#else
+#define RPL_DAO_MAX_RETRANSMISSIONS     3
+#endif
+
+/*
+ * When the preferred parent is reported lost by the link layer
+ * (see NEIGHBOR_INFO_CONF_NOACK_LIMIT), RPL_CONF_REROUTE_QUEUED names a
+ * function that moves the packets still queued for the lost parent to
+ * the new one, e.g., csma_reroute. RPL declares the function itself, so
+ * it must have this prototype:
+ *
+ *   int f(const rimeaddr_t *from, const rimeaddr_t *to);
+ */
+#ifdef RPL_CONF_REROUTE_QUEUED
+int RPL_CONF_REROUTE_QUEUED(const rimeaddr_t *from, const rimeaddr_t *to);
+#define RPL_REROUTE_QUEUED(from, to)    RPL_CONF_REROUTE_QUEUED(from, to)
+#else
+#define RPL_REROUTE_QUEUED(from, to)
+#endif
 /*---------------------------------------------------------------------------*/
 #define RPL_INSTANCE_LOCAL_FLAG         0x80
 #define RPL_INSTANCE_D_FLAG             0x40
@@ -245,20 +315,6 @@ struct rpl_dio {
 };
 typedef struct rpl_dio rpl_dio_t;
 
-#if RPL_CONF_STATS
-/* Statistics for fault management. */
-struct rpl_stats {
-  uint16_t mem_overflows;
-  uint16_t local_repairs;
-  uint16_t global_repairs;
-  uint16_t malformed_msgs;
-  uint16_t resets;
-  uint16_t parent_switch;
-};
-typedef struct rpl_stats rpl_stats_t;
-
-extern rpl_stats_t rpl_stats;
-#endif
 /*---------------------------------------------------------------------------*/
 /* RPL macros. */
 
@@ -267,6 +323,17 @@ extern rpl_stats_t rpl_stats;
 #else
 #define RPL_STAT(code)
 #endif /* RPL_CONF_STATS */
+
+#if RPL_TRACE_EVENTS
+void rpl_trace(uint8_t type, uint16_t arg);
+#define RPL_TRACE(type, arg)	rpl_trace(type, arg)
+#else
+#define RPL_TRACE(type, arg)
+#endif /* RPL_TRACE_EVENTS */
+
+/* The node identifier used in trace events: the last two address bytes. */
+#define RPL_TRACE_ADDR(addr)	\
+  (((uint16_t)(addr)->u8[14] << 8) | (addr)->u8[15])
 /*---------------------------------------------------------------------------*/
 /* Instances */
 extern rpl_instance_t instance_table[];
@@ -278,6 +345,11 @@ void dio_output(rpl_instance_t *, uip_ipaddr_t *uc_addr);
 void dao_output(rpl_parent_t *, uint8_t lifetime, uip_ipaddr_t *);
 void dao_ack_output(rpl_instance_t *, uip_ipaddr_t *, uint8_t);
 
+/* Batched DAO construction: several targets per DAO message. */
+void dao_batch_start(rpl_parent_t *);
+void dao_batch_add(uip_ipaddr_t *target, uint8_t prefixlen, uint8_t lifetime);
+void dao_batch_flush(void);
+
 /* RPL logic functions. */
 void rpl_join_dag(uip_ipaddr_t *from, rpl_dio_t *dio);
 void rpl_join_instance(uip_ipaddr_t *from, rpl_dio_t *dio);
@@ -292,6 +364,7 @@ void rpl_free_dodag(rpl_dag_t *);
 void rpl_free_instance(rpl_instance_t *);
 
 /* DAG parent management function. */
+void rpl_dag_init(void);
 rpl_parent_t *rpl_add_parent(rpl_dag_t *, rpl_dio_t *dio, uip_ipaddr_t *);
 rpl_parent_t *rpl_find_parent(rpl_dag_t *, uip_ipaddr_t *);
 rpl_parent_t * rpl_find_parent_any_dag(rpl_instance_t *instance, uip_ipaddr_t *addr);
@@ -313,10 +386,21 @@ void rpl_purge_routes(void);
 /* Objective function. */
 rpl_of_t *rpl_find_of(rpl_ocp_t);
 
+/* DAG Metric Container encoding and decoding. */
+int rpl_mc_encode(unsigned char *buffer, rpl_metric_container_t *mc);
+int rpl_mc_decode(unsigned char *buffer, int len, rpl_metric_container_t *mc);
+union metric_object *rpl_mc_find(rpl_metric_container_t *mc, uint8_t type);
+union metric_object *rpl_mc_add(rpl_metric_container_t *mc, uint8_t type,
+                                uint8_t flags, uint8_t aggr);
+
 /* Timer functions. */
 void rpl_schedule_dao(rpl_instance_t *);
+void rpl_schedule_dao_immediately(rpl_instance_t *);
 void rpl_reset_dio_timer(rpl_instance_t *, uint8_t);
 void rpl_reset_periodic_timer(void);
+#if RPL_CONF_DAO_ACK
+void rpl_dao_acked(rpl_instance_t *);
+#endif /* RPL_CONF_DAO_ACK */
 
 /* Route poisoning. */
 void rpl_poison_routes(rpl_dag_t *, rpl_parent_t *);
@@ -45,6 +45,8 @@
 #include "lib/random.h"
 #include "sys/ctimer.h"
 
+#include <limits.h>
+
 #define DEBUG DEBUG_NONE
 #include "net/uip-debug.h"
 
@@ -60,6 +62,10 @@ static uint16_t next_dis;
 /* dio_send_ok is true if the node is ready to send DIOs */
 static uint8_t dio_send_ok;
 
+#if RPL_DAO_AGGREGATE
+extern uip_ds6_route_t uip_ds6_routing_table[UIP_DS6_ROUTE_NB];
+#endif /* RPL_DAO_AGGREGATE */
+
 #if UIP_IPV6_MULTICAST_RPL
 extern uip_ds6_mcastrt_t uip_ds6_mcast_table[UIP_DS6_MCAST_ROUTES];
 static uint8_t i;
@@ -189,17 +195,35 @@ rpl_reset_dio_timer(rpl_instance_t *instance, uint8_t force)
     instance->dio_counter = 0;
     instance->dio_intcurrent = instance->dio_intmin;
     new_dio_interval(instance);
+    RPL_STAT(rpl_stats.resets++);
+    RPL_TRACE(RPL_TRACE_TRICKLE_RESET, instance->instance_id);
   }
-#if RPL_CONF_STATS
-  rpl_stats.resets++;
-#endif /* RPL_CONF_STATS */
 #endif /* RPL_LEAF_ONLY */
 }
 /************************************************************************/
+#if RPL_DAO_AGGREGATE
+/* The remaining lifetime of a route, in lifetime units, rounded up. */
+static uint8_t
+route_lifetime(rpl_instance_t *instance, uip_ds6_route_t *r)
+{
+  unsigned long units;
+
+  if(instance->lifetime_unit == 0) {
+    return instance->default_lifetime;
+  }
+  units = (r->state.lifetime + instance->lifetime_unit - 1) /
+    instance->lifetime_unit;
+  return units > 0xff ? 0xff : units;
+}
+#endif /* RPL_DAO_AGGREGATE */
+/************************************************************************/
 static void
 handle_dao_timer(void *ptr)
 {
   rpl_instance_t *instance;
+#if RPL_DAO_AGGREGATE
+  uip_ds6_route_t *r;
+#endif /* RPL_DAO_AGGREGATE */
 
   instance = (rpl_instance_t *)ptr;
 
@@ -212,16 +236,33 @@ handle_dao_timer(void *ptr)
   /* Send the DAO to the DAO parent set -- the preferred parent in our case. */
   if(instance->current_dag->preferred_parent != NULL) {
     PRINTF("RPL: handle_dao_timer - sending DAO\n");
+    /* Pack all our targets into as few DAOs as possible. */
+    dao_batch_start(instance->current_dag->preferred_parent);
     /* Set the route lifetime to the default value. */
-    dao_output(instance->current_dag->preferred_parent, instance->default_lifetime, NULL);
+    dao_batch_add(NULL, sizeof(uip_ipaddr_t) * CHAR_BIT,
+                  instance->default_lifetime);
+#if RPL_DAO_AGGREGATE
+    /* Advertise the targets of our sub-DODAG on behalf of our children,
+       with what is left of the lifetimes they gave. Routes that a
+       No-Path DAO has set to expire are advertised as No-Path too. */
+    for(r = uip_ds6_routing_table;
+        r < uip_ds6_routing_table + UIP_DS6_ROUTE_NB; r++) {
+      if(r->isused && r->state.dag == instance->current_dag
+          && r->state.learned_from == RPL_ROUTE_FROM_UNICAST_DAO) {
+        dao_batch_add(&r->ipaddr, r->length,
+                      r->state.saved_lifetime != 0 ? ZERO_LIFETIME :
+                      route_lifetime(instance, r));
+      }
+    }
+#endif /* RPL_DAO_AGGREGATE */
 #if UIP_IPV6_MULTICAST_RPL
     if(instance->mop == RPL_MOP_STORING_MULTICAST) {
       /* Send a DAO for own multicast addresses */
       for(i = 0; i < UIP_DS6_MADDR_NB; i++) {
         if(uip_ds6_if.maddr_list[i].isused
             && uip_is_addr_mcast_global(&uip_ds6_if.maddr_list[i].ipaddr)) {
-          dao_output(instance->current_dag->preferred_parent, RPL_MCAST_LIFETIME,
-              &uip_ds6_if.maddr_list[i].ipaddr);
+          dao_batch_add(&uip_ds6_if.maddr_list[i].ipaddr,
+              sizeof(uip_ipaddr_t) * CHAR_BIT, RPL_MCAST_LIFETIME);
         }
       }
       /* Iterate multicast routes and send DAOs */
@@ -229,19 +270,56 @@ handle_dao_timer(void *ptr)
         /* Don't send if it's also our own address, done that already */
         if(uip_ds6_mcast_table[i].isused) {
           if(uip_ds6_maddr_lookup(&uip_ds6_mcast_table[i].group) == NULL) {
-            dao_output(instance->current_dag->preferred_parent, RPL_MCAST_LIFETIME,
-                &uip_ds6_mcast_table[i].group);
+            dao_batch_add(&uip_ds6_mcast_table[i].group,
+                sizeof(uip_ipaddr_t) * CHAR_BIT, RPL_MCAST_LIFETIME);
           }
         }
       }
     }
 #endif
+    dao_batch_flush();
+#if RPL_CONF_DAO_ACK
+    if(instance->dao_ack_pending != 0) {
+      if(instance->dao_retransmissions < RPL_DAO_MAX_RETRANSMISSIONS) {
+        instance->dao_retransmissions++;
+        PRINTF("RPL: Waiting for DAO ACK (attempt %u)\n",
+               instance->dao_retransmissions);
+        ctimer_set(&instance->dao_timer, RPL_DAO_RETRANSMISSION_TIMEOUT,
+                   handle_dao_timer, instance);
+        return;
+      }
+      PRINTF("RPL: No DAO ACK received, giving up\n");
+    }
+    instance->dao_retransmissions = 0;
+#endif /* RPL_CONF_DAO_ACK */
   } else {
     PRINTF("RPL: No suitable DAO parent\n");
   }
   ctimer_stop(&instance->dao_timer);
 }
 /************************************************************************/
+#if RPL_CONF_DAO_ACK
+/* Called when every DAO of the current round has been acknowledged. */
+void
+rpl_dao_acked(rpl_instance_t *instance)
+{
+  if(instance->dao_retransmissions > 0) {
+    PRINTF("RPL: All DAOs acknowledged\n");
+    instance->dao_retransmissions = 0;
+    ctimer_stop(&instance->dao_timer);
+  }
+}
+#endif /* RPL_CONF_DAO_ACK */
+/************************************************************************/
+void
+rpl_schedule_dao_immediately(rpl_instance_t *instance)
+{
+#if RPL_CONF_DAO_ACK
+  instance->dao_retransmissions = 0;
+#endif /* RPL_CONF_DAO_ACK */
+  ctimer_set(&instance->dao_timer, 0, handle_dao_timer, instance);
+}
+/************************************************************************/
 void
 rpl_schedule_dao(rpl_instance_t *instance)
 {
@@ -249,9 +327,17 @@ rpl_schedule_dao(rpl_instance_t *instance)
 
   expiration_time = etimer_expiration_time(&instance->dao_timer.etimer);
 
-  if(!etimer_expired(&instance->dao_timer.etimer)) {
+  /* A pending DAO retransmission is superseded by a new round. */
+  if(!etimer_expired(&instance->dao_timer.etimer)
+#if RPL_CONF_DAO_ACK
+     && instance->dao_retransmissions == 0
+#endif /* RPL_CONF_DAO_ACK */
+    ) {
     PRINTF("RPL: DAO timer already scheduled\n");
   } else {
+#if RPL_CONF_DAO_ACK
+    instance->dao_retransmissions = 0;
+#endif /* RPL_CONF_DAO_ACK */
     expiration_time = DEFAULT_DAO_LATENCY / 2 +
       (random_rand() % (DEFAULT_DAO_LATENCY));
     PRINTF("RPL: Scheduling DAO timer %u ticks in the future\n",
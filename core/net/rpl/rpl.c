@@ -56,6 +56,12 @@
 rpl_stats_t rpl_stats;
 #endif
 
+#if RPL_TRACE_EVENTS
+static struct rpl_trace_event trace_events[RPL_TRACE_EVENTS];
+static uint16_t trace_next;
+static uint16_t trace_count;
+#endif /* RPL_TRACE_EVENTS */
+
 /************************************************************************/
 extern uip_ds6_route_t uip_ds6_routing_table[UIP_DS6_ROUTE_NB];
 #if UIP_IPV6_MULTICAST_RPL
@@ -70,6 +76,9 @@ rpl_purge_routes(void)
   for(i = 0; i < UIP_DS6_ROUTE_NB; i++) {
     if(uip_ds6_routing_table[i].isused) {
       if(uip_ds6_routing_table[i].state.lifetime <= 1) {
+        RPL_STAT(rpl_stats.routes_removed++);
+        RPL_TRACE(RPL_TRACE_ROUTE_REMOVE,
+                  RPL_TRACE_ADDR(&uip_ds6_routing_table[i].ipaddr));
         uip_ds6_route_rm(&uip_ds6_routing_table[i]);
       } else {
         uip_ds6_routing_table[i].state.lifetime--;
@@ -96,7 +105,11 @@ rpl_remove_routes(rpl_dag_t *dag)
   int i;
 
   for(i = 0; i < UIP_DS6_ROUTE_NB; i++) {
-    if(uip_ds6_routing_table[i].state.dag == dag) {
+    if(uip_ds6_routing_table[i].isused
+        && uip_ds6_routing_table[i].state.dag == dag) {
+      RPL_STAT(rpl_stats.routes_removed++);
+      RPL_TRACE(RPL_TRACE_ROUTE_REMOVE,
+                RPL_TRACE_ADDR(&uip_ds6_routing_table[i].ipaddr));
       uip_ds6_route_rm(&uip_ds6_routing_table[i]);
     }
   }
@@ -121,6 +134,8 @@ rpl_remove_routes_by_nexthop(uip_ipaddr_t *nexthop, rpl_dag_t *dag)
     if(locroute->isused
         && uip_ipaddr_cmp(&locroute->nexthop, nexthop)
         && locroute->state.dag == dag) {
+      RPL_STAT(rpl_stats.routes_removed++);
+      RPL_TRACE(RPL_TRACE_ROUTE_REMOVE, RPL_TRACE_ADDR(&locroute->ipaddr));
       locroute->isused = 0;
     }
   }
@@ -139,6 +154,8 @@ rpl_add_route(rpl_dag_t *dag, uip_ipaddr_t *prefix, int prefix_len,
       PRINTF("RPL: No space for more route entries\n");
       return NULL;
     }
+    RPL_STAT(rpl_stats.routes_added++);
+    RPL_TRACE(RPL_TRACE_ROUTE_ADD, RPL_TRACE_ADDR(prefix));
   } else {
     PRINTF("RPL: Updated the next hop for prefix ");
     PRINT6ADDR(prefix);
@@ -160,6 +177,62 @@ rpl_add_route(rpl_dag_t *dag, uip_ipaddr_t *prefix, int prefix_len,
   return rep;
 }
 /************************************************************************/
+static struct ctimer parent_lost_timer;
+static uip_ipaddr_t lost_parent_addr;
+static rimeaddr_t lost_parent_lladdr;
+
+/*
+ * The link layer has given up on the preferred parent. Instead of
+ * waiting for the periodic rank recalculation, switch to the next-best
+ * parent right away, move the traffic queued for the lost parent, and
+ * announce ourselves to the new parent.
+ */
+static void
+handle_parent_lost(void *ptr)
+{
+  rpl_instance_t *instance;
+  rpl_parent_t *p;
+  uip_ds6_nbr_t *nbr;
+
+  instance = ptr;
+  if(!instance->used) {
+    return;
+  }
+
+  p = rpl_find_parent_any_dag(instance, &lost_parent_addr);
+  if(p != NULL && p == instance->current_dag->preferred_parent) {
+    p->updated = 0;
+    if(!rpl_process_parent_event(instance, p) &&
+       instance->current_dag->preferred_parent == NULL) {
+      /* The remaining parents were out of the rank bound, which the
+         local repair has lifted. Retry with them. */
+      rpl_select_dodag(instance, p);
+    }
+  }
+
+  p = instance->current_dag->preferred_parent;
+  if(p == NULL) {
+    PRINTF("RPL: No parent left after link failure, soliciting DIOs\n");
+    dis_output(NULL);
+    return;
+  }
+
+  PRINTF("RPL: Link failure, switched to parent ");
+  PRINT6ADDR(&p->addr);
+  PRINTF("\n");
+
+  nbr = uip_ds6_nbr_lookup(&p->addr);
+  if(nbr != NULL && nbr->link != NULL) {
+    RPL_REROUTE_QUEUED(&lost_parent_lladdr, nbr->link);
+  }
+
+  /* Refresh the rank of the new parent and install our routes there. */
+  dis_output(&p->addr);
+  if(instance->mop != RPL_MOP_NO_DOWNWARD_ROUTES) {
+    rpl_schedule_dao_immediately(instance);
+  }
+}
+/************************************************************************/
 static void
 rpl_link_neighbor_callback(const rimeaddr_t *addr, int known, int etx)
 {
@@ -190,6 +263,13 @@ rpl_link_neighbor_callback(const rimeaddr_t *addr, int known, int etx)
           PRINT6ADDR(&parent->addr);
           PRINTF(" in instance %u because of bad connectivity (ETX %d)\n", instance->instance_id, etx);
           parent->rank = INFINITE_RANK;
+          if(parent == instance->current_dag->preferred_parent) {
+            RPL_STAT(rpl_stats.parent_lost++);
+            RPL_TRACE(RPL_TRACE_PARENT_LOST, RPL_TRACE_ADDR(&ipaddr));
+            uip_ipaddr_copy(&lost_parent_addr, &ipaddr);
+            rimeaddr_copy(&lost_parent_lladdr, addr);
+            ctimer_set(&parent_lost_timer, 0, handle_parent_lost, instance);
+          }
         }
       }
     }
@@ -227,6 +307,40 @@ rpl_ipv6_neighbor_callback(uip_ds6_nbr_t *nbr)
   }
 }
 /************************************************************************/
+#if RPL_TRACE_EVENTS
+void
+rpl_trace(uint8_t type, uint16_t arg)
+{
+  struct rpl_trace_event *e;
+
+  e = &trace_events[trace_next];
+  e->time = clock_time();
+  e->type = type;
+  e->arg = arg;
+
+  trace_next = (trace_next + 1) % RPL_TRACE_EVENTS;
+  if(trace_count < RPL_TRACE_EVENTS) {
+    trace_count++;
+  }
+}
+/************************************************************************/
+const struct rpl_trace_event *
+rpl_trace_get(int n)
+{
+  if(n < 0 || n >= trace_count) {
+    return NULL;
+  }
+  return &trace_events[(trace_next + RPL_TRACE_EVENTS - trace_count + n) %
+                       RPL_TRACE_EVENTS];
+}
+/************************************************************************/
+void
+rpl_trace_clear(void)
+{
+  trace_next = trace_count = 0;
+}
+#endif /* RPL_TRACE_EVENTS */
+/************************************************************************/
 void
 rpl_init(void)
 {
@@ -236,6 +350,7 @@ rpl_init(void)
 
   rpl_reset_periodic_timer();
   neighbor_info_subscribe(rpl_link_neighbor_callback);
+  rpl_dag_init();
 
   /* add rpl multicast address */
   uip_create_linklocal_rplnodes_mcast(&rplmaddr);
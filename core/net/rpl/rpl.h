@@ -49,6 +49,13 @@
 #define RPL_CONF_STATS 0
 #endif /* RPL_CONF_STATS */
 
+/* Number of control-plane events kept in the trace buffer; 0 disables it. */
+#ifdef RPL_CONF_TRACE_EVENTS
+#define RPL_TRACE_EVENTS RPL_CONF_TRACE_EVENTS
+#else
+#define RPL_TRACE_EVENTS 0
+#endif /* RPL_CONF_TRACE_EVENTS */
+
 /* 
  * Select routing metric supported at runtime. This must be a valid
  * DAG Metric Container Object Type (see below). Currently, we only 
@@ -72,6 +79,18 @@
 #define RPL_OF rpl_of_etx
 #endif /* RPL_CONF_OF */
 
+/*
+ * The objective functions that a node accepts when joining a DAG, as an
+ * initializer list of rpl_of_t pointers, e.g.
+ * { &rpl_of_etx, &rpl_of_composite }. RPL_OF is used when the node creates
+ * a DAG as root.
+ */
+#ifdef RPL_CONF_SUPPORTED_OFS
+#define RPL_SUPPORTED_OFS RPL_CONF_SUPPORTED_OFS
+#else
+#define RPL_SUPPORTED_OFS { &RPL_OF }
+#endif /* RPL_CONF_SUPPORTED_OFS */
+
 /* This value decides which DAG instance we should participate in by default. */
 #define RPL_DEFAULT_INSTANCE	       0x1e
 
@@ -183,6 +202,36 @@ struct rpl_metric_object_energy {
   uint8_t energy_est;
 };
 
+/*
+ * The number of metric objects that a DAG Metric Container can hold.
+ * The first object is always stored in the container itself; the
+ * others are used by objective functions combining several metrics.
+ */
+#ifdef RPL_CONF_DAG_MC_MAX_OBJECTS
+#define RPL_DAG_MC_MAX_OBJECTS RPL_CONF_DAG_MC_MAX_OBJECTS
+#else
+#define RPL_DAG_MC_MAX_OBJECTS 1
+#endif /* RPL_CONF_DAG_MC_MAX_OBJECTS */
+
+union metric_object {
+  struct rpl_metric_object_energy energy;
+  uint16_t etx;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  /* Only carried next to other objects, so single-object containers
+     keep their 16-bit size. */
+  uint32_t latency; /* microseconds */
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
+};
+
+/* Logical representation of an additional DAG Metric Container object. */
+struct rpl_metric_object {
+  uint8_t type;
+  uint8_t flags;
+  uint8_t aggr;
+  uint8_t prec;
+  union metric_object obj;
+};
+
 /* Logical representation of a DAG Metric Container. */
 struct rpl_metric_container {
   uint8_t type;
@@ -190,10 +239,11 @@ struct rpl_metric_container {
   uint8_t aggr;
   uint8_t prec;
   uint8_t length;
-  union metric_object {
-    struct rpl_metric_object_energy energy;
-    uint16_t etx;
-  } obj;
+  union metric_object obj;
+#if RPL_DAG_MC_MAX_OBJECTS > 1
+  uint8_t extra_count;
+  struct rpl_metric_object extra[RPL_DAG_MC_MAX_OBJECTS - 1];
+#endif /* RPL_DAG_MC_MAX_OBJECTS > 1 */
 };
 typedef struct rpl_metric_container rpl_metric_container_t;
 /*---------------------------------------------------------------------------*/
@@ -286,6 +336,10 @@ struct rpl_of {
   rpl_ocp_t ocp;
 };
 typedef struct rpl_of rpl_of_t;
+
+/* Objective functions provided with ContikiRPL. */
+extern rpl_of_t rpl_of_etx;
+extern rpl_of_t rpl_of_composite;
 /*---------------------------------------------------------------------------*/
 /* Instance */
 struct rpl_instance {
@@ -315,11 +369,81 @@ struct rpl_instance {
   uint16_t dio_totsend;
   uint16_t dio_totrecv;
 #endif /* RPL_CONF_STATS */
+#if RPL_CONF_DAO_ACK
+  uint32_t dao_ack_pending; /* bitmap of unacknowledged DAOs */
+  uint8_t dao_seq_first; /* sequence number of the first DAO in the round */
+  uint8_t dao_seq_count;
+  uint8_t dao_retransmissions;
+#endif /* RPL_CONF_DAO_ACK */
   uint32_t dio_next_delay; /* delay for completion of dio interval */
   struct ctimer dio_timer;
   struct ctimer dao_timer;
 };
 
+/*---------------------------------------------------------------------------*/
+#if RPL_CONF_STATS
+/* Statistics for fault management. */
+struct rpl_stats {
+  uint16_t mem_overflows;
+  uint16_t local_repairs;
+  uint16_t global_repairs;
+  uint16_t malformed_msgs;
+  uint16_t resets;
+  uint16_t parent_switch;
+  uint16_t parent_lost;
+  /* Control messages sent and received. */
+  uint16_t dio_in;
+  uint16_t dio_out;
+  uint16_t dis_in;
+  uint16_t dis_out;
+  uint16_t dao_in;
+  uint16_t dao_out;
+  uint16_t dao_ack_in;
+  uint16_t dao_ack_out;
+  /* Routing table churn. */
+  uint16_t routes_added;
+  uint16_t routes_removed;
+};
+typedef struct rpl_stats rpl_stats_t;
+
+extern rpl_stats_t rpl_stats;
+#endif /* RPL_CONF_STATS */
+
+#if RPL_TRACE_EVENTS
+/* Control-plane events recorded in the trace buffer. */
+enum {
+  RPL_TRACE_DIO_IN,
+  RPL_TRACE_DIO_OUT,
+  RPL_TRACE_DIS_IN,
+  RPL_TRACE_DIS_OUT,
+  RPL_TRACE_DAO_IN,
+  RPL_TRACE_DAO_OUT,
+  RPL_TRACE_DAO_ACK_IN,
+  RPL_TRACE_DAO_ACK_OUT,
+  RPL_TRACE_PARENT_SWITCH,
+  RPL_TRACE_GLOBAL_REPAIR,
+  RPL_TRACE_LOCAL_REPAIR,
+  RPL_TRACE_TRICKLE_RESET,
+  RPL_TRACE_ROUTE_ADD,
+  RPL_TRACE_ROUTE_REMOVE,
+  RPL_TRACE_PARENT_LOST,
+};
+
+/*
+ * A trace event. The argument identifies the peer, route or DAG
+ * involved: the last two bytes of its address, or the DAG version.
+ */
+struct rpl_trace_event {
+  clock_time_t time;
+  uint16_t arg;
+  uint8_t type;
+};
+
+/* Returns the n:th oldest event in the trace buffer, or NULL. */
+const struct rpl_trace_event *rpl_trace_get(int n);
+void rpl_trace_clear(void);
+#endif /* RPL_TRACE_EVENTS */
+
 /*---------------------------------------------------------------------------*/
 /* Public RPL functions. */
 void rpl_init(void);
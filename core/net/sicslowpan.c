@@ -64,6 +64,7 @@
 #include "net/tcpip.h"
 #include "net/uip.h"
 #include "net/uip-ds6.h"
+#include "net/uip-bufpool.h"
 #include "net/rime.h"
 #include "net/sicslowpan.h"
 #include "net/neighbor-info.h"
@@ -698,6 +699,15 @@ compress_hdr_hc06(rimeaddr_t *rime_destaddr)
     }
   }
 
+  /* A unicast packet for an address that is not link-local, and that
+     does not take it from the link-layer address, may be sent through
+     another neighbor (see csma_reroute()). */
+  if(!(iphc1 & SICSLOWPAN_IPHC_M) &&
+     !uip_is_addr_link_local(&UIP_IP_BUF->destipaddr) &&
+     (iphc1 & SICSLOWPAN_IPHC_DAM_11) != SICSLOWPAN_IPHC_DAM_11) {
+    packetbuf_set_attr(PACKETBUF_ATTR_REROUTABLE, 1);
+  }
+
   uncomp_hdr_len = UIP_IPH_LEN;
 
 #if UIP_CONF_UDP
@@ -1429,6 +1439,9 @@ output(uip_lladdr_t *localdest)
      */
 
     PRINTFO("Fragmentation sending packet len %d\n", uip_len);
+
+    /* The fragments of a packet must all go to the same neighbor. */
+    packetbuf_set_attr(PACKETBUF_ATTR_REROUTABLE, 0);
     
     /* Create 1st Fragment */
     PRINTFO("sicslowpan output: 1rst fragment ");
@@ -1753,7 +1766,23 @@ input(void)
       callback->input_callback();
     }
 
+#if UIP_CONF_BUF_POOL
+    {
+      /* Hand the buffer over to the stack and go on with a fresh one,
+         so that the next packet can be received while this one waits
+         for the TCP/IP process. */
+      uip_buf_t *buf = uip_bufpool_detach();
+      if(buf != NULL) {
+        tcpip_input_buf(buf, uip_len);
+        uip_len = 0;
+        uip_ext_len = 0;
+      } else {
+        tcpip_input();
+      }
+    }
+#else /* UIP_CONF_BUF_POOL */
     tcpip_input();
+#endif /* UIP_CONF_BUF_POOL */
 #if SICSLOWPAN_CONF_FRAG
   }
 #endif /* SICSLOWPAN_CONF_FRAG */
@@ -41,6 +41,8 @@
 #include "contiki-net.h"
 #include "net/uip-split.h"
 #include "net/uip-packetqueue.h"
+#include "net/uip-bufpool.h"
+#include "net/packetbuf.h"
 
 #if UIP_CONF_IPV6
 #include "net/uip-nd6.h"
@@ -152,7 +154,7 @@ tcpip_set_outputfunc(u8_t (*f)(void))
 unsigned char tcpip_is_forwarding; /* Forwarding right now? */
 #endif /* UIP_CONF_IP_FORWARD */
 
-PROCESS(tcpip_process, "TCP/IP stack");
+PROCESS_PRIO(tcpip_process, "TCP/IP stack", PROCESS_PRIO_HIGH);
 
 /*---------------------------------------------------------------------------*/
 static void
@@ -223,6 +225,81 @@ packet_input(void)
 #endif /* UIP_CONF_IP_FORWARD */
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_CONF_BUF_POOL
+/* Packets handed over by tcpip_input_buf(), oldest first. */
+static uip_buf_t *input_bufs[UIP_CONF_BUF_POOL];
+static u16_t input_lens[UIP_CONF_BUF_POOL];
+/* The packetbuf attributes of the frames the packets came in, which
+   the stack reads while processing them, e.g. the sender address of
+   a RPL DIO. packetbuf holds later frames by then. */
+static struct packetbuf_attr input_attrs[UIP_CONF_BUF_POOL][PACKETBUF_NUM_ATTRS];
+static struct packetbuf_addr input_addrs[UIP_CONF_BUF_POOL][PACKETBUF_NUM_ADDRS];
+static u8_t input_first, input_count;
+
+int
+tcpip_input_buf(uip_buf_t *buf, u16_t len)
+{
+  u8_t i;
+
+  if(input_count == UIP_CONF_BUF_POOL) {
+    UIP_LOG("tcpip_input_buf: input queue full");
+    uip_bufpool_free(buf);
+    return 0;
+  }
+  i = (input_first + input_count) % UIP_CONF_BUF_POOL;
+  input_bufs[i] = buf;
+  input_lens[i] = len;
+  packetbuf_attr_copyto(input_attrs[i], input_addrs[i]);
+  input_count++;
+  process_poll(&tcpip_process);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_queued_packets(void)
+{
+  uip_buf_t *saved;
+  u16_t saved_len;
+#if UIP_CONF_IPV6
+  u8_t saved_ext_len;
+#endif /* UIP_CONF_IPV6 */
+
+  if(input_count == 0) {
+    return;
+  }
+
+  /* uip_buf may hold a packet that is still being worked on, such as
+     one that 6LoWPAN decompresses in place. It is set aside while the
+     queued packets take its place and put back afterwards. */
+  saved = uip_bufpool_exchange(input_bufs[input_first]);
+  saved_len = uip_len;
+#if UIP_CONF_IPV6
+  saved_ext_len = uip_ext_len;
+#endif /* UIP_CONF_IPV6 */
+
+  while(input_count > 0) {
+    /* The queued buffer becomes uip_buf: no copy is needed. */
+    uip_bufpool_attach(input_bufs[input_first]);
+    uip_len = input_lens[input_first];
+    packetbuf_attr_copyfrom(input_attrs[input_first],
+                            input_addrs[input_first]);
+#if UIP_CONF_IPV6
+    uip_ext_len = 0;
+#endif /* UIP_CONF_IPV6 */
+    input_first = (input_first + 1) % UIP_CONF_BUF_POOL;
+    input_count--;
+    packet_input();
+    uip_len = 0;
+  }
+
+  uip_bufpool_attach(saved);
+  uip_len = saved_len;
+#if UIP_CONF_IPV6
+  uip_ext_len = saved_ext_len;
+#endif /* UIP_CONF_IPV6 */
+}
+#endif /* UIP_CONF_BUF_POOL */
+/*---------------------------------------------------------------------------*/
 #if UIP_TCP
 #if UIP_ACTIVE_OPEN
 struct uip_conn *
@@ -411,7 +488,7 @@ eventhandler(process_event_t ev, process_data_t data)
         for(cptr = &uip_udp_conns[0];
             cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
           if(cptr->appstate.p == p) {
-            cptr->lport = 0;
+            uip_udp_remove(cptr);
           }
         }
       }
@@ -520,6 +597,12 @@ eventhandler(process_event_t ev, process_data_t data)
     case PACKET_INPUT:
       packet_input();
       break;
+
+#if UIP_CONF_BUF_POOL
+    case PROCESS_EVENT_POLL:
+      input_queued_packets();
+      break;
+#endif /* UIP_CONF_BUF_POOL */
   };
 }
 /*---------------------------------------------------------------------------*/
@@ -598,12 +681,12 @@ tcpip_ipv6_output(void)
         uip_len = 0;
         return;
       } else {
+        /* With a buffer pool, the queued packet keeps its buffer and
+           this address remains valid after uip_buf has been replaced. */
+        uip_ipaddr_t *src = &UIP_IP_BUF->srcipaddr;
 #if UIP_CONF_IPV6_QUEUE_PKT
         /* Copy outgoing pkt in the queuing buffer for later transmit. */
-        if(uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-          memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF, uip_len);
-          uip_packetqueue_set_buflen(&nbr->packethandle, uip_len);
-        }
+        uip_packetqueue_store(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME);
 #endif
       /* RFC4861, 7.2.2:
        * "If the source address of the packet prompting the solicitation is the
@@ -611,8 +694,8 @@ tcpip_ipv6_output(void)
        * address SHOULD be placed in the IP Source Address of the outgoing
        * solicitation.  Otherwise, any one of the addresses assigned to the
        * interface should be used."*/
-       if(uip_ds6_is_my_addr(&UIP_IP_BUF->srcipaddr)){
-          uip_nd6_ns_output(&UIP_IP_BUF->srcipaddr, NULL, &nbr->ipaddr);
+       if(uip_ds6_is_my_addr(src)){
+          uip_nd6_ns_output(src, NULL, &nbr->ipaddr);
         } else {
           uip_nd6_ns_output(NULL, NULL, &nbr->ipaddr);
         }
@@ -626,10 +709,7 @@ tcpip_ipv6_output(void)
 #if UIP_CONF_IPV6_QUEUE_PKT
         /* Copy outgoing pkt in the queuing buffer for later transmit and set
            the destination nbr to nbr. */
-        if(uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-          memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF, uip_len);
-          uip_packetqueue_set_buflen(&nbr->packethandle, uip_len);
-        }
+        uip_packetqueue_store(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME);
 #endif /*UIP_CONF_IPV6_QUEUE_PKT*/
         uip_len = 0;
         return;
@@ -644,20 +724,20 @@ tcpip_ipv6_output(void)
       }
 
       stimer_set(&nbr->sendns, uip_ds6_if.retrans_timer / 1000);
-      tcpip_output(&nbr->lladdr);
+      tcpip_output(uip_ds6_nbr_get_ll(nbr));
 
 #if UIP_CONF_IPV6_QUEUE_PKT
       /*
        * Send the queued packets from here, may not be 100% perfect though.
        * This happens in a few cases, for example when instead of receiving a
        * NA after sendiong a NS, you receive a NS with SLLAO: the entry moves
-       * to STALE, and you must both send a NA and the queued packet.
+       * to STALE, and you must both send a NA and the queued packets.
+       * ND hands over the oldest queued packet when the address is
+       * resolved; the rest of the queue follows it in order.
        */
-      if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
-        uip_len = uip_packetqueue_buflen(&nbr->packethandle);
-        memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-        uip_packetqueue_free(&nbr->packethandle);
-        tcpip_output(&nbr->lladdr);
+      while(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
+        uip_packetqueue_restore(&nbr->packethandle);
+        tcpip_output(uip_ds6_nbr_get_ll(nbr));
       }
 #endif /*UIP_CONF_IPV6_QUEUE_PKT*/
 
@@ -671,6 +751,38 @@ tcpip_ipv6_output(void)
   uip_len = 0;
   uip_ext_len = 0;
 }
+/*---------------------------------------------------------------------------*/
+#if UIP_CONF_BUF_POOL
+uip_buf_t *
+tcpip_ipv6_output_buf(uip_buf_t *buf, u16_t len)
+{
+  uip_buf_t *saved;
+  uip_buf_t *current;
+  u16_t saved_len;
+  u8_t saved_ext_len;
+
+  /* As in input_queued_packets(), uip_buf may hold a packet that is
+     still being worked on. */
+  saved = uip_bufpool_exchange(buf);
+  saved_len = uip_len;
+  saved_ext_len = uip_ext_len;
+
+  uip_len = len;
+  uip_ext_len = 0;
+  tcpip_ipv6_output();
+
+  current = uip_bufpool_exchange(saved);
+  uip_len = saved_len;
+  uip_ext_len = saved_ext_len;
+  if(current != buf) {
+    /* The packet was queued for address resolution with its buffer,
+       and an empty one from the pool took its place. */
+    uip_bufpool_free(current);
+    return NULL;
+  }
+  return buf;
+}
+#endif /* UIP_CONF_BUF_POOL */
 #endif /* UIP_CONF_IPV6 */
 /*---------------------------------------------------------------------------*/
 #if UIP_UDP
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A pool of packet buffers backing uip_buf.
+ */
+
+#include "net/uip-bufpool.h"
+#include "lib/memb.h"
+
+#if UIP_CONF_BUF_POOL
+
+/*
+ * The pool is declared by hand instead of with MEMB() so that the first
+ * buffer can be marked as in use at compile time: uip_buf must refer to
+ * valid memory before any initialization function has run.
+ */
+static char bufpool_count[UIP_CONF_BUF_POOL] = { 1 };
+static uip_buf_t bufpool_mem[UIP_CONF_BUF_POOL];
+static struct memb bufpool = { sizeof(uip_buf_t), UIP_CONF_BUF_POOL,
+                               bufpool_count, (void *)bufpool_mem };
+
+uip_buf_t *uip_bufp = &bufpool_mem[0];
+/*---------------------------------------------------------------------------*/
+uip_buf_t *
+uip_bufpool_alloc(void)
+{
+  return memb_alloc(&bufpool);
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_bufpool_free(uip_buf_t *buf)
+{
+  memb_free(&bufpool, buf);
+}
+/*---------------------------------------------------------------------------*/
+uip_buf_t *
+uip_bufpool_detach(void)
+{
+  uip_buf_t *buf;
+  uip_buf_t *fresh;
+
+  fresh = memb_alloc(&bufpool);
+  if(fresh == NULL) {
+    return NULL;
+  }
+  buf = uip_bufp;
+  uip_bufp = fresh;
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_bufpool_attach(uip_buf_t *buf)
+{
+  if(buf != uip_bufp) {
+    memb_free(&bufpool, uip_bufp);
+    uip_bufp = buf;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uip_buf_t *
+uip_bufpool_exchange(uip_buf_t *buf)
+{
+  uip_buf_t *previous;
+
+  previous = uip_bufp;
+  uip_bufp = buf;
+  return previous;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* UIP_CONF_BUF_POOL */
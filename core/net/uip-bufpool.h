@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A pool of packet buffers backing uip_buf.
+ *
+ *         With UIP_CONF_BUF_POOL set to the number of buffers, uip_buf
+ *         refers to the current buffer of the pool rather than to a
+ *         single static buffer. A module that needs to keep a packet
+ *         (e.g., while waiting for address resolution) detaches the
+ *         current buffer and lets the stack continue with a fresh one;
+ *         later, it attaches the buffer again instead of copying the
+ *         packet back into uip_buf.
+ */
+
+#ifndef UIP_BUFPOOL_H
+#define UIP_BUFPOOL_H
+
+#include "net/uip.h"
+
+#if UIP_CONF_BUF_POOL
+
+/**
+ * \brief      Allocate an empty buffer from the pool
+ * \return     The buffer, or NULL if the pool is exhausted
+ */
+uip_buf_t *uip_bufpool_alloc(void);
+
+/**
+ * \brief      Return a buffer to the pool
+ */
+void uip_bufpool_free(uip_buf_t *buf);
+
+/**
+ * \brief      Take ownership of the packet in uip_buf
+ * \return     The buffer holding the packet, or NULL if no buffer
+ *             could replace it, in which case uip_buf is unchanged
+ *
+ *             On success, uip_buf refers to an empty buffer. uip_len
+ *             is left untouched.
+ */
+uip_buf_t *uip_bufpool_detach(void);
+
+/**
+ * \brief      Make a buffer the current uip_buf
+ *
+ *             The previous contents of uip_buf are discarded and its
+ *             buffer is returned to the pool. The caller sets uip_len.
+ */
+void uip_bufpool_attach(uip_buf_t *buf);
+
+/**
+ * \brief      Make a buffer the current uip_buf, keeping the previous one
+ * \return     The previous buffer, which now belongs to the caller
+ *
+ *             Used to set aside a packet that is still being worked on
+ *             in uip_buf; uip_bufpool_attach() puts it back later.
+ */
+uip_buf_t *uip_bufpool_exchange(uip_buf_t *buf);
+
+/**
+ * \brief      Deliver an incoming packet held in a pool buffer
+ * \param buf  A buffer from uip_bufpool_alloc() holding the packet
+ * \param len  The length of the packet, as uip_len would be set
+ * \return     Non-zero if the packet was queued, zero if it was dropped
+ *
+ *             Unlike tcpip_input(), the packet is not processed
+ *             immediately: it is queued, together with its buffer, and
+ *             processed by the TCP/IP process. A driver can thus
+ *             receive several packets while the stack is busy. The
+ *             attributes and addresses in packetbuf, such as the link
+ *             layer sender and the RSSI, are saved with the packet
+ *             and put back in packetbuf before it is processed. The
+ *             buffer belongs to the stack after this call. Must not be
+ *             called from an interrupt. Implemented in tcpip.c.
+ */
+int tcpip_input_buf(uip_buf_t *buf, u16_t len);
+
+#if UIP_CONF_IPV6
+/**
+ * \brief      Send an outgoing packet held in a pool buffer
+ * \param buf  A buffer from the pool holding the packet
+ * \param len  The length of the packet, as uip_len would be set
+ * \return     buf, if it still belongs to the caller, or NULL if the
+ *             stack has kept or freed it
+ *
+ *             Like tcpip_ipv6_output(), but the packet is sent from
+ *             buf instead of being copied into uip_buf: buf is the
+ *             current uip_buf during the call, and the previous one
+ *             is put back afterwards, with uip_len and uip_ext_len.
+ *             Only unicast packets can lose their buffer, e.g., when
+ *             they wait for address resolution. The buffer of a
+ *             multicast packet is always given back and may be sent
+ *             again. Implemented in tcpip.c.
+ */
+uip_buf_t *tcpip_ipv6_output_buf(uip_buf_t *buf, u16_t len);
+#endif /* UIP_CONF_IPV6 */
+
+#endif /* UIP_CONF_BUF_POOL */
+
+#endif /* UIP_BUFPOOL_H */
@@ -47,6 +47,7 @@
 #include "net/uip-nd6.h"
 #include "net/uip-ds6.h"
 #include "net/uip-packetqueue.h"
+#include "net/neighbor-attr.h"
 
 #define DEBUG DEBUG_NONE
 #include "net/uip-debug.h"
@@ -100,6 +101,60 @@ static uip_ds6_route_t *locroute;
 static uip_ds6_mcastrt_t *locmcastrt;
 #endif
 
+/* The link addresses of the neighbor cache are held by the neighbor
+   table. Its attribute is one plus the index of a cache entry with that
+   link address, so that a link address is looked up only once. */
+#if UIP_LLADDR_LEN > RIMEADDR_SIZE
+#error The neighbor table cannot hold link addresses longer than RIMEADDR_SIZE
+#endif
+NEIGHBOR_ATTRIBUTE(uint8_t, nbr_index, NULL);
+static uip_lladdr_t unknown_lladdr;
+
+/*---------------------------------------------------------------------------*/
+/* The neighbor table keeps the link addresses that the cache uses. */
+static int
+nbr_index_veto(void *data)
+{
+  return *(uint8_t *)data != 0;
+}
+/*---------------------------------------------------------------------------*/
+static const rimeaddr_t *
+lladdr_key(uip_lladdr_t *lladdr)
+{
+#if UIP_LLADDR_LEN == RIMEADDR_SIZE
+  return (const rimeaddr_t *)lladdr;
+#else /* UIP_LLADDR_LEN == RIMEADDR_SIZE */
+  static rimeaddr_t key;
+
+  memset(&key, 0, sizeof(key));
+  memcpy(&key, lladdr, UIP_LLADDR_LEN);
+  return &key;
+#endif /* UIP_LLADDR_LEN == RIMEADDR_SIZE */
+}
+/*---------------------------------------------------------------------------*/
+/* Stops nbr from referring to its link address, and points the
+   neighbor table to another cache entry with that address, if any. */
+static void
+nbr_unlink(uip_ds6_nbr_t *nbr)
+{
+  uint8_t *index;
+  uip_ds6_nbr_t *n;
+
+  if(nbr->link == NULL) {
+    return;
+  }
+  index = neighbor_attr_get_data(&nbr_index, nbr->link);
+  if(index != NULL && *index == nbr - uip_ds6_nbr_cache + 1) {
+    *index = 0;
+    for(n = uip_ds6_nbr_cache; n < uip_ds6_nbr_cache + UIP_DS6_NBR_NB; n++) {
+      if(n != nbr && n->isused && n->link == nbr->link) {
+        *index = n - uip_ds6_nbr_cache + 1;
+        break;
+      }
+    }
+  }
+  nbr->link = NULL;
+}
 /*---------------------------------------------------------------------------*/
 void
 uip_ds6_init(void)
@@ -113,6 +168,8 @@ uip_ds6_init(void)
   memset(uip_ds6_prefix_list, 0, sizeof(uip_ds6_prefix_list));
   memset(&uip_ds6_if, 0, sizeof(uip_ds6_if));
   memset(uip_ds6_routing_table, 0, sizeof(uip_ds6_routing_table));
+  neighbor_attr_register(&nbr_index);
+  neighbor_attr_set_evict_veto(&nbr_index, nbr_index_veto);
 
   /* Set interface parameters */
   uip_ds6_if.link_mtu = UIP_LINK_MTU;
@@ -295,14 +352,17 @@ uip_ds6_nbr_add(uip_ipaddr_t *ipaddr, uip_lladdr_t * lladdr,
       sizeof(uip_ds6_nbr_t), ipaddr, 128,
       (uip_ds6_element_t **)&locnbr);
 
+  if(r == FREESPACE) {
+    locnbr->link = NULL;
+    if(!uip_ds6_nbr_set_ll(locnbr, lladdr)) {
+      /* The neighbor table has no room for the link address. */
+      r = NOSPACE;
+    }
+  }
+
   if(r == FREESPACE) {
     locnbr->isused = 1;
     uip_ipaddr_copy(&locnbr->ipaddr, ipaddr);
-    if(lladdr != NULL) {
-      memcpy(&locnbr->lladdr, lladdr, UIP_LLADDR_LEN);
-    } else {
-      memset(&locnbr->lladdr, 0, UIP_LLADDR_LEN);
-    }
     locnbr->isrouter = isrouter;
     locnbr->state = state;
 #if UIP_CONF_IPV6_QUEUE_PKT
@@ -315,7 +375,7 @@ uip_ds6_nbr_add(uip_ipaddr_t *ipaddr, uip_lladdr_t * lladdr,
     PRINTF("Adding neighbor with ip addr ");
     PRINT6ADDR(ipaddr);
     PRINTF("link addr ");
-    PRINTLLADDR((&(locnbr->lladdr)));
+    PRINTLLADDR(uip_ds6_nbr_get_ll(locnbr));
     PRINTF("state %u\n", state);
     NEIGHBOR_STATE_CHANGED(locnbr);
 
@@ -355,6 +415,7 @@ uip_ds6_nbr_rm(uip_ds6_nbr_t *nbr)
 {
   if(nbr != NULL) {
     nbr->isused = 0;
+    nbr_unlink(nbr);
 #if UIP_CONF_IPV6_QUEUE_PKT
     uip_packetqueue_free(&nbr->packethandle);
 #endif /* UIP_CONF_IPV6_QUEUE_PKT */
@@ -380,20 +441,56 @@ uip_ds6_nbr_lookup(uip_ipaddr_t *ipaddr)
 uip_ds6_nbr_t *
 uip_ds6_nbr_ll_lookup(uip_lladdr_t *lladdr)
 {
-  uip_ds6_nbr_t *fin;
+  uint8_t *index;
 
-  for(locnbr = uip_ds6_nbr_cache, fin = locnbr + UIP_DS6_NBR_NB;
-       locnbr < fin;
-       ++locnbr) {
-    if(locnbr->isused) {
-      if(!memcmp(lladdr, &locnbr->lladdr, UIP_LLADDR_LEN)) {
-        return locnbr;
-      }
-    }
+  index = neighbor_attr_get_data(&nbr_index, lladdr_key(lladdr));
+  if(index != NULL && *index != 0) {
+    return &uip_ds6_nbr_cache[*index - 1];
   }
   return NULL;
 }
 
+/*---------------------------------------------------------------------------*/
+uip_lladdr_t *
+uip_ds6_nbr_get_ll(uip_ds6_nbr_t *nbr)
+{
+  if(nbr->link == NULL) {
+    /* An incomplete entry has an all-zero link address. */
+    return &unknown_lladdr;
+  }
+  return (uip_lladdr_t *)nbr->link;
+}
+
+/*---------------------------------------------------------------------------*/
+int
+uip_ds6_nbr_set_ll(uip_ds6_nbr_t *nbr, uip_lladdr_t *lladdr)
+{
+  const rimeaddr_t *key;
+  uint8_t *index;
+
+  if(lladdr == NULL) {
+    nbr_unlink(nbr);
+    return 1;
+  }
+
+  key = lladdr_key(lladdr);
+  if(nbr->link != NULL && rimeaddr_cmp(nbr->link, key)) {
+    return 1;
+  }
+  /* The old link address is kept until the new one has a place in the
+     neighbor table. Being in use, it is not evicted to make room. */
+  if(neighbor_attr_add_neighbor(key) < 0) {
+    return 0;
+  }
+  nbr_unlink(nbr);
+  nbr->link = neighbor_attr_get_addr(key);
+  index = neighbor_attr_get_data(&nbr_index, nbr->link);
+  if(*index == 0) {
+    *index = nbr - uip_ds6_nbr_cache + 1;
+  }
+  return 1;
+}
+
 /*---------------------------------------------------------------------------*/
 uip_ds6_defrt_t *
 uip_ds6_defrt_add(uip_ipaddr_t *ipaddr, unsigned long interval)
@@ -925,6 +1022,22 @@ uip_ds6_set_addr_iid(uip_ipaddr_t *ipaddr, uip_lladdr_t * lladdr)
 #endif
 }
 
+/*---------------------------------------------------------------------------*/
+void
+uip_ds6_get_addr_iid(uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr)
+{
+#if (UIP_LLADDR_LEN == 8)
+  memcpy(lladdr, ipaddr->u8 + 8, UIP_LLADDR_LEN);
+  lladdr->addr[0] ^= 0x02;
+#elif (UIP_LLADDR_LEN == 6)
+  memcpy(lladdr, ipaddr->u8 + 8, 3);
+  memcpy((uint8_t *)lladdr + 3, ipaddr->u8 + 13, 3);
+  lladdr->addr[0] ^= 0x02;
+#else
+#error uip-ds6.c cannot build interface address when UIP_LLADDR_LEN is not 6 or 8
+#endif
+}
+
 /*---------------------------------------------------------------------------*/
 uint8_t
 get_match_length(uip_ipaddr_t *src, uip_ipaddr_t *dst)
@@ -44,6 +44,7 @@
 
 #include "net/uip.h"
 #include "net/uip-mcast6/uip-mcast6.h"
+#include "net/rime/rimeaddr.h"
 #include "sys/stimer.h"
 
 /*--------------------------------------------------*/
@@ -167,7 +168,7 @@
 typedef struct uip_ds6_nbr {
   uint8_t isused;
   uip_ipaddr_t ipaddr;
-  uip_lladdr_t lladdr;
+  const rimeaddr_t *link; /* In the neighbor table, NULL when unknown */
   struct stimer reachable;
   struct stimer sendns;
   clock_time_t last_lookup;
@@ -329,6 +330,8 @@ uip_ds6_nbr_t *uip_ds6_nbr_add(uip_ipaddr_t *ipaddr, uip_lladdr_t *lladdr,
 void uip_ds6_nbr_rm(uip_ds6_nbr_t *nbr);
 uip_ds6_nbr_t *uip_ds6_nbr_lookup(uip_ipaddr_t *ipaddr);
 uip_ds6_nbr_t *uip_ds6_nbr_ll_lookup(uip_lladdr_t *lladdr);
+uip_lladdr_t *uip_ds6_nbr_get_ll(uip_ds6_nbr_t *nbr);
+int uip_ds6_nbr_set_ll(uip_ds6_nbr_t *nbr, uip_lladdr_t *lladdr);
 
 /** @} */
 
@@ -408,6 +411,9 @@ uip_ds6_mcastrt_t *uip_ds6_mcast_route_add(uip_ipaddr_t *group);
 /** \brief set the last 64 bits of an IP address based on the MAC address */
 void uip_ds6_set_addr_iid(uip_ipaddr_t * ipaddr, uip_lladdr_t * lladdr);
 
+/** \brief set the MAC address from which the last 64 bits of an IP address were built */
+void uip_ds6_get_addr_iid(uip_ipaddr_t * ipaddr, uip_lladdr_t * lladdr);
+
 /** \brief Get the number of matching bits of two addresses */
 uint8_t get_match_length(uip_ipaddr_t * src, uip_ipaddr_t * dst);
 
@@ -79,6 +79,9 @@ uip_icmp6_echo_request_input(void)
 #if UIP_CONF_IPV6_RPL
   u8_t temp_ext_len;
 #endif /* UIP_CONF_IPV6_RPL */
+  u16_t old_chksum;
+  u16_t old_type_code;
+  u8_t incremental;
   /*
    * we send an echo reply. It is trivial if there was no extension
    * headers in the request otherwise we need to remove the extension
@@ -90,6 +93,16 @@ uip_icmp6_echo_request_input(void)
   PRINT6ADDR(&UIP_IP_BUF->destipaddr);
   PRINTF("\n");
 
+  /*
+   * When the addresses are only swapped, the pseudo-header sum and the
+   * ICMPv6 length are unchanged, and the checksum of the request can be
+   * updated for the new type and code (RFC 1624).
+   */
+  incremental = !uip_is_addr_mcast(&UIP_IP_BUF->destipaddr);
+  old_chksum = UIP_ICMP_BUF->icmpchksum;
+  old_type_code = uip_htons(((u16_t)UIP_ICMP_BUF->type << 8) |
+                            UIP_ICMP_BUF->icode);
+
   /* IP header */
   UIP_IP_BUF->ttl = uip_ds6_if.cur_hop_limit;
 
@@ -148,8 +161,14 @@ uip_icmp6_echo_request_input(void)
   /* Note: now UIP_ICMP_BUF points to the beginning of the echo reply */
   UIP_ICMP_BUF->type = ICMP6_ECHO_REPLY;
   UIP_ICMP_BUF->icode = 0;
-  UIP_ICMP_BUF->icmpchksum = 0;
-  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+  if(incremental) {
+    UIP_ICMP_BUF->icmpchksum =
+      uip_chksum_update16(old_chksum, old_type_code,
+                          UIP_HTONS(ICMP6_ECHO_REPLY << 8));
+  } else {
+    UIP_ICMP_BUF->icmpchksum = 0;
+    UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+  }
 
   PRINTF("Sending Echo Reply to");
   PRINT6ADDR(&UIP_IP_BUF->destipaddr);
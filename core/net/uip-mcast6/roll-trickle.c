@@ -50,6 +50,7 @@
 #include "contiki-net.h"
 #include "net/uip-mcast6/uip-mcast6.h"
 #include "net/uip-mcast6/roll-trickle.h"
+#include "net/uip-bufpool.h"
 #include "dev/watchdog.h"
 #include <string.h>
 
@@ -277,7 +278,11 @@ struct mcast_packet {
   uint16_t seq_val; /* host-byte order */
   struct sliding_window * sw; /* Pointer to the SW this packet belongs to */
   uint8_t flags; /* Is-Used, Must Send, Is Listed */
+#if UIP_CONF_BUF_POOL
+  uip_buf_t *buf; /* The pool buffer the datagram is kept in */
+#else
   uint8_t buff[UIP_BUFSIZE - UIP_LLH_LEN];
+#endif
 };
 
 /* Flag bits */
@@ -285,20 +290,30 @@ struct mcast_packet {
 #define MCAST_PACKET_S_BIT       0x20 /* Must Send Next Pass */
 #define MCAST_PACKET_L_BIT       0x10 /* Is listed in ICMP message */
 
+/**
+ * \brief Get a pointer to the IPv6 header of a buffered packet
+ * p: pointer to a packet buffer
+ */
+#if UIP_CONF_BUF_POOL
+#define MCAST_PACKET_IP_HDR(p) \
+    ((struct uip_ip_hdr *)&(p)->buf->u8[UIP_LLH_LEN])
+#else
+#define MCAST_PACKET_IP_HDR(p) ((struct uip_ip_hdr *)(p)->buff)
+#endif
+
 /* Fetch a pointer to the Seed ID of a buffered message p */
 #if ROLL_TRICKLE_SHORT_SEEDS
 #define MCAST_PACKET_GET_SEED(p) ((seed_id_t *)&((p)->seed_id))
 #else
 #define MCAST_PACKET_GET_SEED(p) \
-    ((seed_id_t *)&((struct uip_ip_hdr *)&(p)->buff[UIP_LLH_LEN])->srcipaddr)
+    ((seed_id_t *)&MCAST_PACKET_IP_HDR(p)->srcipaddr)
 #endif
 
 /**
  * \brief Get the TTL of a buffered packet
  * p: pointer to a packet buffer
  */
-#define MCAST_PACKET_TTL(p) \
-    (((struct uip_ip_hdr *)(p)->buff)->ttl)
+#define MCAST_PACKET_TTL(p) (MCAST_PACKET_IP_HDR(p)->ttl)
 
 /**
  * \brief Set 'Is Used' bit for packet p
@@ -356,7 +371,13 @@ struct mcast_packet {
  * \brief Free a multicast packet buffer
  * p: pointer to a struct mcast_packet
  */
+#if UIP_CONF_BUF_POOL
+#define MCAST_PACKET_FREE(p) do { \
+  uip_bufpool_free((p)->buf); \
+  (p)->flags = 0; } while(0)
+#else
 #define MCAST_PACKET_FREE(p) ((p)->flags = 0)
+#endif
 /*---------------------------------------------------------------------------*/
 /* Sequence Lists in Multicast Trickle ICMP messages */
 struct sequence_list_header {
@@ -616,11 +637,15 @@ handle_timer(void * ptr)
           PRINTF("Trickle: M=%u Periodic - Sending packet from Seed ", m);
           PRINT_SEED(&locmpptr->sw->seed_id);
           PRINTF(" seq %u\n", locmpptr->seq_val);
+          STATS_ADD(mcast_fwd);
+#if UIP_CONF_BUF_POOL
+          /* Sent from its buffer, which it keeps for the next pass */
+          tcpip_ipv6_output_buf(locmpptr->buf, locmpptr->buff_len);
+#else
           uip_len = locmpptr->buff_len;
           memcpy(UIP_IP_BUF, &locmpptr->buff, uip_len);
-
-          STATS_ADD(mcast_fwd);
           tcpip_output(NULL);
+#endif
           MCAST_PACKET_SEND_CLR(locmpptr);
           watchdog_periodic();
         }
@@ -875,6 +900,10 @@ roll_trickle_accept(uint8_t in)
   seed_id_t * seed_ptr;
   uint8_t m;
   uint16_t seq_val;
+#if UIP_CONF_BUF_POOL
+  uip_buf_t * buf;
+  uint8_t keep;
+#endif
 
   PRINTF("Trickle: Multicast I/O\n");
 
@@ -993,15 +1022,39 @@ roll_trickle_accept(uint8_t in)
     locmpptr = buffer_reclaim();
   }
 
+#if UIP_CONF_BUF_POOL
+  /*
+   * The message is kept in a pool buffer. If we are the seed or not a group
+   * member, nothing else needs it in uip_buf and it keeps the buffer it is in.
+   * Otherwise it is also delivered up the stack and we keep a copy
+   */
+  if(locmpptr) {
+    keep = (in == ROLL_TRICKLE_DGRAM_OUT ||
+        !uip_ds6_is_my_maddr(&UIP_IP_BUF->destipaddr));
+    if(keep) {
+      buf = uip_bufpool_detach();
+    } else {
+      buf = uip_bufpool_alloc();
+      if(buf) {
+        memcpy(buf, uip_buf, UIP_LLH_LEN + uip_len);
+      }
+    }
+    if(!buf) {
+      PRINTF("Trickle: No free pool buffer\n");
+      locmpptr = NULL;
+    }
+  }
+#endif
+
   if(!locmpptr) {
     /* Failed to allocate / reclaim a buffer. If the window has only just been
      * allocated, free it before dropping */
     PRINTF("Trickle: Buffer reclaim failed\n");
     if(locswptr->count == 0) {
       window_free(locswptr);
-      STATS_ADD(mcast_dropped);
-      return 0;
     }
+    STATS_ADD(mcast_dropped);
+    return 0;
   }
 
 #if UIP_MCAST6_STATS
@@ -1040,7 +1093,11 @@ roll_trickle_accept(uint8_t in)
   locswptr->count++;
 
   memset(locmpptr, 0, sizeof(struct mcast_packet));
+#if UIP_CONF_BUF_POOL
+  locmpptr->buf = buf;
+#else
   memcpy(&locmpptr->buff, UIP_IP_BUF, uip_len);
+#endif
   locmpptr->sw = locswptr;
   locmpptr->buff_len = uip_len;
   locmpptr->seq_val = seq_val;
@@ -1067,6 +1124,13 @@ roll_trickle_accept(uint8_t in)
   PRINTF("Trickle: Inconsistency. Reset T%u\n", m);
   reset_trickle_timer(m);
 
+#if UIP_CONF_BUF_POOL
+  /* Not for us, and no longer in uip_buf */
+  if(in == ROLL_TRICKLE_DGRAM_IN && keep) {
+    return 0;
+  }
+#endif
+
   /* Deliver if necessary */
   return 1;
 }
@@ -1349,7 +1413,12 @@ roll_trickle_out()
    * timer and we send it immediately.
    */
   if(roll_trickle_accept(ROLL_TRICKLE_DGRAM_OUT)) {
+#if UIP_CONF_BUF_POOL
+    /* The message has kept the buffer it was built in, send it from there */
+    tcpip_ipv6_output_buf(locmpptr->buf, locmpptr->buff_len);
+#else
     tcpip_output(NULL);
+#endif
     STATS_ADD(mcast_out);
   }
 
@@ -161,6 +161,9 @@
  * This buffer is shared across all Seed IDs, therefore a new very active Seed
  * may eventually occupy all slots. It would make little sense (if any) to
  * define support for fewer buffered messages than seeds*2
+ *
+ * With UIP_CONF_BUF_POOL, buffered messages are kept in buffers of the pool
+ * instead of copies, so the pool needs up to this many more buffers
  */
 #ifdef ROLL_TRICKLE_CONF_BUFF_NUM
 #define ROLL_TRICKLE_BUFF_NUM ROLL_TRICKLE_CONF_BUFF_NUM
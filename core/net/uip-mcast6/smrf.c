@@ -45,6 +45,7 @@
 #include "net/uip-mcast6/smrf.h"
 #include "net/rpl/rpl.h"
 #include "net/netstack.h"
+#include "net/uip-bufpool.h"
 #include <string.h>
 
 #define DEBUG DEBUG_NONE
@@ -62,7 +63,12 @@
 /*---------------------------------------------------------------------------*/
 static struct ctimer mcast_periodic;
 static uint8_t mcast_len;
+#if UIP_CONF_BUF_POOL
+/* A reference to the pool buffer holding the datagram to forward. */
+static uip_buf_t *mcast_buf;
+#else
 static uip_buf_t mcast_buf;
+#endif
 static uint8_t fwd_delay;
 static uint8_t fwd_spread;
 
@@ -84,11 +90,26 @@ struct smrf_stats smrf_stat;
 static void
 mcast_fwd(void * p)
 {
+#if UIP_CONF_BUF_POOL
+  uip_buf_t *buf;
+
+  if(mcast_buf == NULL) {
+    return;
+  }
+  /* The datagram is sent from its own buffer, not copied to uip_buf. */
+  ((struct uip_ip_hdr *)&mcast_buf->u8[UIP_LLH_LEN])->ttl--;
+  buf = tcpip_ipv6_output_buf(mcast_buf, mcast_len);
+  mcast_buf = NULL;
+  if(buf != NULL) {
+    uip_bufpool_free(buf);
+  }
+#else
   memcpy(uip_buf, &mcast_buf, mcast_len);
   uip_len = mcast_len;
   UIP_IP_BUF->ttl--;
   tcpip_output(NULL);
   uip_len = 0;
+#endif
 }
 /*---------------------------------------------------------------------------*/
 uint8_t
@@ -111,7 +132,7 @@ smrf_in()
    * have accepted because we didn't realise they came from our Pref. Par.
    */
   d = rpl_get_any_dag();
-  if(!d) {
+  if(!d || !d->preferred_parent) {
     STATS_ADD(mcast_dropped);
     return UIP_MCAST6_DROP;
   }
@@ -126,7 +147,7 @@ smrf_in()
    * We accept a datagram if it arrived from our preferred parent, discard
    * otherwise.
    */
-  if(memcmp(p->lladdr.addr, packetbuf_addr(PACKETBUF_ADDR_SENDER),
+  if(memcmp(uip_ds6_nbr_get_ll(p), packetbuf_addr(PACKETBUF_ADDR_SENDER),
       UIP_LLADDR_LEN)){
     PRINTF("SMRF: Routable in but RPL ignored it\n");
     STATS_ADD(mcast_dropped);
@@ -175,9 +196,38 @@ smrf_in()
             * (1 + ((random_rand() >> 11) % fwd_spread));
       }
 
+#if UIP_CONF_BUF_POOL
+      if(mcast_buf != NULL) {
+        /* Superseded: the pending datagram is not forwarded. */
+        ctimer_stop(&mcast_periodic);
+        uip_bufpool_free(mcast_buf);
+        mcast_buf = NULL;
+      }
+      if(!uip_ds6_is_my_maddr(&UIP_IP_BUF->destipaddr)) {
+        /* Nothing else will look at this datagram: keep its buffer
+           instead of a copy. uip_buf is empty afterwards. */
+        mcast_buf = uip_bufpool_detach();
+        if(mcast_buf != NULL) {
+          mcast_len = uip_len;
+          ctimer_set(&mcast_periodic, fwd_delay, mcast_fwd, NULL);
+          PRINTF("SMRF: Not a group member. No further processing\n");
+          return UIP_MCAST6_DROP;
+        }
+      }
+      /* The datagram is also delivered locally: forward a copy. */
+      mcast_buf = uip_bufpool_alloc();
+      if(mcast_buf != NULL) {
+        memcpy(mcast_buf, uip_buf, uip_len);
+        mcast_len = uip_len;
+        ctimer_set(&mcast_periodic, fwd_delay, mcast_fwd, NULL);
+      } else {
+        PRINTF("SMRF: No buffer to defer forwarding\n");
+      }
+#else
       memcpy(&mcast_buf, uip_buf, uip_len);
       mcast_len = uip_len;
       ctimer_set(&mcast_periodic, fwd_delay, mcast_fwd, NULL);
+#endif
     }
     PRINTF("SMRF: %u bytes: fwd in %u [%u]\n",
         uip_len, fwd_delay, fwd_spread);
@@ -192,10 +192,14 @@ uip_nd6_ns_input(void)
 			  0, NBR_STALE);
         } else {
           if(memcmp(&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		    &nbr->lladdr, UIP_LLADDR_LEN) != 0) {
-            memcpy(&nbr->lladdr, &nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		   UIP_LLADDR_LEN);
-            nbr->state = NBR_STALE;
+		    uip_ds6_nbr_get_ll(nbr), UIP_LLADDR_LEN) != 0) {
+            if(uip_ds6_nbr_set_ll(nbr, (uip_lladdr_t *)&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET])) {
+              nbr->state = NBR_STALE;
+            } else {
+              /* No room for the new link address; the old one is out
+                 of date. */
+              uip_ds6_nbr_rm(nbr);
+            }
           } else {
             if(nbr->state == NBR_INCOMPLETE) {
               nbr->state = NBR_STALE;
@@ -452,15 +456,18 @@ uip_nd6_na_input(void)
     }
     if(nd6_opt_llao != 0) {
       is_llchange =
-        memcmp(&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET], (void *)(&nbr->lladdr),
+        memcmp(&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET], uip_ds6_nbr_get_ll(nbr),
                UIP_LLADDR_LEN);
     }
     if(nbr->state == NBR_INCOMPLETE) {
       if(nd6_opt_llao == NULL) {
         goto discard;
       }
-      memcpy(&nbr->lladdr, &nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-	     UIP_LLADDR_LEN);
+      if(!uip_ds6_nbr_set_ll(nbr, (uip_lladdr_t *)&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET])) {
+        /* No room for the link address: the entry stays incomplete,
+           and is removed if no later NA can be stored either. */
+        goto discard;
+      }
       if(is_solicited) {
         nbr->state = NBR_REACHABLE;
         nbr->nscount = 0;
@@ -481,9 +488,12 @@ uip_nd6_na_input(void)
       } else {
         if(is_override || (!is_override && nd6_opt_llao != 0 && !is_llchange)
            || nd6_opt_llao == 0) {
-          if(nd6_opt_llao != 0) {
-            memcpy(&nbr->lladdr, &nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		   UIP_LLADDR_LEN);
+          if(nd6_opt_llao != 0 &&
+             !uip_ds6_nbr_set_ll(nbr, (uip_lladdr_t *)&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET])) {
+            /* No room for the new link address; the old one is out
+               of date. */
+            uip_ds6_nbr_rm(nbr);
+            goto discard;
           }
           if(is_solicited) {
             nbr->state = NBR_REACHABLE;
@@ -506,7 +516,8 @@ uip_nd6_na_input(void)
     }
   }
 #if UIP_CONF_IPV6_QUEUE_PKT
-  /* The nbr is now reachable, check if we had buffered a pkt for it */
+  /* The nbr is now reachable, check if we had buffered pkts for it. The
+     oldest one is sent from here; tcpip_ipv6_output() sends the rest. */
   /*if(nbr->queue_buf_len != 0) {
     uip_len = nbr->queue_buf_len;
     memcpy(UIP_IP_BUF, nbr->queue_buf, uip_len);
@@ -514,9 +525,7 @@ uip_nd6_na_input(void)
     return;
     }*/
   if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
-    uip_len = uip_packetqueue_buflen(&nbr->packethandle);
-    memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_restore(&nbr->packethandle);
     return;
   }
   
@@ -592,10 +601,14 @@ uip_nd6_rs_input(void)
       } else {
         /* If LL address changed, set neighbor state to stale */
         if(memcmp(&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		  &nbr->lladdr, UIP_LLADDR_LEN) != 0) {
-          memcpy(&nbr->lladdr, &nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		 UIP_LLADDR_LEN);
-          nbr->state = NBR_STALE;
+		  uip_ds6_nbr_get_ll(nbr), UIP_LLADDR_LEN) != 0) {
+          if(uip_ds6_nbr_set_ll(nbr, (uip_lladdr_t *)&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET])) {
+            nbr->state = NBR_STALE;
+          } else {
+            /* No room for the new link address; the old one is out
+               of date. */
+            uip_ds6_nbr_rm(nbr);
+          }
         }
         nbr->isrouter = 0;
       }
@@ -797,9 +810,14 @@ uip_nd6_ra_input(void)
           nbr->state = NBR_STALE;
         }
         if(memcmp(&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		  &nbr->lladdr, UIP_LLADDR_LEN) != 0) {
-          memcpy(&nbr->lladdr, &nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET],
-		 UIP_LLADDR_LEN);
+		  uip_ds6_nbr_get_ll(nbr), UIP_LLADDR_LEN) != 0) {
+          if(!uip_ds6_nbr_set_ll(nbr, (uip_lladdr_t *)&nd6_opt_llao[UIP_ND6_OPT_DATA_OFFSET])) {
+            /* No room for the new link address; the old one is out
+               of date. */
+            uip_ds6_nbr_rm(nbr);
+            nbr = NULL;
+            break;
+          }
           nbr->state = NBR_STALE;
         }
         nbr->isrouter = 1;
@@ -932,9 +950,7 @@ uip_nd6_ra_input(void)
     return;
     }*/
   if(nbr != NULL && uip_packetqueue_buflen(&nbr->packethandle) != 0) {
-    uip_len = uip_packetqueue_buflen(&nbr->packethandle);
-    memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_restore(&nbr->packethandle);
     return;
   }
 
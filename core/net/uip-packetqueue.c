@@ -6,8 +6,13 @@
 
 #include "net/uip-packetqueue.h"
 
-#define MAX_NUM_QUEUED_PACKETS 2
-MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
+#include <string.h>
+
+MEMB(packets_memb, struct uip_packetqueue_packet, UIP_PACKETQUEUE_SIZE);
+
+#if UIP_STATISTICS == 1
+struct uip_packetqueue_stats uip_packetqueue_stat;
+#endif /* UIP_STATISTICS == 1 */
 
 #define DEBUG 0
 #if DEBUG
@@ -17,70 +22,153 @@ MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static void
+packet_free(struct uip_packetqueue_packet *p)
+{
+  ctimer_stop(&p->lifetimer);
+  list_remove(p->handle->packets, p);
+#if UIP_CONF_BUF_POOL
+  if(p->queue_buf != NULL) {
+    uip_bufpool_free(p->queue_buf);
+  }
+#endif /* UIP_CONF_BUF_POOL */
+  memb_free(&packets_memb, p);
+}
 /*---------------------------------------------------------------------------*/
 static void
 packet_timedout(void *ptr)
 {
-  struct uip_packetqueue_handle *h = ptr;
+  struct uip_packetqueue_packet *p = ptr;
 
-  PRINTF("uip_packetqueue_free timed out %p\n", h);
-  memb_free(&packets_memb, h->packet);
-  h->packet = NULL;
+  PRINTF("uip_packetqueue_free timed out %p\n", p->handle);
+  UIP_STAT(++uip_packetqueue_stat.drop_timeout);
+  packet_free(p);
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_new(struct uip_packetqueue_handle *handle)
 {
   PRINTF("uip_packetqueue_new %p\n", handle);
-  handle->packet = NULL;
+  LIST_STRUCT_INIT(handle, packets);
 }
 /*---------------------------------------------------------------------------*/
 struct uip_packetqueue_packet *
 uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime)
 {
+  struct uip_packetqueue_packet *p;
+
   PRINTF("uip_packetqueue_alloc %p\n", handle);
-  if(handle->packet != NULL) {
-    PRINTF("alloced\n");
+  /* A full queue drops the new packet rather than an old one, so the
+     packets that are sent keep their original order. */
+  if(list_length(handle->packets) >= UIP_PACKETQUEUE_NBR_MAX) {
+    PRINTF("queue full\n");
+    UIP_STAT(++uip_packetqueue_stat.drop_full);
     return NULL;
   }
-  handle->packet = memb_alloc(&packets_memb);
-  if(handle->packet != NULL) {
-    ctimer_set(&handle->packet->lifetimer, lifetime,
-               packet_timedout, handle);
-  } else {
+  p = memb_alloc(&packets_memb);
+  if(p == NULL) {
     PRINTF("uip_packetqueue_alloc failed\n");
+    UIP_STAT(++uip_packetqueue_stat.drop_nomem);
+    return NULL;
   }
-  return handle->packet;
+#if UIP_CONF_BUF_POOL
+  p->queue_buf = NULL;
+#endif /* UIP_CONF_BUF_POOL */
+  p->queue_buf_len = 0;
+  p->handle = handle;
+  ctimer_set(&p->lifetimer, lifetime, packet_timedout, p);
+  list_add(handle->packets, p);
+  return p;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle)
 {
+  struct uip_packetqueue_packet *p;
+
   PRINTF("uip_packetqueue_free %p\n", handle);
-  if(handle->packet != NULL) {
-    ctimer_stop(&handle->packet->lifetimer);
-    memb_free(&packets_memb, handle->packet);
-    handle->packet = NULL;
+  while((p = list_head(handle->packets)) != NULL) {
+    UIP_STAT(++uip_packetqueue_stat.drop_flush);
+    packet_free(p);
   }
 }
 /*---------------------------------------------------------------------------*/
 uint8_t *
 uip_packetqueue_buf(struct uip_packetqueue_handle *h)
 {
-  return h->packet != NULL? h->packet->queue_buf: NULL;
+  struct uip_packetqueue_packet *p = list_head(h->packets);
+#if UIP_CONF_BUF_POOL
+  return p != NULL && p->queue_buf != NULL ?
+    &p->queue_buf->u8[UIP_LLH_LEN] : NULL;
+#else /* UIP_CONF_BUF_POOL */
+  return p != NULL? p->queue_buf: NULL;
+#endif /* UIP_CONF_BUF_POOL */
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
 uip_packetqueue_buflen(struct uip_packetqueue_handle *h)
 {
-  return h->packet != NULL? h->packet->queue_buf_len: 0;
+  struct uip_packetqueue_packet *p = list_head(h->packets);
+  return p != NULL? p->queue_buf_len: 0;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len)
 {
-  if(h->packet != NULL) {
-    h->packet->queue_buf_len = len;
+  struct uip_packetqueue_packet *p = list_head(h->packets);
+  if(p != NULL) {
+    p->queue_buf_len = len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_packetqueue_len(struct uip_packetqueue_handle *h)
+{
+  return list_length(h->packets);
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_packetqueue_store(struct uip_packetqueue_handle *h, clock_time_t lifetime)
+{
+  struct uip_packetqueue_packet *p;
+
+  p = uip_packetqueue_alloc(h, lifetime);
+  if(p == NULL) {
+    return 0;
+  }
+#if UIP_CONF_BUF_POOL
+  p->queue_buf = uip_bufpool_detach();
+  if(p->queue_buf == NULL) {
+    PRINTF("uip_packetqueue_store: no free buffer\n");
+    UIP_STAT(++uip_packetqueue_stat.drop_nomem);
+    packet_free(p);
+    return 0;
+  }
+#else /* UIP_CONF_BUF_POOL */
+  memcpy(p->queue_buf, &uip_buf[UIP_LLH_LEN], uip_len);
+#endif /* UIP_CONF_BUF_POOL */
+  p->queue_buf_len = uip_len;
+  UIP_STAT(++uip_packetqueue_stat.queued);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_restore(struct uip_packetqueue_handle *h)
+{
+  struct uip_packetqueue_packet *p = list_head(h->packets);
+
+  if(p == NULL) {
+    return;
   }
+  uip_len = p->queue_buf_len;
+#if UIP_CONF_BUF_POOL
+  uip_bufpool_attach(p->queue_buf);
+  p->queue_buf = NULL;
+#else /* UIP_CONF_BUF_POOL */
+  memcpy(&uip_buf[UIP_LLH_LEN], p->queue_buf, uip_len);
+#endif /* UIP_CONF_BUF_POOL */
+  UIP_STAT(++uip_packetqueue_stat.sent);
+  packet_free(p);
 }
 /*---------------------------------------------------------------------------*/
@@ -2,34 +2,81 @@
 #define UIP_PACKETQUEUE_H
 
 #include "sys/ctimer.h"
+#include "lib/list.h"
+#include "net/uip-bufpool.h"
+
+/* Number of packets in the pool shared by all neighbors. */
+#ifdef UIP_CONF_PACKETQUEUE_SIZE
+#define UIP_PACKETQUEUE_SIZE UIP_CONF_PACKETQUEUE_SIZE
+#else
+#define UIP_PACKETQUEUE_SIZE 2
+#endif
+
+/* Maximum number of packets queued for a single neighbor. */
+#ifdef UIP_CONF_PACKETQUEUE_NBR_MAX
+#define UIP_PACKETQUEUE_NBR_MAX UIP_CONF_PACKETQUEUE_NBR_MAX
+#else
+#define UIP_PACKETQUEUE_NBR_MAX UIP_PACKETQUEUE_SIZE
+#endif
 
 struct uip_packetqueue_handle;
 
 struct uip_packetqueue_packet {
-  struct uip_ds6_queued_packet *next;
+  struct uip_packetqueue_packet *next;
+#if UIP_CONF_BUF_POOL
+  /* A reference to the pool buffer that holds the packet. */
+  uip_buf_t *queue_buf;
+#else /* UIP_CONF_BUF_POOL */
   uint8_t queue_buf[UIP_BUFSIZE - UIP_LLH_LEN];
+#endif /* UIP_CONF_BUF_POOL */
   uint16_t queue_buf_len;
   struct ctimer lifetimer;
   struct uip_packetqueue_handle *handle;
 };
 
+/* A FIFO of packets, oldest first. */
 struct uip_packetqueue_handle {
-  struct uip_packetqueue_packet *packet;
+  LIST_STRUCT(packets);
 };
 
-void uip_packetqueue_new(struct uip_packetqueue_handle *handle);
+#if UIP_STATISTICS == 1
+struct uip_packetqueue_stats {
+  uint16_t queued;        /* Packets queued. */
+  uint16_t sent;          /* Packets taken from a queue for sending. */
+  uint16_t drop_full;     /* Dropped, the neighbor's queue was full. */
+  uint16_t drop_nomem;    /* Dropped, the shared pool was empty. */
+  uint16_t drop_timeout;  /* Dropped when their lifetime expired. */
+  uint16_t drop_flush;    /* Dropped when their queue was freed. */
+};
+extern struct uip_packetqueue_stats uip_packetqueue_stat;
+#endif /* UIP_STATISTICS == 1 */
 
+void uip_packetqueue_new(struct uip_packetqueue_handle *handle);
 
+/* Append an empty packet to the queue. Returns NULL if the queue is
+   full or the pool is empty. */
 struct uip_packetqueue_packet *
 uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime);
 
-
+/* Drop all packets in the queue. */
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle);
 
+/* Accessors for the oldest packet in the queue. */
 uint8_t *uip_packetqueue_buf(struct uip_packetqueue_handle *h);
 uint16_t uip_packetqueue_buflen(struct uip_packetqueue_handle *h);
 void uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len);
 
+/* Number of packets in the queue. */
+int uip_packetqueue_len(struct uip_packetqueue_handle *h);
+
+/* Queue the packet in uip_buf at the tail; with a buffer pool, the
+   buffer itself is queued and uip_buf continues with an empty one.
+   Returns non-zero on success. */
+int uip_packetqueue_store(struct uip_packetqueue_handle *h, clock_time_t lifetime);
+
+/* Move the oldest queued packet into uip_buf and set uip_len. */
+void uip_packetqueue_restore(struct uip_packetqueue_handle *h);
+
 
 #endif /* UIP_PACKETQUEUE_H */
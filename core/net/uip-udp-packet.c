@@ -47,6 +47,36 @@ extern u16_t uip_slen;
 
 #include <string.h>
 
+#define UDP_PAYLOAD (&uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN])
+#define UDP_PAYLOAD_MAX (UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPUDPH_LEN)
+
+/*---------------------------------------------------------------------------*/
+void *
+uip_udp_packet_reserve(int len)
+{
+  if(len < 0 || len > UDP_PAYLOAD_MAX) {
+    return NULL;
+  }
+  return UDP_PAYLOAD;
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_CONF_BUF_POOL
+uip_buf_t *
+uip_udp_packet_take(uint8_t **datap)
+{
+  uip_buf_t *buf;
+  u16_t offset;
+
+  offset = (uint8_t *)uip_appdata - uip_buf;
+  buf = uip_bufpool_detach();
+  if(buf == NULL) {
+    return NULL;
+  }
+  *datap = &buf->u8[offset];
+  uip_appdata = &uip_buf[offset];
+  return buf;
+}
+#endif /* UIP_CONF_BUF_POOL */
 /*---------------------------------------------------------------------------*/
 void
 uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len)
@@ -55,8 +85,12 @@ uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len)
   if(data != NULL) {
     uip_udp_conn = c;
     uip_slen = len;
-    memcpy(&uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN], data,
-           len > UIP_BUFSIZE? UIP_BUFSIZE: len);
+    /* Data written through uip_udp_packet_reserve() is already in
+       place. */
+    if(data != UDP_PAYLOAD) {
+      memcpy(UDP_PAYLOAD, data,
+             len > UIP_BUFSIZE? UIP_BUFSIZE: len);
+    }
     uip_process(UIP_UDP_SEND_CONN);
 
 #if UIP_IPV6_MULTICAST
@@ -42,9 +42,41 @@
 #define __UIP_UDP_PACKET_H__
 
 #include "net/uip.h"
+#include "net/uip-bufpool.h"
 
 void uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len);
 void uip_udp_packet_sendto(struct uip_udp_conn *c, const void *data, int len,
 			   const uip_ipaddr_t *toaddr, uint16_t toport);
 
+/**
+ * \brief      Get the payload area of the next outgoing UDP datagram
+ * \param len  The number of bytes the application will write
+ * \return     A pointer into uip_buf, or NULL if len does not fit
+ *
+ *             The application writes its payload here and passes the
+ *             pointer as the data argument of uip_udp_packet_send(),
+ *             uip_udp_packet_sendto() or simple_udp_sendto(), which
+ *             then send the payload without copying it. The process
+ *             must not yield between the two calls, since the stack
+ *             reuses uip_buf for other packets.
+ */
+void *uip_udp_packet_reserve(int len);
+
+#if UIP_CONF_BUF_POOL
+/**
+ * \brief       Take the buffer that holds the received UDP datagram
+ * \param datap Set to the payload, at offset uip_appdata in the buffer
+ * \return      The buffer, or NULL if no buffer could replace it
+ *
+ *              Called from the tcpip_event handler when uip_newdata()
+ *              is true. The payload, uip_datalen() bytes, then stays
+ *              valid after the handler has returned, until the
+ *              application frees the buffer with uip_bufpool_free().
+ *              The handler must not send a reply through uip_send()
+ *              after this call. If NULL is returned, the datagram is
+ *              still in uip_buf and must be copied as usual.
+ */
+uip_buf_t *uip_udp_packet_take(uint8_t **datap);
+#endif /* UIP_CONF_BUF_POOL */
+
 #endif /* __UIP_UDP_PACKET_H__ */
@@ -127,7 +127,9 @@ struct uip_eth_addr uip_ethaddr = {{0,0,0,0,0,0}};
 #endif
 
 /* The packet buffer that contains incoming packets. */
+#if !UIP_CONF_BUF_POOL
 uip_buf_t uip_aligned_buf;
+#endif /* !UIP_CONF_BUF_POOL */
 
 void *uip_appdata;               /* The uip_appdata pointer points to
 				    application data. */
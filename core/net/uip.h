@@ -482,8 +482,14 @@ typedef union {
   uint8_t u8[UIP_BUFSIZE];
 } uip_buf_t;
 
+#if UIP_CONF_BUF_POOL
+/* uip_buf is the current buffer of a pool, see uip-bufpool.h. */
+CCIF extern uip_buf_t *uip_bufp;
+#define uip_buf (uip_bufp->u8)
+#else /* UIP_CONF_BUF_POOL */
 CCIF extern uip_buf_t uip_aligned_buf;
 #define uip_buf (uip_aligned_buf.u8)
+#endif /* UIP_CONF_BUF_POOL */
 
 
 /** @} */
@@ -837,7 +843,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, u16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONF_IPV6 && UIP_UDP_CONN_HASH
+#define uip_udp_remove(conn) uip_udp_set_lport(conn, 0)
+#else
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif
 
 /**
  * Bind a UDP connection to a local port.
@@ -849,7 +859,19 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, u16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONF_IPV6 && UIP_UDP_CONN_HASH
+#define uip_udp_bind(conn, port) uip_udp_set_lport(conn, port)
+
+/**
+ * Set the local port of a UDP connection and update the index of
+ * connections by local port. A port of 0 removes the connection.
+ *
+ * \param port The local port number, in network byte order.
+ */
+void uip_udp_set_lport(struct uip_udp_conn *conn, u16_t port);
+#else
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -2221,6 +2243,32 @@ u16_t uip_udpchksum(void);
  */
 u16_t uip_icmp6chksum(void);
 
+#if UIP_CONF_IPV6
+/**
+ * Update a checksum after a 16-bit word it covers has changed.
+ *
+ * The incremental update of RFC 1624 avoids summing the whole packet
+ * again when only a header field is rewritten. The checksum and both
+ * words are taken as stored in the packet, i.e., in network byte order.
+ *
+ * \param chksum The checksum field before the change.
+ * \param old_word The word before the change.
+ * \param new_word The word after the change.
+ *
+ * \return The new value of the checksum field.
+ */
+u16_t uip_chksum_update16(u16_t chksum, u16_t old_word, u16_t new_word);
+
+/**
+ * Update a checksum after a run of 16-bit words has changed, e.g., an
+ * IPv6 address. len must be even.
+ *
+ * \return The new value of the checksum field.
+ */
+u16_t uip_chksum_update(u16_t chksum, const void *old_data,
+                        const void *new_data, u16_t len);
+#endif /* UIP_CONF_IPV6 */
+
 
 #endif /* __UIP_H__ */
 
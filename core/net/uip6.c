@@ -172,9 +172,9 @@ u8_t uip_ext_opt_offset = 0;
  *  @{
  */
 /** Packet buffer for incoming and outgoing packets */
-#ifndef UIP_CONF_EXTERNAL_BUFFER
+#if !defined(UIP_CONF_EXTERNAL_BUFFER) && !UIP_CONF_BUF_POOL
 uip_buf_t uip_aligned_buf;
-#endif /* UIP_CONF_EXTERNAL_BUFFER */
+#endif /* !UIP_CONF_EXTERNAL_BUFFER && !UIP_CONF_BUF_POOL */
 
 /* The uip_appdata pointer points to application data. */
 void *uip_appdata;
@@ -260,6 +260,18 @@ static u16_t tmp16;
 #if UIP_UDP
 struct uip_udp_conn *uip_udp_conn;
 struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
+#if UIP_UDP_CONN_HASH
+#if UIP_UDP_CONNS > 254
+#error UIP_UDP_CONN_HASH requires UIP_UDP_CONNS <= 254
+#endif
+/* The connections that have a local port, chained per bucket in the
+   order of uip_udp_conns[] so that a lookup finds the same connection
+   as a scan of the array would. Links are indices + 1; 0 ends a
+   chain. */
+static u8_t udp_hash[UIP_UDP_CONN_HASH];
+static u8_t udp_hash_next[UIP_UDP_CONNS];
+#define UDP_HASH(port) (((port) ^ ((port) >> 8)) & (UIP_UDP_CONN_HASH - 1))
+#endif /* UIP_UDP_CONN_HASH */
 #endif /* UIP_UDP */
 /** @} */
 
@@ -304,8 +316,74 @@ uip_add32(u8_t *op32, u16_t op16)
 
 #endif /* UIP_ARCH_ADD32 && UIP_TCP */
 
+/*
+ * UIP_CONF_CHKSUM_WORD32 selects a checksum loop that loads 32 bits at
+ * a time and defers the carries to a 32-bit accumulator. It pays off
+ * on 32-bit CPUs; 8- and 16-bit CPUs are better served by the default
+ * byte-wise loop. Alternatively, a CPU can provide the loop itself as
+ * a function named by UIP_ARCH_CHKSUM_ADD, with the prototype of
+ * chksum() below.
+ */
+#ifdef UIP_CONF_CHKSUM_WORD32
+#define UIP_CHKSUM_WORD32 UIP_CONF_CHKSUM_WORD32
+#else
+#define UIP_CHKSUM_WORD32 0
+#endif
+
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
+#if defined(UIP_ARCH_CHKSUM_ADD)
+u16_t UIP_ARCH_CHKSUM_ADD(u16_t sum, const u8_t *data, u16_t len);
+#define chksum UIP_ARCH_CHKSUM_ADD
+#elif UIP_CHKSUM_WORD32
+static u16_t
+chksum(u16_t sum, const u8_t *data, u16_t len)
+{
+  u32_t acc;
+  u32_t w;
+  u16_t h;
+  u8_t last[2];
+
+  /* The one's complement sum does not depend on the byte order
+     (RFC 1071), so the words are summed as they are laid out in memory
+     and the result is converted back to host order at the end. The
+     accumulator cannot overflow for len < 64 kB. */
+  acc = uip_htons(sum);
+
+  while(len >= 8) {
+    memcpy(&w, data, 4);
+    acc += (w >> 16) + (w & 0xffff);
+    memcpy(&w, data + 4, 4);
+    acc += (w >> 16) + (w & 0xffff);
+    data += 8;
+    len -= 8;
+  }
+  if(len >= 4) {
+    memcpy(&w, data, 4);
+    acc += (w >> 16) + (w & 0xffff);
+    data += 4;
+    len -= 4;
+  }
+  if(len >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+    len -= 2;
+  }
+  if(len == 1) {
+    last[0] = data[0];
+    last[1] = 0;
+    memcpy(&h, last, 2);
+    acc += h;
+  }
+
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  /* Return sum in host byte order. */
+  return uip_htons((u16_t)acc);
+}
+#else /* UIP_CHKSUM_WORD32 */
 static u16_t
 chksum(u16_t sum, const u8_t *data, u16_t len)
 {
@@ -336,6 +414,7 @@ chksum(u16_t sum, const u8_t *data, u16_t len)
   /* Return sum in host byte order. */
   return sum;
 }
+#endif /* UIP_CHKSUM_WORD32 */
 /*---------------------------------------------------------------------------*/
 u16_t
 uip_chksum(u16_t *data, u16_t len)
@@ -409,6 +488,38 @@ uip_udpchksum(void)
 #endif /* UIP_UDP && UIP_UDP_CHECKSUMS */
 #endif /* UIP_ARCH_CHKSUM */
 /*---------------------------------------------------------------------------*/
+u16_t
+uip_chksum_update16(u16_t chksum, u16_t old_word, u16_t new_word)
+{
+  u32_t sum;
+
+  /* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+  sum = (u16_t)~chksum;
+  sum += (u16_t)~old_word;
+  sum += new_word;
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum = (sum >> 16) + (sum & 0xffff);
+  return (u16_t)~sum;
+}
+/*---------------------------------------------------------------------------*/
+u16_t
+uip_chksum_update(u16_t chksum, const void *old_data, const void *new_data,
+                  u16_t len)
+{
+  const u8_t *o = old_data;
+  const u8_t *n = new_data;
+  u16_t old_word, new_word;
+
+  /* The data is taken as 16-bit words in memory order, as the checksum
+     field is. len must be even. */
+  for(; len >= 2; len -= 2, o += 2, n += 2) {
+    memcpy(&old_word, o, 2);
+    memcpy(&new_word, n, 2);
+    chksum = uip_chksum_update16(chksum, old_word, new_word);
+  }
+  return chksum;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_init(void)
 {
@@ -432,6 +543,9 @@ uip_init(void)
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     uip_udp_conns[c].lport = 0;
   }
+#if UIP_UDP_CONN_HASH
+  memset(udp_hash, 0, sizeof(udp_hash));
+#endif /* UIP_UDP_CONN_HASH */
 #endif /* UIP_UDP */
 
 #if UIP_IPV6_MULTICAST
@@ -529,6 +643,38 @@ remove_ext_hdr(void)
 }
 /*---------------------------------------------------------------------------*/
 #if UIP_UDP
+#if UIP_UDP_CONN_HASH
+void
+uip_udp_set_lport(struct uip_udp_conn *conn, u16_t port)
+{
+  u8_t *link;
+  u8_t i;
+
+  i = conn - uip_udp_conns + 1;
+
+  if(conn->lport != 0) {
+    for(link = &udp_hash[UDP_HASH(conn->lport)];
+        *link != 0;
+        link = &udp_hash_next[*link - 1]) {
+      if(*link == i) {
+        *link = udp_hash_next[i - 1];
+        break;
+      }
+    }
+  }
+
+  conn->lport = port;
+
+  if(port != 0) {
+    for(link = &udp_hash[UDP_HASH(port)];
+        *link != 0 && *link < i;
+        link = &udp_hash_next[*link - 1]);
+    udp_hash_next[i - 1] = *link;
+    *link = i;
+  }
+}
+#endif /* UIP_UDP_CONN_HASH */
+/*---------------------------------------------------------------------------*/
 struct uip_udp_conn *
 uip_udp_new(const uip_ipaddr_t *ripaddr, u16_t rport)
 {
@@ -542,11 +688,21 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, u16_t rport)
     lastport = 4096;
   }
   
+#if UIP_UDP_CONN_HASH
+  for(c = udp_hash[UDP_HASH(uip_htons(lastport))];
+      c != 0;
+      c = udp_hash_next[c - 1]) {
+    if(uip_udp_conns[c - 1].lport == uip_htons(lastport)) {
+      goto again;
+    }
+  }
+#else /* UIP_UDP_CONN_HASH */
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     if(uip_udp_conns[c].lport == uip_htons(lastport)) {
       goto again;
     }
   }
+#endif /* UIP_UDP_CONN_HASH */
 
   conn = 0;
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
@@ -560,7 +716,11 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, u16_t rport)
     return 0;
   }
   
+#if UIP_UDP_CONN_HASH
+  uip_udp_set_lport(conn, uip_htons(lastport));
+#else /* UIP_UDP_CONN_HASH */
   conn->lport = UIP_HTONS(lastport);
+#endif /* UIP_UDP_CONN_HASH */
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -1492,9 +1652,18 @@ uip_process(u8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
+#if UIP_UDP_CONN_HASH
+  /* Only the connections bound to a local port in the same bucket
+     need to be checked. */
+  for(c = udp_hash[UDP_HASH(UIP_UDP_BUF->destport)];
+      c != 0;
+      c = udp_hash_next[c - 1]) {
+    uip_udp_conn = &uip_udp_conns[c - 1];
+#else /* UIP_UDP_CONN_HASH */
   for(uip_udp_conn = &uip_udp_conns[0];
       uip_udp_conn < &uip_udp_conns[UIP_UDP_CONNS];
       ++uip_udp_conn) {
+#endif /* UIP_UDP_CONN_HASH */
     /* If the local UDP port is non-zero, the connection is considered
        to be used. If so, the local port number is checked against the
        destination port number in the received packet. If the two port
@@ -272,6 +272,23 @@
 #define UIP_UDP_CONNS    10
 #endif /* UIP_CONF_UDP_CONNS */
 
+/**
+ * The number of buckets in the hash table that indexes the UDP
+ * connections by local port, a power of two. With 0, incoming
+ * datagrams are demultiplexed by scanning all UDP connections.
+ *
+ * Only the IPv6 stack uses the index. The local port of a connection
+ * must then only be changed through uip_udp_bind() and
+ * uip_udp_remove().
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_UDP_CONN_HASH
+#define UIP_UDP_CONN_HASH (UIP_CONF_UDP_CONN_HASH)
+#else /* UIP_CONF_UDP_CONN_HASH */
+#define UIP_UDP_CONN_HASH 0
+#endif /* UIP_CONF_UDP_CONN_HASH */
+
 /**
  * The name of the function that should be called when UDP datagrams arrive.
  *
@@ -519,6 +536,20 @@
 #define UIP_BUFSIZE (UIP_CONF_BUFFER_SIZE)
 #endif /* UIP_CONF_BUFFER_SIZE */
 
+/**
+ * The number of packet buffers backing uip_buf.
+ *
+ * If zero, uip_buf is a single static buffer. Otherwise, uip_buf is
+ * the current buffer of a pool of this many buffers, and modules that
+ * defer packets keep references to pool buffers instead of copies
+ * (see uip-bufpool.h).
+ *
+ * \hideinitializer
+ */
+#ifndef UIP_CONF_BUF_POOL
+#define UIP_CONF_BUF_POOL 0
+#endif /* UIP_CONF_BUF_POOL */
+
 
 /**
  * Determines if statistics support should be compiled in.
@@ -50,6 +50,9 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+/* The active timers, sorted by expiration time with the next one to
+   expire first. Timers that expire at the same time are kept in the
+   order they were added. */
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
@@ -58,24 +61,58 @@ PROCESS(etimer_process, "Event timer");
 static void
 update_time(void)
 {
-  clock_time_t tdist;
-  clock_time_t now;
-  struct etimer *t;
-
   if (timerlist == NULL) {
     next_expiration = 0;
   } else {
-    now = clock_time();
-    t = timerlist;
-    /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
-    for(t = t->next; t != NULL; t = t->next) {
-      if(t->timer.start + t->timer.interval - now < tdist) {
-	tdist = t->timer.start + t->timer.interval - now;
-      }
+    next_expiration = timerlist->timer.start + timerlist->timer.interval;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Time left until the timer expires, as seen at time now. Expired
+   timers have none left; using distances rather than expiration times
+   keeps the order correct when the clock wraps. */
+static clock_time_t
+time_left(struct etimer *t, clock_time_t now)
+{
+  clock_time_t elapsed;
+
+  /* Uses the caller's now rather than timer_expired(), which reads
+     the clock for every timer passed over. */
+  elapsed = now - t->timer.start;
+  if(elapsed >= t->timer.interval) {
+    return 0;
+  }
+  return t->timer.interval - elapsed;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *timer)
+{
+  struct etimer **tp;
+  clock_time_t now;
+  clock_time_t left;
+
+  now = clock_time();
+  left = time_left(timer, now);
+  for(tp = &timerlist; *tp != NULL && time_left(*tp, now) <= left;
+      tp = &(*tp)->next);
+  timer->next = *tp;
+  *tp = timer;
+}
+/*---------------------------------------------------------------------------*/
+static int
+remove_timer(struct etimer *timer)
+{
+  struct etimer **tp;
+
+  for(tp = &timerlist; *tp != NULL; tp = &(*tp)->next) {
+    if(*tp == timer) {
+      *tp = timer->next;
+      timer->next = NULL;
+      return 1;
     }
-    next_expiration = now + tdist;
   }
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
@@ -105,38 +142,28 @@ PROCESS_THREAD(etimer_process, ev, data)
 	    t = t->next;
 	}
       }
+      update_time();
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
-  again:
-    
-    u = NULL;
-    
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-	if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-	  
-	  /* Reset the process ID of the event timer, to signal that the
-	     etimer has expired. This is later checked in the
-	     etimer_expired() function. */
-	  t->p = PROCESS_NONE;
-	  if(u != NULL) {
-	    u->next = t->next;
-	  } else {
-	    timerlist = t->next;
-	  }
-	  t->next = NULL;
-	  update_time();
-	  goto again;
-	} else {
-	  etimer_request_poll();
-	}
+    /* The list is sorted, so the expired timers are at its head. */
+    while((t = timerlist) != NULL && timer_expired(&t->timer)) {
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+	/* The event queue is full; try again later. */
+	etimer_request_poll();
+	break;
       }
-      u = t;
+      /* Reset the process ID of the event timer, to signal that the
+	 etimer has expired. This is later checked in the
+	 etimer_expired() function. */
+      t->p = PROCESS_NONE;
+      u = t->next;
+      t->next = NULL;
+      timerlist = u;
     }
-    
+    update_time();
   }
   
   PROCESS_END();
@@ -151,25 +178,15 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
-  struct etimer *t;
-
   etimer_request_poll();
 
+  /* A timer that is already on the list is moved to its new place,
+     and belongs to the process that set it last. */
   if(timer->p != PROCESS_NONE) {
-    /* Timer not on list. */
-    
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(t == timer) {
-	/* Timer already on list, bail out. */
-	update_time();
-	return;
-      }
-    }
+    remove_timer(timer);
   }
-
   timer->p = PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
+  insert_timer(timer);
 
   update_time();
 }
@@ -199,6 +216,9 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+  if(et->p != PROCESS_NONE && remove_timer(et)) {
+    insert_timer(et);
+  }
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -235,25 +255,8 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
+  if(remove_timer(et)) {
     update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next);
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-	 to remove. We point the items next pointer to the event after
-	 the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
   }
 
   /* Remove the next pointer from the item to be removed. */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Per-process run time and event latency profiling
+ */
+
+#include "sys/process-profile.h"
+
+#include <string.h>
+
+#if PROCESS_PROFILE
+
+struct process_profile process_profile[PROCESS_PROFILE];
+unsigned long process_profile_lost;
+
+/*---------------------------------------------------------------------------*/
+void
+process_profile_record(struct process *p, process_event_t ev,
+                       rtimer_clock_t delay, rtimer_clock_t time)
+{
+  struct process_profile *e;
+
+  for(e = process_profile; e < &process_profile[PROCESS_PROFILE]; e++) {
+    if(e->p == NULL) {
+      e->p = p;
+      e->ev = ev;
+      break;
+    }
+    if(e->p == p && e->ev == ev) {
+      break;
+    }
+  }
+  if(e == &process_profile[PROCESS_PROFILE]) {
+    process_profile_lost++;
+    return;
+  }
+
+  e->count++;
+  e->total_time += time;
+  if(time > e->max_time) {
+    e->max_time = time;
+  }
+  e->total_delay += delay;
+  if(delay > e->max_delay) {
+    e->max_delay = delay;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+process_profile_clear(void)
+{
+  memset(process_profile, 0, sizeof(process_profile));
+  process_profile_lost = 0;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* PROCESS_PROFILE */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Header file for per-process run time and event latency profiling
+ *
+ *         With PROCESS_CONF_PROFILE set to a number of entries, the
+ *         process module records, for each process and event number,
+ *         how often the process was called, how long it ran and how
+ *         long the event waited in the queue (or, for polls, how long
+ *         after process_poll() the process was called). Times are in
+ *         rtimer ticks and include the time spent in processes that
+ *         were called synchronously.
+ */
+
+#ifndef __PROCESS_PROFILE_H__
+#define __PROCESS_PROFILE_H__
+
+#include "contiki-conf.h"
+#include "sys/process.h"
+#include "sys/rtimer.h"
+
+#if PROCESS_PROFILE
+
+struct process_profile {
+  struct process *p;
+  process_event_t ev;
+  unsigned long count;
+  rtimer_clock_t max_time;
+  unsigned long total_time;
+  rtimer_clock_t max_delay;
+  unsigned long total_delay;
+};
+
+/* The entries in use come first; p is NULL in the others. */
+extern struct process_profile process_profile[PROCESS_PROFILE];
+
+/* The number of calls that were not recorded because all entries
+   were taken. */
+extern unsigned long process_profile_lost;
+
+/* Called by the process module after a process has been called. */
+void process_profile_record(struct process *p, process_event_t ev,
+                            rtimer_clock_t delay, rtimer_clock_t time);
+
+void process_profile_clear(void);
+
+#endif /* PROCESS_PROFILE */
+
+#endif /* __PROCESS_PROFILE_H__ */
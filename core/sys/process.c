@@ -48,6 +48,7 @@
 
 #include "sys/process.h"
 #include "sys/arg.h"
+#include "sys/process-profile.h"
 
 /*
  * Pointer to the currently running process structure.
@@ -64,16 +65,59 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_PROFILE
+  rtimer_clock_t posted;
+#endif /* PROCESS_PROFILE */
 };
 
+#if PROCESS_PROFILE
+/* How long the event about to be delivered has waited. */
+static rtimer_clock_t event_delay;
+#define SET_EVENT_DELAY(since) event_delay = RTIMER_NOW() - (since)
+#else /* PROCESS_PROFILE */
+#define SET_EVENT_DELAY(since)
+#endif /* PROCESS_PROFILE */
+
 static process_num_events_t nevents, fevent;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
+#if PROCESS_CONF_PRIORITIES
+/* The queue of events to high priority processes, which is emptied
+   before the queue above. */
+static process_num_events_t nevents_high, fevent_high;
+static struct event_data events_high[PROCESS_CONF_NUMEVENTS_HIGH];
+#define PROCESS_IS_HIGH(p) ((p)->priority != PROCESS_PRIO_NORMAL)
+#endif /* PROCESS_CONF_PRIORITIES */
+
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+unsigned short process_event_overflows;
 #endif
 
 static volatile unsigned char poll_requested;
+#if PROCESS_CONF_PRIORITIES
+static volatile unsigned char poll_requested_high;
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#if PROCESS_CONF_POLL_QUEUE
+#ifdef PROCESS_CONF_POLL_LOCK
+#define POLL_LOCK()   PROCESS_CONF_POLL_LOCK()
+#define POLL_UNLOCK() PROCESS_CONF_POLL_UNLOCK()
+#else /* PROCESS_CONF_POLL_LOCK */
+#define POLL_LOCK()
+#define POLL_UNLOCK()
+#endif /* PROCESS_CONF_POLL_LOCK */
+
+/* The processes with needspoll set, in the order they were polled.
+   end is the last one to call in the current round of do_poll(). */
+struct poll_queue {
+  struct process *first, *last, *end;
+};
+static struct poll_queue polls;
+#if PROCESS_CONF_PRIORITIES
+static struct poll_queue polls_high;
+#endif /* PROCESS_CONF_PRIORITIES */
+#endif /* PROCESS_CONF_POLL_QUEUE */
 
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
@@ -89,6 +133,70 @@ static void call_process(struct process *p, process_event_t ev, process_data_t d
 #define PRINTF(...)
 #endif
 
+#if PROCESS_CONF_POLL_QUEUE
+/*---------------------------------------------------------------------------*/
+static struct poll_queue *
+poll_queue(struct process *p)
+{
+#if PROCESS_CONF_PRIORITIES
+  if(PROCESS_IS_HIGH(p)) {
+    return &polls_high;
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
+  return &polls;
+}
+/*---------------------------------------------------------------------------*/
+/* Takes the next process off the queue and clears its needspoll, so
+   that a poll from now on queues it again. */
+static struct process *
+poll_dequeue(struct poll_queue *q)
+{
+  struct process *p;
+
+  POLL_LOCK();
+  p = q->first;
+  if(p != NULL) {
+    q->first = p->pollnext;
+    if(q->first == NULL) {
+      q->last = NULL;
+    }
+    if(q->end == p) {
+      q->end = NULL;
+    }
+    p->needspoll = 0;
+  }
+  POLL_UNLOCK();
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a process that exits from the queue. */
+static void
+poll_unlink(struct process *p)
+{
+  struct poll_queue *q;
+  struct process *prev, **pp;
+
+  q = poll_queue(p);
+  POLL_LOCK();
+  if(p->needspoll) {
+    prev = NULL;
+    for(pp = &q->first; *pp != NULL && *pp != p; pp = &(*pp)->pollnext) {
+      prev = *pp;
+    }
+    if(*pp == p) {
+      *pp = p->pollnext;
+      if(q->last == p) {
+        q->last = prev;
+      }
+      if(q->end == p) {
+        q->end = prev;
+      }
+    }
+    p->needspoll = 0;
+  }
+  POLL_UNLOCK();
+}
+#endif /* PROCESS_CONF_POLL_QUEUE */
 /*---------------------------------------------------------------------------*/
 process_event_t
 process_alloc_event(void)
@@ -100,6 +208,9 @@ void
 process_start(struct process *p, const char *arg)
 {
   struct process *q;
+#if PROCESS_CONF_PRIORITIES
+  struct process **qp;
+#endif /* PROCESS_CONF_PRIORITIES */
 
   /* First make sure that we don't try to start a process that is
      already running. */
@@ -110,8 +221,19 @@ process_start(struct process *p, const char *arg)
     return;
   }
   /* Put on the procs list.*/
+#if PROCESS_CONF_PRIORITIES
+  /* High priority processes are kept first on the list, so that they
+     can be found without walking past the others. */
+  qp = &process_list;
+  if(!PROCESS_IS_HIGH(p)) {
+    for(; *qp != NULL && PROCESS_IS_HIGH(*qp); qp = &(*qp)->next);
+  }
+  p->next = *qp;
+  *qp = p;
+#else /* PROCESS_CONF_PRIORITIES */
   p->next = process_list;
   process_list = p;
+#endif /* PROCESS_CONF_PRIORITIES */
   p->state = PROCESS_STATE_RUNNING;
   PT_INIT(&p->pt);
 
@@ -139,6 +261,9 @@ exit_process(struct process *p, struct process *fromprocess)
   if(process_is_running(p)) {
     /* Process was running */
     p->state = PROCESS_STATE_NONE;
+#if PROCESS_CONF_POLL_QUEUE
+    poll_unlink(p);
+#endif /* PROCESS_CONF_POLL_QUEUE */
 
     /*
      * Post a synchronous event to all processes to inform them that
@@ -176,19 +301,35 @@ static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
   int ret;
+#if PROCESS_PROFILE
+  rtimer_clock_t start, delay;
+#endif /* PROCESS_PROFILE */
 
 #if DEBUG
   if(p->state == PROCESS_STATE_CALLED) {
     printf("process: process '%s' called again with event %d\n", PROCESS_NAME_STRING(p), ev);
   }
 #endif /* DEBUG */
+
+#if PROCESS_PROFILE
+  /* Only do_poll() and do_event() set a delay; synchronous calls have
+     none. */
+  delay = event_delay;
+  event_delay = 0;
+#endif /* PROCESS_PROFILE */
   
   if((p->state & PROCESS_STATE_RUNNING) &&
      p->thread != NULL) {
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if PROCESS_PROFILE
+    start = RTIMER_NOW();
+#endif /* PROCESS_PROFILE */
     ret = p->thread(&p->pt, ev, data);
+#if PROCESS_PROFILE
+    process_profile_record(p, ev, delay, RTIMER_NOW() - start);
+#endif /* PROCESS_PROFILE */
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -211,8 +352,18 @@ process_init(void)
   lastevent = PROCESS_EVENT_MAX;
 
   nevents = fevent = 0;
+#if PROCESS_CONF_PRIORITIES
+  nevents_high = fevent_high = 0;
+#endif /* PROCESS_CONF_PRIORITIES */
+#if PROCESS_CONF_POLL_QUEUE
+  polls.first = polls.last = polls.end = NULL;
+#if PROCESS_CONF_PRIORITIES
+  polls_high.first = polls_high.last = polls_high.end = NULL;
+#endif /* PROCESS_CONF_PRIORITIES */
+#endif /* PROCESS_CONF_POLL_QUEUE */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  process_event_overflows = 0;
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -222,20 +373,94 @@ process_init(void)
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+static void do_poll_high(void);
+#endif /* PROCESS_CONF_PRIORITIES */
+
+static void
+poll_process(struct process *p)
+{
+  p->state = PROCESS_STATE_RUNNING;
+  SET_EVENT_DELAY(p->poll_time);
+  call_process(p, PROCESS_EVENT_POLL, NULL);
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_POLL_QUEUE
+/* Calls the processes that were queued when the round started. Those
+   polled meanwhile are left for the next round, so that a process that
+   polls itself does not keep the others waiting. */
+static void
+do_poll_queue(struct poll_queue *q, volatile unsigned char *requested)
+{
+  struct process *p;
+
+  POLL_LOCK();
+  *requested = 0;
+  q->end = q->last;
+  POLL_UNLOCK();
+
+  while(q->end != NULL && (p = poll_dequeue(q)) != NULL) {
+#if PROCESS_CONF_PRIORITIES
+    /* A high priority poll does not wait for the normal ones. */
+    if(q != &polls_high && poll_requested_high) {
+      do_poll_high();
+    }
+#endif /* PROCESS_CONF_PRIORITIES */
+    poll_process(p);
+  }
+}
+#endif /* PROCESS_CONF_POLL_QUEUE */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+static void
+do_poll_high(void)
+{
+#if PROCESS_CONF_POLL_QUEUE
+  do_poll_queue(&polls_high, &poll_requested_high);
+#else /* PROCESS_CONF_POLL_QUEUE */
+  struct process *p;
+
+  poll_requested_high = 0;
+  /* Only the high priority processes, at the start of the list, are
+     checked. */
+  for(p = process_list; p != NULL && PROCESS_IS_HIGH(p); p = p->next) {
+    if(p->needspoll) {
+      p->needspoll = 0;
+      poll_process(p);
+    }
+  }
+#endif /* PROCESS_CONF_POLL_QUEUE */
+}
+#endif /* PROCESS_CONF_PRIORITIES */
+/*---------------------------------------------------------------------------*/
 static void
 do_poll(void)
 {
+#if PROCESS_CONF_POLL_QUEUE
+  do_poll_queue(&polls, &poll_requested);
+#else /* PROCESS_CONF_POLL_QUEUE */
   struct process *p;
 
   poll_requested = 0;
   /* Call the processes that needs to be polled. */
   for(p = process_list; p != NULL; p = p->next) {
+#if PROCESS_CONF_PRIORITIES
+    /* A high priority poll does not wait for the normal ones. */
+    if(poll_requested_high) {
+      do_poll_high();
+    }
+#endif /* PROCESS_CONF_PRIORITIES */
     if(p->needspoll) {
-      p->state = PROCESS_STATE_RUNNING;
       p->needspoll = 0;
-      call_process(p, PROCESS_EVENT_POLL, NULL);
+      poll_process(p);
     }
   }
+#endif /* PROCESS_CONF_POLL_QUEUE */
+#if PROCESS_CONF_PRIORITIES
+  if(poll_requested_high) {
+    do_poll_high();
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
 }
 /*---------------------------------------------------------------------------*/
 /*
@@ -250,6 +475,9 @@ do_event(void)
   static process_data_t data;
   static struct process *receiver;
   static struct process *p;
+#if PROCESS_PROFILE
+  static rtimer_clock_t posted;
+#endif /* PROCESS_PROFILE */
   
   /*
    * If there are any events in the queue, take the first one and walk
@@ -259,6 +487,24 @@ do_event(void)
    * call the poll handlers inbetween.
    */
 
+#if PROCESS_CONF_PRIORITIES
+  if(nevents_high > 0) {
+    ev = events_high[fevent_high].ev;
+    data = events_high[fevent_high].data;
+    receiver = events_high[fevent_high].p;
+#if PROCESS_PROFILE
+    posted = events_high[fevent_high].posted;
+#endif /* PROCESS_PROFILE */
+    fevent_high = (fevent_high + 1) % PROCESS_CONF_NUMEVENTS_HIGH;
+    --nevents_high;
+
+    if(ev == PROCESS_EVENT_INIT) {
+      receiver->state = PROCESS_STATE_RUNNING;
+    }
+    SET_EVENT_DELAY(posted);
+    call_process(receiver, ev, data);
+  } else
+#endif /* PROCESS_CONF_PRIORITIES */
   if(nevents > 0) {
     
     /* There are events that we should deliver. */
@@ -266,6 +512,9 @@ do_event(void)
     
     data = events[fevent].data;
     receiver = events[fevent].p;
+#if PROCESS_PROFILE
+    posted = events[fevent].posted;
+#endif /* PROCESS_PROFILE */
 
     /* Since we have seen the new event, we move pointer upwards
        and decrese the number of events. */
@@ -282,6 +531,7 @@ do_event(void)
 	if(poll_requested) {
 	  do_poll();
 	}
+	SET_EVENT_DELAY(posted);
 	call_process(p, ev, data);
       }
     } else {
@@ -294,6 +544,7 @@ do_event(void)
       }
 
       /* Make sure that the process actually is running. */
+      SET_EVENT_DELAY(posted);
       call_process(receiver, ev, data);
     }
   }
@@ -302,6 +553,12 @@ do_event(void)
 int
 process_run(void)
 {
+#if PROCESS_CONF_PRIORITIES
+  if(poll_requested_high) {
+    do_poll_high();
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
+
   /* Process poll events. */
   if(poll_requested) {
     do_poll();
@@ -310,13 +567,17 @@ process_run(void)
   /* Process one event from the queue */
   do_event();
 
-  return nevents + poll_requested;
+  return process_nevents();
 }
 /*---------------------------------------------------------------------------*/
 int
 process_nevents(void)
 {
+#if PROCESS_CONF_PRIORITIES
+  return nevents + nevents_high + poll_requested;
+#else /* PROCESS_CONF_PRIORITIES */
   return nevents + poll_requested;
+#endif /* PROCESS_CONF_PRIORITIES */
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -333,7 +594,37 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
   }
   
+#if PROCESS_CONF_PRIORITIES
+  if(p != PROCESS_BROADCAST && PROCESS_IS_HIGH(p)) {
+    if(nevents_high == PROCESS_CONF_NUMEVENTS_HIGH) {
+      PRINTF("soft panic: high priority event queue is full\n");
+#if PROCESS_CONF_STATS
+      ++process_event_overflows;
+#endif /* PROCESS_CONF_STATS */
+      return PROCESS_ERR_FULL;
+    }
+    snum = (process_num_events_t)(fevent_high + nevents_high) %
+      PROCESS_CONF_NUMEVENTS_HIGH;
+    events_high[snum].ev = ev;
+    events_high[snum].data = data;
+    events_high[snum].p = p;
+#if PROCESS_PROFILE
+    events_high[snum].posted = RTIMER_NOW();
+#endif /* PROCESS_PROFILE */
+    ++nevents_high;
+#if PROCESS_CONF_STATS
+    if(nevents + nevents_high > process_maxevents) {
+      process_maxevents = nevents + nevents_high;
+    }
+#endif /* PROCESS_CONF_STATS */
+    return PROCESS_ERR_OK;
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
+
   if(nevents == PROCESS_CONF_NUMEVENTS) {
+#if PROCESS_CONF_STATS
+    ++process_event_overflows;
+#endif /* PROCESS_CONF_STATS */
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
       printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
@@ -348,12 +639,21 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
+#if PROCESS_PROFILE
+  events[snum].posted = RTIMER_NOW();
+#endif /* PROCESS_PROFILE */
   ++nevents;
 
 #if PROCESS_CONF_STATS
+#if PROCESS_CONF_PRIORITIES
+  if(nevents + nevents_high > process_maxevents) {
+    process_maxevents = nevents + nevents_high;
+  }
+#else /* PROCESS_CONF_PRIORITIES */
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
+#endif /* PROCESS_CONF_PRIORITIES */
 #endif /* PROCESS_CONF_STATS */
   
   return PROCESS_ERR_OK;
@@ -374,8 +674,35 @@ process_poll(struct process *p)
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_CONF_POLL_QUEUE
+      POLL_LOCK();
+      if(!p->needspoll) {
+        struct poll_queue *q = poll_queue(p);
+
+        p->pollnext = NULL;
+        if(q->last == NULL) {
+          q->first = p;
+        } else {
+          q->last->pollnext = p;
+        }
+        q->last = p;
+      }
+#endif /* PROCESS_CONF_POLL_QUEUE */
+#if PROCESS_PROFILE
+      if(!p->needspoll) {
+        p->poll_time = RTIMER_NOW();
+      }
+#endif /* PROCESS_PROFILE */
       p->needspoll = 1;
       poll_requested = 1;
+#if PROCESS_CONF_PRIORITIES
+      if(PROCESS_IS_HIGH(p)) {
+        poll_requested_high = 1;
+      }
+#endif /* PROCESS_CONF_PRIORITIES */
+#if PROCESS_CONF_POLL_QUEUE
+      POLL_UNLOCK();
+#endif /* PROCESS_CONF_POLL_QUEUE */
     }
   }
 }
@@ -57,9 +57,20 @@
 #include "sys/pt.h"
 #include "sys/cc.h"
 
+/* With PROCESS_CONF_PROFILE set to a number of entries, process run
+   times and event delays are recorded, see process-profile.h. */
+#ifdef PROCESS_CONF_PROFILE
+#define PROCESS_PROFILE PROCESS_CONF_PROFILE
+#else
+#define PROCESS_PROFILE 0
+#endif
+
+#if PROCESS_PROFILE
+#include "sys/rtimer.h"
+#endif
+
 typedef unsigned char process_event_t;
 typedef void *        process_data_t;
-typedef unsigned char process_num_events_t;
 
 /**
  * \name Return values
@@ -89,6 +100,63 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \name Process priorities
+ *
+ * With PROCESS_CONF_PRIORITIES, a process can be declared with
+ * PROCESS_PRIO() to run at PROCESS_PRIO_HIGH. Polls of high priority
+ * processes are handled before, and in between, the polls and events
+ * of normal processes, and events posted to them are taken from a
+ * separate queue of PROCESS_CONF_NUMEVENTS_HIGH entries before any
+ * other event. This is meant for the network and radio processes.
+ * @{
+ */
+#ifndef PROCESS_CONF_PRIORITIES
+#define PROCESS_CONF_PRIORITIES 0
+#endif /* PROCESS_CONF_PRIORITIES */
+
+/* Without priorities, the events to the high priority processes could
+   take the whole event queue. The queue of their own is as long by
+   default, so that enabling priorities does not make a post fail that
+   would have succeeded before. It costs the RAM of a second queue. */
+#ifndef PROCESS_CONF_NUMEVENTS_HIGH
+#define PROCESS_CONF_NUMEVENTS_HIGH PROCESS_CONF_NUMEVENTS
+#endif /* PROCESS_CONF_NUMEVENTS_HIGH */
+
+/* Counts of events in either queue, and process_maxevents, which is
+   the sum of both. */
+#if PROCESS_CONF_PRIORITIES && \
+    PROCESS_CONF_NUMEVENTS + PROCESS_CONF_NUMEVENTS_HIGH > 255
+typedef unsigned short process_num_events_t;
+#elif PROCESS_CONF_NUMEVENTS > 255
+typedef unsigned short process_num_events_t;
+#else
+typedef unsigned char process_num_events_t;
+#endif
+
+#define PROCESS_PRIO_NORMAL   0
+#define PROCESS_PRIO_HIGH     1
+/** @} */
+
+/**
+ * \name Poll queue
+ *
+ * With PROCESS_CONF_POLL_QUEUE, process_poll() links the process into
+ * a queue, and polls are dispatched from that queue instead of by
+ * walking the list of all processes. The needspoll flag must then
+ * only be set through process_poll().
+ *
+ * Where process_poll() is called from interrupts, the platform must
+ * define PROCESS_CONF_POLL_LOCK() and PROCESS_CONF_POLL_UNLOCK() to
+ * keep interrupts out while the queue changes, e.g. by saving and
+ * disabling them.
+ * @{
+ */
+#ifndef PROCESS_CONF_POLL_QUEUE
+#define PROCESS_CONF_POLL_QUEUE 0
+#endif /* PROCESS_CONF_POLL_QUEUE */
+/** @} */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -311,6 +379,31 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
                           process_thread_##name }
 #endif
 
+/**
+ * Declare a process with a priority.
+ *
+ * As PROCESS(), but the process runs at priority prio,
+ * PROCESS_PRIO_NORMAL or PROCESS_PRIO_HIGH. Without
+ * PROCESS_CONF_PRIORITIES, the priority is ignored.
+ *
+ * \hideinitializer
+ */
+#if !PROCESS_CONF_PRIORITIES
+#define PROCESS_PRIO(name, strname, prio) PROCESS(name, strname)
+#elif PROCESS_CONF_NO_PROCESS_NAMES
+#define PROCESS_PRIO(name, strname, prio)		\
+  PROCESS_THREAD(name, ev, data);			\
+  struct process name = { NULL,		        \
+                          process_thread_##name,	\
+                          { 0 }, 0, 0, prio }
+#else
+#define PROCESS_PRIO(name, strname, prio)		\
+  PROCESS_THREAD(name, ev, data);			\
+  struct process name = { NULL, strname,		\
+                          process_thread_##name,	\
+                          { 0 }, 0, 0, prio }
+#endif
+
 /** @} */
 
 struct process {
@@ -324,6 +417,17 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_CONF_PRIORITIES
+  unsigned char priority;
+#endif
+#if PROCESS_PROFILE
+  /* When the pending poll was requested, see process-profile.h. */
+  rtimer_clock_t poll_time;
+#endif
+#if PROCESS_CONF_POLL_QUEUE
+  /* The next process in the poll queue, while needspoll is set. */
+  struct process *pollnext;
+#endif
 };
 
 /**
@@ -520,6 +624,14 @@ CCIF int process_is_running(struct process *p);
  */
 int process_nevents(void);
 
+#if PROCESS_CONF_STATS
+/** The largest number of events that have been queued at once, in
+    all queues. */
+extern process_num_events_t process_maxevents;
+/** The number of events that were lost because the queue was full. */
+extern unsigned short process_event_overflows;
+#endif /* PROCESS_CONF_STATS */
+
 /** @} */
 
 CCIF extern struct process *process_list;
@@ -28,4 +28,8 @@
 
 #define BAUD2UBR(x) x
 
+/* There is no UART; serial line input, if any, is fed directly to
+   serial_line_input_byte(). */
+#define uart1_set_input(f)
+
 #endif
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Radio driver for simulated native nodes
+ */
+
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "net/mac/frame802154.h"
+
+#include "sim-radio.h"
+
+#define DEBUG 0
+#if DEBUG
+#include <stdio.h>
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+
+/* Time on air of a frame at 250 kbit/s, including the preamble, the
+   SFD and the length byte. Must match the radio medium. */
+#define AIRTIME_US(len) (((len) + 6) * 32UL)
+
+int (*sim_radio_output)(void *ctx, const void *data, unsigned short len,
+                        unsigned short ack_from);
+void *sim_radio_ctx;
+unsigned long sim_radio_busy_until;
+unsigned long sim_radio_tx_time;
+unsigned long sim_radio_rx_time;
+
+static uint8_t txbuf[SIM_RADIO_MAX_FRAME];
+static unsigned short txlen;
+
+static struct {
+  uint8_t data[SIM_RADIO_MAX_FRAME];
+  unsigned short len;
+} rxq[SIM_RADIO_RX_QUEUE];
+static uint8_t rx_first, rx_count;
+
+static uint8_t radio_on;
+
+PROCESS(sim_radio_process, "Simulated radio");
+/*---------------------------------------------------------------------------*/
+void
+sim_radio_input(const void *data, unsigned short len)
+{
+  int i;
+
+  if(!radio_on || len > SIM_RADIO_MAX_FRAME) {
+    return;
+  }
+  sim_radio_rx_time += AIRTIME_US(len);
+  if(rx_count == SIM_RADIO_RX_QUEUE) {
+    PRINTF("sim-radio: rx queue full, dropping %u bytes\n", len);
+    return;
+  }
+  i = (rx_first + rx_count) % SIM_RADIO_RX_QUEUE;
+  memcpy(rxq[i].data, data, len);
+  rxq[i].len = len;
+  rx_count++;
+  process_poll(&sim_radio_process);
+}
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  rx_first = rx_count = 0;
+  radio_on = 1;
+  process_start(&sim_radio_process, NULL);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  if(payload_len > SIM_RADIO_MAX_FRAME) {
+    return 1;
+  }
+  memcpy(txbuf, payload, payload_len);
+  txlen = payload_len;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* The id of the node that is to acknowledge a frame, or 0. Node ids
+   are the last two bytes of the address, see contiki-sim-main.c. */
+static unsigned short
+ack_from(uint8_t *frame, unsigned short len)
+{
+  frame802154_t f;
+  int addr_len;
+
+  if(frame802154_parse(frame, len, &f) == 0 ||
+     f.fcf.frame_type != FRAME802154_DATAFRAME || !f.fcf.ack_required) {
+    return 0;
+  }
+  if(f.fcf.dest_addr_mode == FRAME802154_SHORTADDRMODE) {
+    addr_len = 2;
+  } else if(f.fcf.dest_addr_mode == FRAME802154_LONGADDRMODE) {
+    addr_len = 8;
+  } else {
+    return 0;
+  }
+  return (f.dest_addr[addr_len - 2] << 8) | f.dest_addr[addr_len - 1];
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit(unsigned short transmit_len)
+{
+  unsigned short from;
+
+  if(sim_radio_output == NULL || transmit_len != txlen) {
+    return RADIO_TX_ERR;
+  }
+  from = ack_from(txbuf, txlen);
+  sim_radio_tx_time += AIRTIME_US(txlen);
+  if(!sim_radio_output(sim_radio_ctx, txbuf, txlen, from) && from != 0) {
+    return RADIO_TX_NOACK;
+  }
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  if(prepare(payload, payload_len)) {
+    return RADIO_TX_ERR;
+  }
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+read(void *buf, unsigned short buf_len)
+{
+  unsigned short len;
+
+  if(rx_count == 0) {
+    return 0;
+  }
+  len = rxq[rx_first].len;
+  if(len > buf_len) {
+    len = 0;
+  } else {
+    memcpy(buf, rxq[rx_first].data, len);
+  }
+  rx_first = (rx_first + 1) % SIM_RADIO_RX_QUEUE;
+  rx_count--;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return clock_time() >= sim_radio_busy_until;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return !channel_clear();
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return rx_count > 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  radio_on = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  radio_on = 0;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sim_radio_process, ev, data)
+{
+  int len;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+
+    while(rx_count > 0) {
+      packetbuf_clear();
+      len = read(packetbuf_dataptr(), PACKETBUF_SIZE);
+      if(len > 0) {
+        packetbuf_set_datalen(len);
+        NETSTACK_RDC.input();
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver sim_radio_driver =
+  {
+    init,
+    prepare,
+    transmit,
+    send,
+    read,
+    channel_clear,
+    receiving_packet,
+    pending_packet,
+    on,
+    off,
+  };
+/*---------------------------------------------------------------------------*/
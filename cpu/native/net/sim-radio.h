@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Radio driver for simulated native nodes
+ *
+ *         The radio has no hardware behind it. Frames are handed to a
+ *         radio medium in the simulation runner (tools/native-sim),
+ *         which calls sim_radio_input() on the receivers. The runner
+ *         finds the variables and functions below by name, so their
+ *         types must not change without updating the runner.
+ *
+ *         Data frames that request an acknowledgement are acknowledged
+ *         the way radios with hardware auto-ack do it: the medium tells
+ *         the sender whether its frame got through and the ACK came
+ *         back, and transmit() returns RADIO_TX_NOACK if not. Use the
+ *         driver with NULLRDC_CONF_802154_AUTOACK_HW.
+ */
+
+#ifndef __SIM_RADIO_H__
+#define __SIM_RADIO_H__
+
+#include "dev/radio.h"
+
+/* Largest frame the radio sends or receives. */
+#ifdef SIM_RADIO_CONF_MAX_FRAME
+#define SIM_RADIO_MAX_FRAME SIM_RADIO_CONF_MAX_FRAME
+#else
+#define SIM_RADIO_MAX_FRAME 127
+#endif
+
+/* Number of received frames buffered until the radio process runs. */
+#ifdef SIM_RADIO_CONF_RX_QUEUE
+#define SIM_RADIO_RX_QUEUE SIM_RADIO_CONF_RX_QUEUE
+#else
+#define SIM_RADIO_RX_QUEUE 4
+#endif
+
+extern const struct radio_driver sim_radio_driver;
+
+/* Set by the runner: called for every frame the node transmits.
+   ack_from is the id of the node to acknowledge the frame, or 0 if it
+   asks for no acknowledgement. Returns non-zero if the frame was
+   acknowledged. */
+extern int (*sim_radio_output)(void *ctx, const void *data,
+                               unsigned short len, unsigned short ack_from);
+extern void *sim_radio_ctx;
+
+/* Set by the runner: the medium is busy until this clock time. */
+extern unsigned long sim_radio_busy_until;
+
+/* Called by the runner when a frame arrives. */
+void sim_radio_input(const void *data, unsigned short len);
+
+/* Airtime of the frames sent and received so far, in microseconds.
+   Energy models use them in place of Energest, which has no time
+   base in the simulation. */
+extern unsigned long sim_radio_tx_time;
+extern unsigned long sim_radio_rx_time;
+
+#endif /* __SIM_RADIO_H__ */
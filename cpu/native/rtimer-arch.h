@@ -42,6 +42,7 @@
 #define __RTIMER_ARCH_H__
 
 #include "contiki-conf.h"
+#include "sys/clock.h"
 
 #define RTIMER_ARCH_SECOND CLOCK_CONF_SECOND
 
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Tests for the block cache in cfs/cfs-cache.c, run against a
+ *         back end in RAM that counts its accesses. The test ends with
+ *         the amount of back end accesses needed for sequential and
+ *         random reads and writes, with and without the cache.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs-cache.h"
+#include "lib/random.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(cfs_cache_test_process, "CFS cache test process");
+AUTOSTART_PROCESSES(&cfs_cache_test_process);
+
+/* Not a multiple of the block size, so that the last block is short. */
+#define STORAGE_SIZE    2000
+#define ACCESS_SIZE     16
+#define OPERATIONS      1000
+
+static uint8_t storage[2][STORAGE_SIZE];
+static uint8_t shadow[2][STORAGE_SIZE];
+static unsigned long backend_reads;
+static unsigned long backend_writes;
+/*---------------------------------------------------------------------------*/
+static int
+ram_read(int id, void *buf, unsigned size, cfs_offset_t offset)
+{
+  backend_reads++;
+  if(offset >= STORAGE_SIZE) {
+    return 0;
+  }
+  if(size > STORAGE_SIZE - offset) {
+    size = STORAGE_SIZE - offset;
+  }
+  memcpy(buf, &storage[id][offset], size);
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+static int
+ram_write(int id, const void *buf, unsigned size, cfs_offset_t offset)
+{
+  backend_writes++;
+  if(offset + size > STORAGE_SIZE) {
+    return -1;
+  }
+  memcpy(&storage[id][offset], buf, size);
+  return size;
+}
+/*---------------------------------------------------------------------------*/
+static const struct cfs_cache_backend ram_backend =
+  {ram_read, ram_write, STORAGE_SIZE};
+/*---------------------------------------------------------------------------*/
+static void
+fill_storage(void)
+{
+  int id;
+  unsigned i;
+
+  for(id = 0; id < 2; id++) {
+    for(i = 0; i < STORAGE_SIZE; i++) {
+      storage[id][i] = shadow[id][i] = i * (id + 3);
+    }
+  }
+  cfs_cache_invalidate(&ram_backend, -1, 0, 0);
+  backend_reads = backend_writes = 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cache_test(void)
+{
+  int error;
+  uint8_t buf[100];
+  unsigned i, j, n;
+  cfs_offset_t offset;
+  int id;
+
+  fill_storage();
+
+  /* Test 1: Sequential small reads return the storage and take fewer
+     back end reads than there are calls. */
+  for(offset = 0; offset < STORAGE_SIZE; offset += ACCESS_SIZE) {
+    if(cfs_cache_read(&ram_backend, 0, buf, ACCESS_SIZE, offset) !=
+       ACCESS_SIZE ||
+       memcmp(buf, &shadow[0][offset], ACCESS_SIZE) != 0) {
+      FAIL(1);
+    }
+  }
+  if(backend_reads >= STORAGE_SIZE / ACCESS_SIZE / 2) {
+    FAIL(1);
+  }
+
+  /* Test 2: Reads are cut short at the end of the storage. */
+  if(cfs_cache_read(&ram_backend, 0, buf, 50, STORAGE_SIZE - 10) != 10 ||
+     memcmp(buf, &shadow[0][STORAGE_SIZE - 10], 10) != 0) {
+    FAIL(2);
+  }
+  if(cfs_cache_read(&ram_backend, 0, buf, 10, STORAGE_SIZE) != 0) {
+    FAIL(2);
+  }
+
+  /* Test 3: Small writes to one block reach the back end as one write
+     when the block is flushed. */
+  backend_writes = 0;
+  for(i = 0; i < 8; i++) {
+    buf[0] = 0xa0 + i;
+    if(cfs_cache_write(&ram_backend, 0, buf, 1, 100 + i) != 1) {
+      FAIL(3);
+    }
+    shadow[0][100 + i] = buf[0];
+  }
+  if(backend_writes != 0 || storage[0][100] == shadow[0][100]) {
+    FAIL(3);
+  }
+  if(cfs_cache_flush(&ram_backend, 0) != 0 || backend_writes != 1 ||
+     memcmp(storage[0], shadow[0], STORAGE_SIZE) != 0) {
+    FAIL(3);
+  }
+
+  /* Test 4: Written data is read back before it is flushed, also from
+     a block that has not been read. */
+  fill_storage();
+  memset(buf, 0x55, 10);
+  cfs_cache_write(&ram_backend, 0, buf, 10, 1005);
+  memset(&shadow[0][1005], 0x55, 10);
+  if(cfs_cache_read(&ram_backend, 0, buf, 40, 990) != 40 ||
+     memcmp(buf, &shadow[0][990], 40) != 0) {
+    FAIL(4);
+  }
+
+  /* Test 5: The ids are kept apart. */
+  if(cfs_cache_read(&ram_backend, 1, buf, 40, 990) != 40 ||
+     memcmp(buf, &shadow[1][990], 40) != 0) {
+    FAIL(5);
+  }
+
+  /* Test 6: Invalidated blocks are read again from the back end, and
+     their unwritten data is dropped. */
+  storage[0][991] = shadow[0][991] = 0x77;
+  memcpy(&shadow[0][1005], &storage[0][1005], 10);
+  cfs_cache_invalidate(&ram_backend, 0, 980, 40);
+  if(cfs_cache_read(&ram_backend, 0, buf, 40, 990) != 40 ||
+     memcmp(buf, &shadow[0][990], 40) != 0) {
+    FAIL(6);
+  }
+
+  /* Test 7: Random reads and writes of both ids match a copy that is
+     written directly. */
+  fill_storage();
+  for(i = 0; i < OPERATIONS; i++) {
+    id = random_rand() & 1;
+    n = 1 + random_rand() % sizeof(buf);
+    offset = random_rand() % (STORAGE_SIZE - n);
+    if(random_rand() & 1) {
+      for(j = 0; j < n; j++) {
+        buf[j] = random_rand();
+      }
+      if(cfs_cache_write(&ram_backend, id, buf, n, offset) != n) {
+        FAIL(7);
+      }
+      memcpy(&shadow[id][offset], buf, n);
+    } else {
+      if(cfs_cache_read(&ram_backend, id, buf, n, offset) != n ||
+         memcmp(buf, &shadow[id][offset], n) != 0) {
+        FAIL(7);
+      }
+    }
+  }
+
+  /* Test 8: A flush of all ids writes everything back. */
+  if(cfs_cache_flush(&ram_backend, -1) != 0 ||
+     memcmp(storage, shadow, sizeof(storage)) != 0) {
+    FAIL(8);
+  }
+
+  /* Test 9: Invalidating every back end drops all dirty blocks, as a
+     restart does. */
+  memset(buf, 0x33, 10);
+  cfs_cache_write(&ram_backend, 0, buf, 10, 500);
+  cfs_cache_write(&ram_backend, 1, buf, 10, 500);
+  cfs_cache_invalidate(NULL, -1, 0, 0);
+  backend_writes = 0;
+  if(cfs_cache_flush(&ram_backend, -1) != 0 || backend_writes != 0 ||
+     cfs_cache_read(&ram_backend, 1, buf, 10, 500) != 10 ||
+     memcmp(buf, &shadow[1][500], 10) != 0) {
+    FAIL(9);
+  }
+
+  /* Test 10: A small write across two blocks reaches the back end as
+     one write, when it is flushed and when it is evicted. */
+  fill_storage();
+  memset(buf, 0x44, ACCESS_SIZE);
+  cfs_cache_write(&ram_backend, 0, buf, ACCESS_SIZE,
+                  CFS_CACHE_BLOCK_SIZE - ACCESS_SIZE / 2);
+  memset(&shadow[0][CFS_CACHE_BLOCK_SIZE - ACCESS_SIZE / 2], 0x44,
+         ACCESS_SIZE);
+  if(cfs_cache_flush(&ram_backend, 0) != 0 || backend_writes != 1 ||
+     memcmp(storage[0], shadow[0], STORAGE_SIZE) != 0) {
+    FAIL(10);
+  }
+  backend_writes = 0;
+  cfs_cache_write(&ram_backend, 0, buf, ACCESS_SIZE,
+                  3 * CFS_CACHE_BLOCK_SIZE - ACCESS_SIZE / 2);
+  memset(&shadow[0][3 * CFS_CACHE_BLOCK_SIZE - ACCESS_SIZE / 2], 0x44,
+         ACCESS_SIZE);
+  for(i = 0; i < CFS_CACHE_BLOCKS; i++) {
+    cfs_cache_read(&ram_backend, 1, buf, 1, i * CFS_CACHE_BLOCK_SIZE * 4);
+  }
+  if(backend_writes != 1 ||
+     memcmp(storage[0], shadow[0], STORAGE_SIZE) != 0) {
+    FAIL(10);
+  }
+
+  error = 0;
+end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+access_counts(const char *name, int random, int write)
+{
+  uint8_t buf[ACCESS_SIZE];
+  cfs_offset_t offset;
+  unsigned i;
+
+  fill_storage();
+  memset(buf, 0, sizeof(buf));
+  offset = 0;
+  for(i = 0; i < OPERATIONS; i++) {
+    if(random) {
+      offset = random_rand() % (STORAGE_SIZE - ACCESS_SIZE);
+    } else if(offset + ACCESS_SIZE > STORAGE_SIZE) {
+      offset = 0;
+    }
+    if(write) {
+      cfs_cache_write(&ram_backend, 0, buf, ACCESS_SIZE, offset);
+    } else {
+      cfs_cache_read(&ram_backend, 0, buf, ACCESS_SIZE, offset);
+    }
+    offset += ACCESS_SIZE;
+  }
+  cfs_cache_flush(&ram_backend, 0);
+  printf("%-18s %6u %8lu\n", name, OPERATIONS,
+         write ? backend_writes : backend_reads);
+  return write ? backend_writes : backend_reads;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(cfs_cache_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  core_test_start("CFS cache");
+
+  core_test_result("Cache operations", cache_test());
+
+  printf("access              calls  backend\n");
+  access_counts("sequential reads", 0, 0);
+  access_counts("random reads", 1, 0);
+  access_counts("sequential writes", 0, 1);
+  /* Small random writes take no more back end writes than if they
+     were written directly. */
+  if(access_counts("random writes", 1, 1) > OPERATIONS) {
+    core_test_result("Random writes", 1);
+  }
+#if CFS_CACHE_STATS
+  printf("hits %lu misses %lu read ahead %lu direct %lu write backs %lu\n",
+         cfs_cache_stats.hits, cfs_cache_stats.misses,
+         cfs_cache_stats.read_ahead, cfs_cache_stats.direct,
+         cfs_cache_stats.write_backs);
+#endif /* CFS_CACHE_STATS */
+
+  core_test_finish("CFS cache");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test and benchmark for the uIPv6 Internet checksum. Compares
+ *         uip_chksum() with the byte-wise loop over packet sizes, and
+ *         checks the RFC 1624 incremental update. Needs IPv6: build it
+ *         with "make chksum-test UIP_CONF_IPV6=1", and add
+ *         DEFINES=UIP_CONF_CHKSUM_WORD32=0 to time the byte-wise loop
+ *         in uip6.c instead of the 32-bit one.
+ */
+
+#include "contiki.h"
+#include "net/uip.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(chksum_test_process, "Checksum test process");
+AUTOSTART_PROCESSES(&chksum_test_process);
+
+#define BUF_SIZE        1280
+
+static u16_t buf_aligned[BUF_SIZE / 2 + 2];
+static u8_t *buf = (u8_t *)buf_aligned;
+static u8_t copy[BUF_SIZE];
+
+static const u16_t sizes[] = { 8, 40, 64, 127, 256, 512, 1280 };
+/*---------------------------------------------------------------------------*/
+/* The byte-wise loop that uip6.c uses by default, as the baseline.
+   Returns the sum in network byte order, as uip_chksum() does. */
+static u16_t
+bytewise_chksum(const u8_t *data, u16_t len)
+{
+  u16_t sum, t;
+
+  sum = 0;
+  for(; len >= 2; len -= 2, data += 2) {
+    t = (data[0] << 8) + data[1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  if(len == 1) {
+    t = data[0] << 8;
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  return uip_htons(sum);
+}
+/*---------------------------------------------------------------------------*/
+/* 0x0000 and 0xffff are both zero in one's complement. */
+static int
+same_sum(u16_t a, u16_t b)
+{
+  return a == b || ((a == 0 || a == 0xffff) && (b == 0 || b == 0xffff));
+}
+/*---------------------------------------------------------------------------*/
+static int
+chksum_test_values(void)
+{
+  int error;
+  u16_t field, old_word, new_word;
+  int i, len;
+
+  for(i = 0; i < BUF_SIZE; ++i) {
+    buf[i] = (u8_t)(i * 7 + 3);
+  }
+
+  /* Test 1: uip_chksum() agrees with the baseline over all lengths up
+     to 72 bytes and over odd alignments. */
+  for(len = 0; len <= 72; ++len) {
+    for(i = 0; i < 4; ++i) {
+      if(!same_sum(uip_chksum((u16_t *)(buf + i), len),
+                   bytewise_chksum(buf + i, len))) {
+        FAIL(1);
+      }
+    }
+  }
+
+  /* Test 2: ... and at the benchmark sizes, with all bytes set. */
+  memset(buf, 0xff, BUF_SIZE);
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    if(!same_sum(uip_chksum((u16_t *)buf, sizes[i]),
+                 bytewise_chksum(buf, sizes[i]))) {
+      FAIL(2);
+    }
+  }
+
+  /* Test 3: Updating the checksum field after one word changes gives
+     the checksum of the changed data. */
+  for(i = 0; i < BUF_SIZE; ++i) {
+    buf[i] = (u8_t)(i * 13 + 1);
+  }
+  for(i = 0; i < 64; i += 2) {
+    field = ~uip_chksum((u16_t *)buf, 64);
+    memcpy(&old_word, buf + i, 2);
+    new_word = old_word ^ (u16_t)(0x1234 * (i + 1));
+    memcpy(buf + i, &new_word, 2);
+    field = uip_chksum_update16(field, old_word, new_word);
+    if(!same_sum(field, (u16_t)~uip_chksum((u16_t *)buf, 64))) {
+      FAIL(3);
+    }
+  }
+
+  /* Test 4: The same for a 16-byte field, such as an IPv6 address. */
+  memcpy(copy, buf, 64);
+  field = ~uip_chksum((u16_t *)buf, 64);
+  for(i = 8; i < 24; ++i) {
+    buf[i] = (u8_t)~buf[i] + i;
+  }
+  field = uip_chksum_update(field, copy + 8, buf + 8, 16);
+  if(!same_sum(field, (u16_t)~uip_chksum((u16_t *)buf, 64))) {
+    FAIL(4);
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of buffers of len bytes summed in a quarter of a
+   second. */
+static unsigned long
+chksum_rate(int bytewise, u16_t len)
+{
+  unsigned long rounds;
+  u16_t acc;
+
+  acc = 0;
+  CORE_TEST_TIMED(rounds, CLOCK_SECOND / 4) {
+    if(bytewise) {
+      acc += bytewise_chksum(buf, len);
+    } else {
+      acc += uip_chksum((u16_t *)buf, len);
+    }
+  }
+  /* Keep the result alive. */
+  buf[0] ^= acc & 1;
+  return rounds;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(chksum_test_process, ev, data)
+{
+  unsigned long base, rate;
+  int i;
+
+  PROCESS_BEGIN();
+
+  core_test_start("Checksum");
+
+  core_test_result("Check values", chksum_test_values());
+
+  printf("bytes  byte-wise kB/s  uip_chksum() kB/s\n");
+  for(i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    base = chksum_rate(1, sizes[i]);
+    rate = chksum_rate(0, sizes[i]);
+    printf("%5u  %14lu  %17lu (%lu%%)\n", sizes[i],
+           base * 4 * sizes[i] / 1024, rate * 4 * sizes[i] / 1024,
+           rate * 100 / base);
+  }
+
+  core_test_finish("Checksum");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
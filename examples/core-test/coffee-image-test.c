@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Writes Coffee files through their micro logs, and prints the
+ *         Coffee configuration of the native platform in the format of
+ *         tools/coffee-manager/native.properties. When XMEM_IMAGE names
+ *         an image file, a copy of each file is also saved with the
+ *         suffix ".expected", so that run-tests.sh can compare the
+ *         files that coffee-manager extracts from the image with them.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "cfs-coffee-arch.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+PROCESS(coffee_image_test_process, "Coffee image test process");
+AUTOSTART_PROCESSES(&coffee_image_test_process);
+
+#define FILE_SIZE       1000
+#define PATCH_SIZE      16
+#define RECORD_SIZE     64
+
+static unsigned char shadow[FILE_SIZE];
+/*---------------------------------------------------------------------------*/
+static int
+save_expected(const char *name)
+{
+  char path[40];
+  FILE *f;
+  int r;
+
+  snprintf(path, sizeof(path), "%s.expected", name);
+  f = fopen(path, "wb");
+  if(f == NULL) {
+    return -1;
+  }
+  r = fwrite(shadow, 1, FILE_SIZE, f) == FILE_SIZE ? 0 : -1;
+  if(fclose(f) != 0) {
+    r = -1;
+  }
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+static int
+coffee_image_test(const char *name, unsigned record_size)
+{
+  int error;
+  int fd;
+  unsigned char buf[100];
+  cfs_offset_t i, offset;
+  int r;
+
+  cfs_remove(name);
+  fd = -1;
+
+  /* Test 1: Create the file, with a log of the given record size or
+     the default log. */
+  if(record_size > 0 &&
+     (cfs_coffee_reserve(name, FILE_SIZE) < 0 ||
+      cfs_coffee_configure_log(name, 8 * record_size, record_size) < 0)) {
+    FAIL(1);
+  }
+
+  /* Test 2: Write the file. No byte is zero, so that the end of the
+     file is where it was written. */
+  fd = cfs_open(name, CFS_READ | CFS_WRITE);
+  if(fd < 0) {
+    FAIL(2);
+  }
+  for(i = 0; i < FILE_SIZE; i++) {
+    shadow[i] = 1 + i % 251;
+  }
+  if(cfs_write(fd, shadow, FILE_SIZE) != FILE_SIZE) {
+    FAIL(2);
+  }
+
+  /* Test 3: Overwrite parts of it, which goes to the log. One of the
+     writes spans two log records. */
+  for(offset = 100; offset + PATCH_SIZE <= FILE_SIZE; offset += 300) {
+    memset(&shadow[offset], 0xa0 + offset / 100, PATCH_SIZE);
+    if(cfs_seek(fd, offset, CFS_SEEK_SET) != offset ||
+       cfs_write(fd, &shadow[offset], PATCH_SIZE) != PATCH_SIZE) {
+      FAIL(3);
+    }
+  }
+  offset = (record_size > 0 ? record_size : COFFEE_PAGE_SIZE) -
+           PATCH_SIZE / 2;
+  memset(&shadow[offset], 0x5a, PATCH_SIZE);
+  if(cfs_seek(fd, offset, CFS_SEEK_SET) != offset ||
+     cfs_write(fd, &shadow[offset], PATCH_SIZE) != PATCH_SIZE) {
+    FAIL(3);
+  }
+
+  /* Test 4: The whole file is right after it has been reopened. */
+  cfs_close(fd);
+  fd = cfs_open(name, CFS_READ);
+  for(i = 0; i < FILE_SIZE; i += r) {
+    r = cfs_read(fd, buf, sizeof(buf));
+    if(r <= 0 || memcmp(buf, &shadow[i], r) != 0) {
+      FAIL(4);
+    }
+  }
+
+  /* Test 5: The file is left in the image, with a copy next to it. */
+  if(getenv("XMEM_IMAGE") != NULL && save_expected(name) < 0) {
+    FAIL(5);
+  }
+
+  error = 0;
+end:
+  cfs_close(fd);
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_image_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  core_test_start("Coffee image");
+
+  printf("fs_size\t\t\t%lu\n", (unsigned long)COFFEE_SIZE);
+  printf("sector_size\t\t%lu\n", (unsigned long)COFFEE_SECTOR_SIZE);
+  printf("page_size\t\t%lu\n", (unsigned long)COFFEE_PAGE_SIZE);
+  printf("start_offset\t\t%lu\n", (unsigned long)COFFEE_START);
+  printf("default_file_size\t%lu\n", (unsigned long)COFFEE_DYN_SIZE);
+  printf("default_log_size\t%lu\n", (unsigned long)COFFEE_LOG_SIZE);
+  printf("use_micro_logs\t\t%s\n", COFFEE_MICRO_LOGS ? "true" : "false");
+  printf("page_type_size\t\t%u\n", (unsigned)sizeof(coffee_page_t));
+
+  core_test_result("Default log", coffee_image_test("image-test", 0));
+  core_test_result("Configured log",
+                   coffee_image_test("image-test-log", RECORD_SIZE));
+
+  core_test_finish("Coffee image");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Random read and write test for Coffee files with micro logs,
+ *         which reports the throughput for a range of file and log
+ *         sizes. Build it with COFFEE_CONF_LOG_INDEX set to 0 and 1 to
+ *         compare the log index with the search in storage. The file
+ *         contents are checked against a copy in RAM, so the test is
+ *         meant for the native platform.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+#include "lib/random.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(coffee_log_test_process, "Coffee log test process");
+AUTOSTART_PROCESSES(&coffee_log_test_process);
+
+#define FILE_NAME       "log-test"
+#define MAX_FILE_SIZE   16384
+#define ACCESS_SIZE     16
+#define RECORD_SIZE     64
+#define DURATION        (CLOCK_SECOND / 2)
+
+static unsigned char shadow[MAX_FILE_SIZE];
+/*---------------------------------------------------------------------------*/
+static int
+coffee_log_test(cfs_offset_t file_size, unsigned log_size)
+{
+  int error;
+  int fd;
+  unsigned char buf[ACCESS_SIZE];
+  cfs_offset_t i, offset;
+  unsigned long reads, writes;
+  int r;
+
+  cfs_remove(FILE_NAME);
+  fd = -1;
+
+  /* Test 1 and 2: Create the file with a log of the given size. */
+  if(cfs_coffee_reserve(FILE_NAME, file_size) < 0) {
+    FAIL(1);
+  }
+  if(cfs_coffee_configure_log(FILE_NAME, log_size, RECORD_SIZE) < 0) {
+    FAIL(2);
+  }
+
+  /* Test 3: Fill it. No byte is zero, so that the end of the file is
+     where it was written. */
+  fd = cfs_open(FILE_NAME, CFS_READ | CFS_WRITE);
+  if(fd < 0) {
+    FAIL(3);
+  }
+  for(i = 0; i < file_size; i++) {
+    shadow[i] = 1 + i % 251;
+  }
+  if(cfs_write(fd, shadow, file_size) != file_size) {
+    FAIL(3);
+  }
+
+  /* Test 4 and 5: Write at random offsets, which goes to the log and
+     merges it into the file when it is full. */
+  CORE_TEST_TIMED(writes, DURATION) {
+    offset = random_rand() % (file_size - ACCESS_SIZE);
+    for(r = 0; r < ACCESS_SIZE; r++) {
+      buf[r] = 1 + random_rand() % 255;
+    }
+    if(cfs_seek(fd, offset, CFS_SEEK_SET) != offset) {
+      FAIL(4);
+    }
+    if(cfs_write(fd, buf, ACCESS_SIZE) != ACCESS_SIZE) {
+      FAIL(5);
+    }
+    memcpy(&shadow[offset], buf, ACCESS_SIZE);
+  }
+
+  /* Test 6 and 7: Read at random offsets. */
+  CORE_TEST_TIMED(reads, DURATION) {
+    offset = random_rand() % (file_size - ACCESS_SIZE);
+    if(cfs_seek(fd, offset, CFS_SEEK_SET) != offset ||
+       cfs_read(fd, buf, ACCESS_SIZE) != ACCESS_SIZE) {
+      FAIL(6);
+    }
+    if(memcmp(buf, &shadow[offset], ACCESS_SIZE) != 0) {
+      printf("offset %ld differs\n", (long)offset);
+      FAIL(7);
+    }
+  }
+
+  /* Test 8: The whole file is right after it has been reopened. */
+  cfs_close(fd);
+  fd = cfs_open(FILE_NAME, CFS_READ);
+  for(i = 0; i < file_size; i += r) {
+    r = cfs_read(fd, buf, sizeof(buf));
+    if(r <= 0 || memcmp(buf, &shadow[i], r) != 0) {
+      FAIL(8);
+    }
+  }
+
+  printf("%6ld %6u %8lu %8lu\n", (long)file_size, log_size,
+         CORE_TEST_PER_SECOND(reads, DURATION),
+         CORE_TEST_PER_SECOND(writes, DURATION));
+
+  error = 0;
+end:
+  cfs_close(fd);
+  cfs_remove(FILE_NAME);
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_log_test_process, ev, data)
+{
+  static cfs_offset_t file_size;
+  static unsigned log_size;
+  char name[40];
+  int result;
+
+  PROCESS_BEGIN();
+
+  core_test_start("Coffee log");
+  printf("  file    log  reads/s writes/s\n");
+
+  for(file_size = 1024; file_size <= MAX_FILE_SIZE; file_size *= 4) {
+    for(log_size = 512; log_size <= 8192; log_size *= 4) {
+      result = coffee_log_test(file_size, log_size);
+      if(result != 0) {
+        sprintf(name, "%ld byte file, %u byte log", (long)file_size,
+                log_size);
+        core_test_result(name, result);
+      }
+      PROCESS_PAUSE();
+    }
+  }
+
+  core_test_finish("Coffee log");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
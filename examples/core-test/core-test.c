@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Helpers shared by the core tests.
+ */
+
+#include "core-test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+clock_time_t core_test_started;
+
+static int failures;
+/*---------------------------------------------------------------------------*/
+void
+core_test_start(const char *name)
+{
+  failures = 0;
+  printf("%s test started\n", name);
+}
+/*---------------------------------------------------------------------------*/
+/* Prints the result of a test function, which is the number of the
+   check that failed or zero. */
+void
+core_test_result(const char *test_name, int result)
+{
+  printf("%s: ", test_name);
+  if(result == 0) {
+    printf("OK\n");
+  } else {
+    printf("ERROR (test %d)\n", result);
+    failures++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Ends the program, with status 1 if a test failed. */
+void
+core_test_finish(const char *name)
+{
+  printf("%s test finished: %s\n", name, failures == 0 ? "OK" : "ERROR");
+  exit(failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
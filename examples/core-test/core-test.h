@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Helpers shared by the core tests. Each test reports its
+ *         results with core_test_result() and ends with
+ *         core_test_finish(), which exits with a nonzero status if any
+ *         of them failed.
+ */
+
+#ifndef __CORE_TEST_H__
+#define __CORE_TEST_H__
+
+#include "contiki.h"
+
+/**
+ * Ends a test function with the number of the failed check in the
+ * variable error. The function has to define the label end.
+ */
+#define FAIL(x)         error = (x); goto end;
+
+/**
+ * Repeats the statement that follows for duration clock ticks and
+ * counts the rounds in the variable rounds.
+ */
+#define CORE_TEST_TIMED(rounds, duration)                               \
+  for((rounds) = 0, core_test_started = clock_time();                   \
+      clock_time() - core_test_started < (duration); (rounds)++)
+
+/** Converts rounds in duration clock ticks to rounds per second. */
+#define CORE_TEST_PER_SECOND(rounds, duration)                          \
+  ((rounds) * CLOCK_SECOND / (duration))
+
+extern clock_time_t core_test_started;
+
+void core_test_start(const char *name);
+void core_test_result(const char *test_name, int result);
+void core_test_finish(const char *name);
+
+#endif /* __CORE_TEST_H__ */
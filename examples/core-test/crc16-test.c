@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test and throughput benchmark for the CRC16 implementation
+ *         selected with CRC16_CONF_METHOD. Build it once per method,
+ *         e.g. "make crc16-test CRC16_METHOD=CRC16_TABLE", and compare
+ *         the figures.
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(crc16_test_process, "CRC16 test process");
+AUTOSTART_PROCESSES(&crc16_test_process);
+
+#define BUF_SIZE        256
+
+static unsigned char buf[BUF_SIZE];
+/*---------------------------------------------------------------------------*/
+/* The byte-at-a-time loop that CRC16_BITWISE uses, as the baseline. */
+static unsigned short
+bitwise_data(const unsigned char *data, int len, unsigned short acc)
+{
+  while(len-- > 0) {
+    acc ^= *data++;
+    acc  = (acc >> 8) | (acc << 8);
+    acc ^= (acc & 0xff00) << 4;
+    acc ^= (acc >> 8) >> 4;
+    acc ^= (acc & 0xff00) >> 5;
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static int
+crc16_test_values(void)
+{
+  int error;
+  unsigned short acc;
+  int i;
+
+  /* Test 1: The check value of the CCITT (Kermit) CRC. */
+  if(crc16_data((const unsigned char *)"123456789", 9, 0) != 0x2189) {
+    FAIL(1);
+  }
+
+  /* Test 2: The implementation agrees with the bitwise one. */
+  if(!crc16_selfcheck()) {
+    FAIL(2);
+  }
+
+  /* Test 3: crc16_data() agrees with the baseline over odd lengths
+     and alignments. */
+  for(i = 0; i < BUF_SIZE; ++i) {
+    buf[i] = (unsigned char)(i * 7 + 3);
+  }
+  for(i = 0; i < 13; ++i) {
+    if(crc16_data(buf + i, BUF_SIZE - 2 * i, 0) !=
+       bitwise_data(buf + i, BUF_SIZE - 2 * i, 0)) {
+      FAIL(3);
+    }
+  }
+
+  /* Test 4: A running checksum gives the same result as one call. */
+  acc = 0;
+  for(i = 0; i < BUF_SIZE; ++i) {
+    acc = crc16_add(buf[i], acc);
+  }
+  if(acc != crc16_data(buf, BUF_SIZE, 0)) {
+    FAIL(4);
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of buffers checksummed in one second. */
+static unsigned long
+crc16_rate(int method)
+{
+  unsigned long rounds;
+  unsigned short acc;
+  int i;
+
+  acc = 0;
+  CORE_TEST_TIMED(rounds, CLOCK_SECOND) {
+    if(method == 0) {
+      acc = bitwise_data(buf, BUF_SIZE, acc);
+    } else if(method == 1) {
+      for(i = 0; i < BUF_SIZE; ++i) {
+        acc = crc16_add(buf[i], acc);
+      }
+    } else {
+      acc = crc16_data(buf, BUF_SIZE, acc);
+    }
+  }
+  /* Keep the result alive. */
+  buf[0] ^= acc & 1;
+  return rounds;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crc16_test_process, ev, data)
+{
+  unsigned long base, rate;
+
+  PROCESS_BEGIN();
+
+  core_test_start("CRC16");
+
+  core_test_result("Check values", crc16_test_values());
+
+  base = crc16_rate(0);
+  printf("bitwise loop: %lu kbytes/s\n", base * BUF_SIZE / 1024);
+  rate = crc16_rate(1);
+  printf("crc16_add(): %lu kbytes/s (%lu%% of bitwise)\n",
+         rate * BUF_SIZE / 1024, rate * 100 / base);
+  rate = crc16_rate(2);
+  printf("crc16_data(): %lu kbytes/s (%lu%% of bitwise)\n",
+         rate * BUF_SIZE / 1024, rate * 100 / base);
+
+  core_test_finish("CRC16");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test and benchmark for event timers. Checks that timers
+ *         expire in order, and times setting a timer with 10, 100 and
+ *         1000 timers pending, and setting that many timers to expire
+ *         at once and dispatching their events.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "core-test.h"
+
+#include <stdio.h>
+
+PROCESS(etimer_test_process, "Etimer test process");
+PROCESS(etimer_sink_process, "Etimer sink process");
+AUTOSTART_PROCESSES(&etimer_test_process);
+
+#define MAX_TIMERS      1000
+#define ORDER_TIMERS    100
+
+static struct etimer timers[MAX_TIMERS];
+
+/* Kept by the sink process, which owns the timers. */
+static int expired;
+static int out_of_order;
+static clock_time_t last_expiration;
+
+static const int counts[] = { 10, 100, 1000 };
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == PROCESS_EVENT_TIMER) {
+      if(expired > 0 &&
+         (clock_time_t)(etimer_expiration_time(data) - last_expiration) >
+         (clock_time_t)~0 / 2) {
+        out_of_order = 1;
+      }
+      last_expiration = etimer_expiration_time(data);
+      expired++;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Sets timer i to interval on behalf of the sink process. */
+static void
+set_timer(int i, clock_time_t interval)
+{
+  PROCESS_CONTEXT_BEGIN(&etimer_sink_process);
+  etimer_set(&timers[i], interval);
+  PROCESS_CONTEXT_END(&etimer_sink_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+stop_timers(int n)
+{
+  int i;
+
+  for(i = 0; i < n; ++i) {
+    etimer_stop(&timers[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the scheduler until the sink has seen n expirations, or for at
+   most timeout. Called from within the test process, so events posted
+   to the test process meanwhile are lost. */
+static int
+run_until_expired(int n, clock_time_t timeout)
+{
+  clock_time_t start;
+
+  start = clock_time();
+  while(expired < n) {
+    if(clock_time() - start > timeout) {
+      return 0;
+    }
+    etimer_request_poll();
+    process_run();
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+etimer_test_order(void)
+{
+  int error;
+  int i;
+
+  expired = 0;
+  out_of_order = 0;
+
+  /* Test 1: The next expiration time is that of the shortest of
+     timers set in scrambled order. */
+  for(i = 0; i < ORDER_TIMERS; ++i) {
+    set_timer(i, (i * 37) % ORDER_TIMERS + 1);
+  }
+  if(etimer_next_expiration_time() != etimer_expiration_time(&timers[0])) {
+    FAIL(1);
+  }
+
+  /* Test 2: Setting a pending timer again moves it to its new place. */
+  set_timer(50, 0);
+  if(etimer_next_expiration_time() != etimer_expiration_time(&timers[50])) {
+    FAIL(2);
+  }
+
+  /* Test 3: All timers expire, in order of expiration time. */
+  if(!run_until_expired(ORDER_TIMERS, CLOCK_SECOND)) {
+    FAIL(3);
+  }
+  if(out_of_order) {
+    FAIL(3);
+  }
+
+  /* Test 4: A stopped timer does not expire. */
+  expired = 0;
+  set_timer(0, 1);
+  etimer_stop(&timers[0]);
+  if(!etimer_expired(&timers[0]) || run_until_expired(1, 5)) {
+    FAIL(4);
+  }
+
+  error = 0;
+ end:
+  stop_timers(ORDER_TIMERS);
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of timers set in a quarter of a second, each to a
+   random interval of up to a minute, with n timers pending. */
+static unsigned long
+etimer_set_rate(int n)
+{
+  unsigned long rounds;
+  int i;
+
+  for(i = 0; i < n; ++i) {
+    set_timer(i, CLOCK_SECOND + random_rand() % (60 * CLOCK_SECOND));
+  }
+  CORE_TEST_TIMED(rounds, CLOCK_SECOND / 4) {
+    set_timer(random_rand() % n,
+              CLOCK_SECOND + random_rand() % (60 * CLOCK_SECOND));
+  }
+  stop_timers(n);
+  return rounds;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of timers set to expire at once and dispatched in
+   a quarter of a second, n at a time. */
+static unsigned long
+etimer_expiry_rate(int n)
+{
+  unsigned long rounds;
+  int i;
+
+  CORE_TEST_TIMED(rounds, CLOCK_SECOND / 4) {
+    expired = 0;
+    for(i = 0; i < n; ++i) {
+      set_timer(i, 0);
+    }
+    if(!run_until_expired(n, CLOCK_SECOND)) {
+      break;
+    }
+  }
+  stop_timers(n);
+  return rounds * n;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  core_test_start("Etimer");
+
+  process_start(&etimer_sink_process, NULL);
+
+  core_test_result("Order", etimer_test_order());
+
+  printf("timers  etimer_set()/s  set and expired/s\n");
+  for(i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+    printf("%6d  %14lu", counts[i], etimer_set_rate(counts[i]) * 4);
+    printf("  %17lu\n", etimer_expiry_rate(counts[i]) * 4);
+  }
+
+  core_test_finish("Etimer");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test for the memb block allocator, in particular the free
+ *         list enabled with MEMB_CONF_FREELIST.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+#include "lib/list.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(memb_test_process, "memb test process");
+AUTOSTART_PROCESSES(&memb_test_process);
+
+#define NUM_ITEMS       8
+
+struct item {
+  struct item *next;
+  int value;
+};
+
+MEMB(items, struct item, NUM_ITEMS);
+LIST(item_list);
+
+/* Blocks smaller than a free list link. */
+MEMB(bytes, char, NUM_ITEMS);
+/*---------------------------------------------------------------------------*/
+static int
+memb_test_alloc(void)
+{
+  int error;
+  struct item *p[NUM_ITEMS];
+  int i, j;
+
+  memb_init(&items);
+
+  /* Test 1 and 2: All blocks can be allocated, and no more. */
+  for(i = 0; i < NUM_ITEMS; i++) {
+    p[i] = memb_alloc(&items);
+    if(p[i] == NULL) {
+      FAIL(1);
+    }
+  }
+  if(memb_alloc(&items) != NULL) {
+    FAIL(2);
+  }
+
+  /* Test 3: No block is handed out twice. */
+  for(i = 0; i < NUM_ITEMS; i++) {
+    for(j = i + 1; j < NUM_ITEMS; j++) {
+      if(p[i] == p[j]) {
+        FAIL(3);
+      }
+    }
+  }
+
+  /* Test 4: Freeing a pointer outside the block fails. */
+  if(memb_free(&items, &error) != -1) {
+    FAIL(4);
+  }
+
+  /* Test 5 and 6: Every other block is freed and allocated again. */
+  for(i = 0; i < NUM_ITEMS; i += 2) {
+    if(memb_free(&items, p[i]) != 0) {
+      FAIL(5);
+    }
+  }
+  for(i = 0; i < NUM_ITEMS; i += 2) {
+    struct item *q = memb_alloc(&items);
+    for(j = 1; j < NUM_ITEMS; j += 2) {
+      if(q == NULL || q == p[j]) {
+        FAIL(6);
+      }
+    }
+  }
+
+  /* Test 7: The block is full again. */
+  if(memb_alloc(&items) != NULL) {
+    FAIL(7);
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static int
+memb_test_reuse(void)
+{
+  int error;
+  struct item *a, *b, *c;
+
+  memb_init(&items);
+
+  a = memb_alloc(&items);
+  b = memb_alloc(&items);
+  if(a == NULL || b == NULL) {
+    FAIL(1);
+  }
+  a->next = b;
+  a->value = 1;
+  b->next = NULL;
+  b->value = 2;
+
+  /* Test 2: Freeing a block leaves its contents alone. */
+  memb_free(&items, a);
+  if(a->next != b || a->value != 1) {
+    FAIL(2);
+  }
+
+  /* Test 3: The same block is handed out again. */
+  c = memb_alloc(&items);
+  if(c != a) {
+    FAIL(3);
+  }
+
+  /* Test 4 and 5: Freed and reallocated again, then freed twice. */
+  memb_free(&items, c);
+  if(memb_alloc(&items) != a) {
+    FAIL(4);
+  }
+  memb_free(&items, a);
+  memb_free(&items, a);
+  c = memb_alloc(&items);
+  if(c != a || memb_alloc(&items) == a) {
+    FAIL(5);
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static int
+memb_test_list(void)
+{
+  int error;
+  struct item *p;
+  int i;
+
+  memb_init(&items);
+  list_init(item_list);
+
+  for(i = 0; i < NUM_ITEMS; i++) {
+    p = memb_alloc(&items);
+    if(p == NULL) {
+      FAIL(1);
+    }
+    p->value = i;
+    list_add(item_list, p);
+  }
+
+  /* Test 2: Items can be freed before they are removed from a list,
+     as several modules do. */
+  for(i = 0; i < NUM_ITEMS; i += 2) {
+    for(p = list_head(item_list); p != NULL; p = list_item_next(p)) {
+      if(p->value == i) {
+        memb_free(&items, p);
+        list_remove(item_list, p);
+        break;
+      }
+    }
+  }
+  if(list_length(item_list) != NUM_ITEMS / 2) {
+    FAIL(2);
+  }
+
+  /* Test 3: The remaining items are intact. */
+  i = 1;
+  for(p = list_head(item_list); p != NULL; p = list_item_next(p)) {
+    if(p->value != i) {
+      FAIL(3);
+    }
+    i += 2;
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static int
+memb_test_small(void)
+{
+  int error;
+  char *p[NUM_ITEMS];
+  int i;
+
+  memb_init(&bytes);
+
+  /* Test 1: Blocks of a single byte can all be allocated. */
+  for(i = 0; i < NUM_ITEMS; i++) {
+    p[i] = memb_alloc(&bytes);
+    if(p[i] == NULL) {
+      FAIL(1);
+    }
+    *p[i] = i;
+  }
+
+  /* Test 2: Freeing one does not touch its neighbours. */
+  memb_free(&bytes, p[3]);
+  for(i = 0; i < NUM_ITEMS; i++) {
+    if(*p[i] != i) {
+      FAIL(2);
+    }
+  }
+
+  /* Test 3: It is the only one that can be allocated. */
+  if(memb_alloc(&bytes) != p[3] || memb_alloc(&bytes) != NULL) {
+    FAIL(3);
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(memb_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  core_test_start("memb");
+  printf("Free list %s\n", MEMB_FREELIST ? "on" : "off");
+
+  core_test_result("Allocation", memb_test_alloc());
+  core_test_result("Block reuse", memb_test_reuse());
+  core_test_result("Free before list removal", memb_test_list());
+  core_test_result("Small blocks", memb_test_small());
+
+  core_test_finish("memb");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Tests for the managed memory allocator in lib/mmem.c. Blocks
+ *         are filled with a pattern and checked through MMEM_PTR()
+ *         after other blocks have been freed, reused and moved by a
+ *         compaction. The test ends with the rate of allocations and
+ *         frees under a random load, and with MMEM_CONF_STATS set,
+ *         with the number of compactions it took.
+ */
+
+#include "contiki.h"
+#include "lib/mmem.h"
+#include "lib/random.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(mmem_test_process, "Managed memory test process");
+AUTOSTART_PROCESSES(&mmem_test_process);
+
+#define SLOTS           32
+#define MAX_SIZE        200
+#define OPERATIONS      20000
+#define DURATION        (CLOCK_SECOND / 2)
+
+static struct mmem slot[SLOTS];
+static uint8_t allocated[SLOTS];
+/* Changed on every allocation, so that a block that is handed out
+   with the contents of an older one is noticed. */
+static uint8_t generation[SLOTS];
+/*---------------------------------------------------------------------------*/
+static uint8_t
+pattern(int i, unsigned offset)
+{
+  return i * 31 + generation[i] * 7 + offset;
+}
+/*---------------------------------------------------------------------------*/
+static int
+allocate(int i, unsigned size)
+{
+  uint8_t *p;
+  unsigned k;
+
+  if(!mmem_alloc(&slot[i], size)) {
+    return 0;
+  }
+  allocated[i] = 1;
+  generation[i]++;
+  p = (uint8_t *)MMEM_PTR(&slot[i]);
+  for(k = 0; k < size; k++) {
+    p[k] = pattern(i, k);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+release(int i)
+{
+  mmem_free(&slot[i]);
+  allocated[i] = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+release_all(void)
+{
+  int i;
+
+  for(i = 0; i < SLOTS; i++) {
+    if(allocated[i]) {
+      release(i);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check that all allocated blocks have kept their contents. */
+static int
+check_all(void)
+{
+  uint8_t *p;
+  unsigned k;
+  int i;
+
+  for(i = 0; i < SLOTS; i++) {
+    if(allocated[i]) {
+      p = (uint8_t *)MMEM_PTR(&slot[i]);
+      for(k = 0; k < slot[i].size; k++) {
+        if(p[k] != pattern(i, k)) {
+          return 0;
+        }
+      }
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mmem_test(void)
+{
+  int error;
+  void *old_ptr[SLOTS];
+  unsigned free_bytes;
+  int moved;
+  int i;
+
+  mmem_init();
+
+  /* Test 1: Blocks can be allocated and keep their contents. */
+  for(i = 0; i < 3; i++) {
+    if(!allocate(i, 100)) {
+      FAIL(1);
+    }
+  }
+  if(!check_all()) {
+    FAIL(1);
+  }
+
+  /* Test 2: A freed block is reused for a smaller block, without
+     moving the others. */
+  old_ptr[1] = slot[1].ptr;
+  old_ptr[2] = slot[2].ptr;
+  release(1);
+  if(!allocate(1, 60) || slot[1].ptr != old_ptr[1] ||
+     slot[2].ptr != old_ptr[2] || !check_all()) {
+    FAIL(2);
+  }
+  release_all();
+
+  /* Test 3 and 4: Fill the memory, free every other block, and
+     allocate a block that only fits if the others are moved. Their
+     contents must follow them. */
+  for(i = 0; i < SLOTS - 1 && allocate(i, MAX_SIZE); i++);
+  if(i == SLOTS - 1) {
+    /* MMEM_CONF_SIZE is too large for the slots to fill it. */
+    FAIL(3);
+  }
+  free_bytes = 0;
+  for(i = 0; i < SLOTS - 1; i += 2) {
+    if(allocated[i]) {
+      release(i);
+      free_bytes += MAX_SIZE;
+    }
+  }
+  for(i = 0; i < SLOTS - 1; i++) {
+    old_ptr[i] = slot[i].ptr;
+  }
+  if(!allocate(SLOTS - 1, free_bytes / 2)) {
+    FAIL(4);
+  }
+  moved = 0;
+  for(i = 1; i < SLOTS - 1; i += 2) {
+    if(allocated[i] && slot[i].ptr != old_ptr[i]) {
+      moved++;
+    }
+  }
+  if(moved == 0 || !check_all()) {
+    FAIL(4);
+  }
+
+  /* Test 5: A block larger than the free memory is refused, and
+     nothing is moved by the attempt. */
+  for(i = 0; i < SLOTS; i++) {
+    old_ptr[i] = slot[i].ptr;
+  }
+  if(mmem_alloc(&slot[0], free_bytes)) {
+    FAIL(5);
+  }
+  for(i = 1; i < SLOTS; i++) {
+    if(allocated[i] && slot[i].ptr != old_ptr[i]) {
+      FAIL(5);
+    }
+  }
+  release_all();
+
+  /* Test 6: Random allocations and frees of random sizes. */
+  for(i = 0; i < OPERATIONS; i++) {
+    int s = random_rand() % SLOTS;
+    if(allocated[s]) {
+      release(s);
+    } else {
+      allocate(s, 1 + random_rand() % MAX_SIZE);
+    }
+    if(i % 16 == 0 && !check_all()) {
+      FAIL(6);
+    }
+  }
+  if(!check_all()) {
+    FAIL(6);
+  }
+
+#if MMEM_STATS
+  /* Test 7: The statistics add up. */
+  {
+    struct mmem_stats stats;
+
+    mmem_stats(&stats);
+    if(stats.peak < stats.used || stats.fragmented > stats.free ||
+       stats.largest > stats.free || stats.compactions == 0) {
+      FAIL(7);
+    }
+    release_all();
+    mmem_stats(&stats);
+    if(stats.used != 0 || stats.largest > stats.free) {
+      FAIL(7);
+    }
+  }
+#endif /* MMEM_STATS */
+
+  error = 0;
+end:
+  release_all();
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+mmem_rate(void)
+{
+  unsigned long operations;
+  int s;
+
+  mmem_init();
+#if MMEM_STATS
+  mmem_stats_clear();
+#endif /* MMEM_STATS */
+  CORE_TEST_TIMED(operations, DURATION) {
+    s = random_rand() % SLOTS;
+    if(allocated[s]) {
+      mmem_free(&slot[s]);
+      allocated[s] = 0;
+    } else {
+      allocated[s] = mmem_alloc(&slot[s], 1 + random_rand() % MAX_SIZE);
+    }
+  }
+  release_all();
+  return CORE_TEST_PER_SECOND(operations, DURATION);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mmem_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  core_test_start("Managed memory");
+
+  core_test_result("Managed memory operations", mmem_test());
+
+  printf("Allocations and frees: %lu/s\n", mmem_rate());
+#if MMEM_STATS
+  {
+    struct mmem_stats stats;
+
+    mmem_stats(&stats);
+    printf("Peak use %u bytes, %u compactions\n", stats.peak,
+           stats.compactions);
+  }
+#endif /* MMEM_STATS */
+
+  core_test_finish("Managed memory");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
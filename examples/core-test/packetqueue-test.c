@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test for the per-neighbor packet queues of uIPv6
+ *         (uip-packetqueue), which hold the packets for a neighbor
+ *         whose link address is being resolved. Sends bursts of packets
+ *         to unresolved neighbors through tcpip_ipv6_output(), answers
+ *         with a Neighbor Advertisement and checks that the packets
+ *         leave in order. Also checks the limits of the queues and the
+ *         drop counters, and that a neighbor whose link address finds
+ *         no room in the neighbor table gets no packets. Needs IPv6: build it with
+ *         "make packetqueue-test UIP_CONF_IPV6=1".
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/uip-ds6.h"
+#include "net/uip-nd6.h"
+#include "net/uip-packetqueue.h"
+#include "net/neighbor-attr.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(packetqueue_test_process, "Packet queue test process");
+AUTOSTART_PROCESSES(&packetqueue_test_process);
+
+#if !UIP_STATISTICS
+#error packetqueue-test needs UIP_CONF_STATISTICS=1
+#endif /* !UIP_STATISTICS */
+
+/* Two neighbors fill the shared pool. */
+#if UIP_PACKETQUEUE_SIZE != 2 * UIP_PACKETQUEUE_NBR_MAX
+#error packetqueue-test needs UIP_CONF_PACKETQUEUE_SIZE=2*UIP_CONF_PACKETQUEUE_NBR_MAX
+#endif
+
+#define UIP_IP_BUF      ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_ICMP_BUF    ((struct uip_icmp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+#define UIP_UDP_BUF     ((struct uip_udp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+#define UIP_ND6_NA_BUF  ((uip_nd6_na *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + UIP_ICMPH_LEN])
+#define UIP_ND6_OPT_BUF (&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN])
+
+#define PAYLOAD_LEN     8
+#define NBR_MAX         UIP_PACKETQUEUE_NBR_MAX
+
+/* The UDP packets handed to the link layer: the last byte of their
+   destination and their sequence number. */
+static struct {
+  uint8_t nbr;
+  uint8_t seqno;
+} sent[2 * UIP_PACKETQUEUE_SIZE];
+static int num_sent;
+/*---------------------------------------------------------------------------*/
+/* Replaces the output function of the network stack. Neighbor
+   Solicitations are not recorded. */
+static u8_t
+output(uip_lladdr_t *lladdr)
+{
+  if(UIP_IP_BUF->proto == UIP_PROTO_UDP &&
+     num_sent < sizeof(sent) / sizeof(sent[0])) {
+    sent[num_sent].nbr = UIP_IP_BUF->destipaddr.u8[15];
+    sent[num_sent].seqno = uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN];
+    num_sent++;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+nbr_addr(uip_ipaddr_t *addr, int nbr)
+{
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0, 0, 0, nbr);
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_nbr_t *
+nbr_lookup(int nbr)
+{
+  uip_ipaddr_t addr;
+
+  nbr_addr(&addr, nbr);
+  return uip_ds6_nbr_lookup(&addr);
+}
+/*---------------------------------------------------------------------------*/
+/* Builds a UDP packet to fe80::nbr in uip_buf. */
+static void
+make_packet(int nbr, int seqno)
+{
+  memset(uip_buf, 0, UIP_LLH_LEN + UIP_IPUDPH_LEN + PAYLOAD_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr,
+                  &uip_ds6_get_link_local(-1)->ipaddr);
+  nbr_addr(&UIP_IP_BUF->destipaddr, nbr);
+  UIP_UDP_BUF->srcport = UIP_HTONS(1000);
+  UIP_UDP_BUF->destport = UIP_HTONS(1000);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN] = seqno;
+  uip_len = UIP_IPUDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(int nbr, int seqno)
+{
+  make_packet(nbr, seqno);
+  tcpip_ipv6_output();
+}
+/*---------------------------------------------------------------------------*/
+/* Passes a solicited Neighbor Advertisement from fe80::nbr to the
+   stack, as the answer to its Neighbor Solicitation. The last byte of
+   the link address is link. */
+static void
+input_na(int nbr, int link)
+{
+  uip_lladdr_t lladdr;
+
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN +
+    UIP_ND6_OPT_LLAO_LEN;
+  memset(uip_buf, 0, UIP_LLH_LEN + uip_len);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = uip_len - UIP_IPH_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = UIP_ND6_HOP_LIMIT;
+  nbr_addr(&UIP_IP_BUF->srcipaddr, nbr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr,
+                  &uip_ds6_get_link_local(-1)->ipaddr);
+  UIP_ICMP_BUF->type = ICMP6_NA;
+  UIP_ND6_NA_BUF->flagsreserved = UIP_ND6_NA_FLAG_SOLICITED |
+    UIP_ND6_NA_FLAG_OVERRIDE;
+  nbr_addr(&UIP_ND6_NA_BUF->tgtipaddr, nbr);
+  memset(&lladdr, 0, sizeof(lladdr));
+  lladdr.addr[sizeof(lladdr.addr) - 1] = link;
+  UIP_ND6_OPT_BUF[UIP_ND6_OPT_TYPE_OFFSET] = UIP_ND6_OPT_TLLAO;
+  UIP_ND6_OPT_BUF[UIP_ND6_OPT_LEN_OFFSET] = UIP_ND6_OPT_LLAO_LEN >> 3;
+  memcpy(&UIP_ND6_OPT_BUF[UIP_ND6_OPT_DATA_OFFSET], &lladdr,
+         UIP_LLADDR_LEN);
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+  uip_ext_len = 0;
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+static int
+queue_len(int nbr)
+{
+  uip_ds6_nbr_t *n;
+
+  n = nbr_lookup(nbr);
+  return n == NULL ? -1 : uip_packetqueue_len(&n->packethandle);
+}
+/*---------------------------------------------------------------------------*/
+static int
+packetqueue_test_resolution(void)
+{
+  int error;
+  int i;
+
+  memset(&uip_packetqueue_stat, 0, sizeof(uip_packetqueue_stat));
+  num_sent = 0;
+
+  /* Test 1: A burst to an unresolved neighbor is queued, and nothing
+     is sent. */
+  for(i = 0; i < NBR_MAX; i++) {
+    send_packet(1, i);
+  }
+  if(num_sent != 0 || queue_len(1) != NBR_MAX ||
+     nbr_lookup(1)->state != NBR_INCOMPLETE ||
+     uip_packetqueue_stat.queued != NBR_MAX) {
+    FAIL(1);
+  }
+
+  /* Test 2: The queue of a neighbor holds at most NBR_MAX packets. A
+     full queue drops the new packet. */
+  send_packet(1, NBR_MAX);
+  if(queue_len(1) != NBR_MAX || uip_packetqueue_stat.drop_full != 1) {
+    FAIL(2);
+  }
+
+  /* Test 3 and 4: A second neighbor takes the rest of the shared pool,
+     and a third one finds it empty. */
+  for(i = 0; i < NBR_MAX; i++) {
+    send_packet(2, i);
+  }
+  if(queue_len(2) != NBR_MAX) {
+    FAIL(3);
+  }
+  send_packet(3, 0);
+  if(queue_len(3) != 0 || uip_packetqueue_stat.drop_nomem != 1) {
+    FAIL(4);
+  }
+
+  /* Test 5: Once the first neighbor answers, its packets leave in the
+     order they were sent, and only they do. */
+  input_na(1, 1);
+  if(num_sent != NBR_MAX || queue_len(1) != 0 ||
+     nbr_lookup(1)->state != NBR_REACHABLE ||
+     uip_packetqueue_stat.sent != NBR_MAX) {
+    FAIL(5);
+  }
+  for(i = 0; i < NBR_MAX; i++) {
+    if(sent[i].nbr != 1 || sent[i].seqno != i) {
+      FAIL(5);
+    }
+  }
+
+  /* Test 6: The packets to a resolved neighbor are sent at once. */
+  send_packet(1, NBR_MAX);
+  if(num_sent != NBR_MAX + 1 || sent[NBR_MAX].seqno != NBR_MAX) {
+    FAIL(6);
+  }
+
+  /* Test 7: The third neighbor can use the buffers that the first one
+     has given back. */
+  send_packet(3, 1);
+  send_packet(3, 2);
+  if(queue_len(3) != 2) {
+    FAIL(7);
+  }
+
+  /* Test 8: Removing a neighbor drops its queue. */
+  uip_ds6_nbr_rm(nbr_lookup(2));
+  uip_ds6_nbr_rm(nbr_lookup(3));
+  if(uip_packetqueue_stat.drop_flush != NBR_MAX + 2) {
+    FAIL(8);
+  }
+
+  /* Test 9: The whole pool is free again. */
+  for(i = 0; i < NBR_MAX; i++) {
+    send_packet(2, i);
+    send_packet(3, i);
+  }
+  if(queue_len(2) != NBR_MAX || queue_len(3) != NBR_MAX) {
+    FAIL(9);
+  }
+
+  error = 0;
+ end:
+  for(i = 1; i <= 3; i++) {
+    uip_ds6_nbr_rm(nbr_lookup(i));
+  }
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+/* Neighbors of another layer that must not be evicted, which keep the
+   neighbor table full. */
+NEIGHBOR_ATTRIBUTE(uint8_t, pinned, NULL);
+static int num_pinned;
+/*---------------------------------------------------------------------------*/
+static int
+pinned_veto(void *data)
+{
+  return *(uint8_t *)data;
+}
+/*---------------------------------------------------------------------------*/
+static void
+pinned_addr(rimeaddr_t *addr, int i)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 0xaa;
+  addr->u8[1] = i;
+}
+/*---------------------------------------------------------------------------*/
+/* Adds pinned neighbors until the table has no room left. */
+static void
+fill_table(void)
+{
+  static const uint8_t one = 1;
+  rimeaddr_t addr;
+
+  for(;;) {
+    pinned_addr(&addr, num_pinned);
+    if(neighbor_attr_add_neighbor(&addr) < 0) {
+      return;
+    }
+    neighbor_attr_set_data(&pinned, &addr, (void *)&one);
+    num_pinned++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+unpin(int i)
+{
+  static const uint8_t zero = 0;
+  rimeaddr_t addr;
+
+  pinned_addr(&addr, i);
+  neighbor_attr_set_data(&pinned, &addr, (void *)&zero);
+  neighbor_attr_remove_neighbor(&addr);
+}
+/*---------------------------------------------------------------------------*/
+static int
+packetqueue_test_table_full(void)
+{
+  int error;
+  int i;
+  uip_ds6_nbr_t *n;
+
+  num_sent = 0;
+  num_pinned = 0;
+  fill_table();
+
+  /* Test 1: A neighbor whose link address finds no room in the
+     neighbor table stays incomplete, and its packets stay queued
+     instead of going to an unknown link address. */
+  send_packet(4, 0);
+  input_na(4, 4);
+  n = nbr_lookup(4);
+  if(n == NULL || n->state != NBR_INCOMPLETE || num_sent != 0 ||
+     queue_len(4) != 1) {
+    FAIL(1);
+  }
+
+  /* Test 2: Once there is room, the next answer resolves it. */
+  unpin(0);
+  input_na(4, 4);
+  n = nbr_lookup(4);
+  if(n == NULL || n->state != NBR_REACHABLE || num_sent != 1 ||
+     uip_ds6_nbr_get_ll(n)->addr[UIP_LLADDR_LEN - 1] != 4) {
+    FAIL(2);
+  }
+
+  /* Test 3: A neighbor whose new link address finds no room is
+     removed rather than kept with the old one. */
+  fill_table();
+  input_na(4, 5);
+  if(nbr_lookup(4) != NULL) {
+    FAIL(3);
+  }
+
+  /* Test 4: Its packets wait for the address to be resolved again. */
+  send_packet(4, 1);
+  if(num_sent != 1 || queue_len(4) != 1) {
+    FAIL(4);
+  }
+
+  error = 0;
+ end:
+  uip_ds6_nbr_rm(nbr_lookup(4));
+  for(i = 0; i < num_pinned; i++) {
+    unpin(i);
+  }
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static int
+packetqueue_test_lifetime(void)
+{
+  static struct uip_packetqueue_handle queue;
+  int error;
+  clock_time_t start;
+
+  memset(&uip_packetqueue_stat, 0, sizeof(uip_packetqueue_stat));
+  uip_packetqueue_new(&queue);
+
+  /* Test 1: Packets can be queued with a lifetime. */
+  make_packet(1, 0);
+  if(!uip_packetqueue_store(&queue, CLOCK_SECOND / 10)) {
+    FAIL(1);
+  }
+  make_packet(1, 1);
+  if(!uip_packetqueue_store(&queue, CLOCK_SECOND / 5)) {
+    FAIL(1);
+  }
+
+  /* Test 2: They are dropped when it expires. */
+  start = clock_time();
+  while(uip_packetqueue_len(&queue) > 0 &&
+        clock_time() - start < CLOCK_SECOND) {
+    etimer_request_poll();
+    process_run();
+  }
+  if(uip_packetqueue_len(&queue) != 0 ||
+     uip_packetqueue_stat.drop_timeout != 2) {
+    FAIL(2);
+  }
+
+  error = 0;
+ end:
+  uip_packetqueue_free(&queue);
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(packetqueue_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  core_test_start("Packet queue");
+  printf("%d packets, at most %d per neighbor\n", UIP_PACKETQUEUE_SIZE,
+         UIP_PACKETQUEUE_NBR_MAX);
+
+  tcpip_set_outputfunc(output);
+  neighbor_attr_register(&pinned);
+  neighbor_attr_set_evict_veto(&pinned, pinned_veto);
+
+  core_test_result("Address resolution", packetqueue_test_resolution());
+  core_test_result("Full neighbor table", packetqueue_test_table_full());
+  core_test_result("Lifetime", packetqueue_test_lifetime());
+
+  core_test_finish("Packet queue");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test and benchmark for process polls. Checks that polled
+ *         processes are called once per poll round, and times a poll
+ *         with 1, 10 and 100 other processes loaded. Build it with
+ *         POLL_QUEUE=0 to time the walk of the process list instead of
+ *         the poll queue. Built with
+ *         PRIORITIES=1, it also checks that the polls of and events to
+ *         high priority processes come first, and that a full event
+ *         queue is counted.
+ */
+
+#include "contiki.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(process_test_process, "Process test process");
+PROCESS(poll_a_process, "Poll A");
+PROCESS(poll_b_process, "Poll B");
+PROCESS(poll_self_process, "Poll self");
+PROCESS(idle_process, "Idle");
+#if PROCESS_CONF_PRIORITIES
+PROCESS(poll_high_process, "Poll high");
+PROCESS(event_process, "Event");
+PROCESS_PRIO(high_process, "High", PROCESS_PRIO_HIGH);
+#endif /* PROCESS_CONF_PRIORITIES */
+AUTOSTART_PROCESSES(&process_test_process);
+
+#define MAX_IDLE        100
+
+static struct process idle[MAX_IDLE];
+static int num_idle;
+
+/* The processes called with a poll, in order. */
+static char calls[8];
+static int num_calls;
+
+static const int counts[] = { 1, 10, 100 };
+/*---------------------------------------------------------------------------*/
+static void
+record_call(char c)
+{
+  if(num_calls < sizeof(calls) - 1) {
+    calls[num_calls++] = c;
+    calls[num_calls] = '\0';
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(poll_a_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    record_call('a');
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(poll_b_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    record_call('b');
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(poll_self_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    record_call('s');
+    process_poll(PROCESS_CURRENT());
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(idle_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD();
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+/* Polls the high priority process. */
+PROCESS_THREAD(poll_high_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    record_call('c');
+    process_poll(&high_process);
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(event_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+    record_call('n');
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(high_process, ev, data)
+{
+  PROCESS_BEGIN();
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_POLL) {
+      record_call('H');
+    } else if(ev == PROCESS_EVENT_CONTINUE) {
+      record_call('h');
+    }
+  }
+  PROCESS_END();
+}
+#endif /* PROCESS_CONF_PRIORITIES */
+/*---------------------------------------------------------------------------*/
+/* Runs one poll round. Called from within the test process, so events
+   posted to the test process meanwhile are lost. */
+static void
+run_polls(void)
+{
+  num_calls = 0;
+  calls[0] = '\0';
+  while(process_run() > 0);
+}
+/*---------------------------------------------------------------------------*/
+static int
+process_test_polls(void)
+{
+  int error;
+
+  process_start(&poll_a_process, NULL);
+  process_start(&poll_b_process, NULL);
+  run_polls();
+
+  /* Test 1: Each polled process is called once, however often it was
+     polled. */
+  process_poll(&poll_b_process);
+  process_poll(&poll_a_process);
+  process_poll(&poll_b_process);
+  run_polls();
+  if(num_calls != 2 || strchr(calls, 'a') == NULL ||
+     strchr(calls, 'b') == NULL) {
+    FAIL(1);
+  }
+#if PROCESS_CONF_POLL_QUEUE
+  /* ... in the order of their first poll. */
+  if(strcmp(calls, "ba") != 0) {
+    FAIL(1);
+  }
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+  /* Test 2: A process that polls itself is called once per round and
+     does not keep the others from their turn. */
+  process_start(&poll_self_process, NULL);
+  process_poll(&poll_self_process);
+  process_poll(&poll_a_process);
+  num_calls = 0;
+  calls[0] = '\0';
+  process_run();
+  if(num_calls != 2 || strchr(calls, 'a') == NULL) {
+    FAIL(2);
+  }
+  process_exit(&poll_self_process);
+
+  /* Test 3: A process that exits with a poll pending is not called. */
+  process_poll(&poll_a_process);
+  process_poll(&poll_b_process);
+  process_exit(&poll_a_process);
+  run_polls();
+  if(strcmp(calls, "b") != 0) {
+    FAIL(3);
+  }
+
+  error = 0;
+ end:
+  process_exit(&poll_a_process);
+  process_exit(&poll_b_process);
+  process_exit(&poll_self_process);
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+static int
+process_test_priorities(void)
+{
+  int error;
+  int i;
+
+  process_start(&poll_a_process, NULL);
+  process_start(&poll_b_process, NULL);
+  process_start(&poll_high_process, NULL);
+  process_start(&event_process, NULL);
+  process_start(&high_process, NULL);
+  run_polls();
+
+  /* Test 1: A high priority process polled last is called first. */
+  process_poll(&poll_a_process);
+  process_poll(&poll_b_process);
+  process_poll(&high_process);
+  run_polls();
+  if(num_calls != 3 || calls[0] != 'H') {
+    FAIL(1);
+  }
+
+  /* Test 2: A high priority poll requested during a round of normal
+     polls does not wait for the end of the round. */
+  process_poll(&poll_high_process);
+  process_poll(&poll_a_process);
+  process_poll(&poll_b_process);
+  run_polls();
+  if(num_calls != 4 || strstr(calls, "cH") == NULL) {
+    FAIL(2);
+  }
+
+  /* Test 3: An event to a high priority process is delivered before
+     the events posted earlier to normal ones. */
+  process_post(&event_process, PROCESS_EVENT_CONTINUE, NULL);
+  process_post(&event_process, PROCESS_EVENT_CONTINUE, NULL);
+  process_post(&high_process, PROCESS_EVENT_CONTINUE, NULL);
+  run_polls();
+  if(strcmp(calls, "hnn") != 0) {
+    FAIL(3);
+  }
+
+#if PROCESS_CONF_STATS
+  process_event_overflows = 0;
+#endif /* PROCESS_CONF_STATS */
+
+  /* Test 4 and 5: The high priority queue holds
+     PROCESS_CONF_NUMEVENTS_HIGH events, and one more is refused and
+     counted. */
+  for(i = 0; i < PROCESS_CONF_NUMEVENTS_HIGH; i++) {
+    if(process_post(&high_process, PROCESS_EVENT_CONTINUE, NULL) !=
+       PROCESS_ERR_OK) {
+      FAIL(4);
+    }
+  }
+  if(process_post(&high_process, PROCESS_EVENT_CONTINUE, NULL) !=
+     PROCESS_ERR_FULL) {
+    FAIL(5);
+  }
+#if PROCESS_CONF_STATS
+  if(process_event_overflows != 1) {
+    FAIL(5);
+  }
+#endif /* PROCESS_CONF_STATS */
+
+  /* Test 6 and 7: The normal queue is separate, and holds
+     PROCESS_CONF_NUMEVENTS events. */
+  for(i = 0; i < PROCESS_CONF_NUMEVENTS; i++) {
+    if(process_post(&event_process, PROCESS_EVENT_CONTINUE, NULL) !=
+       PROCESS_ERR_OK) {
+      FAIL(6);
+    }
+  }
+  if(process_post(&event_process, PROCESS_EVENT_CONTINUE, NULL) !=
+     PROCESS_ERR_FULL) {
+    FAIL(7);
+  }
+#if PROCESS_CONF_STATS
+  if(process_event_overflows != 2) {
+    FAIL(7);
+  }
+
+  /* Test 8: The peak counts the events of both full queues, also when
+     there are more than 255 of them. */
+  if(process_maxevents !=
+     PROCESS_CONF_NUMEVENTS + PROCESS_CONF_NUMEVENTS_HIGH) {
+    FAIL(8);
+  }
+#endif /* PROCESS_CONF_STATS */
+
+  error = 0;
+ end:
+  run_polls();
+  process_exit(&poll_a_process);
+  process_exit(&poll_b_process);
+  process_exit(&poll_high_process);
+  process_exit(&event_process);
+  process_exit(&high_process);
+  return error;
+}
+#endif /* PROCESS_CONF_PRIORITIES */
+/*---------------------------------------------------------------------------*/
+/* Returns the number of polls dispatched in a quarter of a second with
+   n idle processes loaded. */
+static unsigned long
+poll_rate(int n)
+{
+  unsigned long rounds;
+
+  while(num_idle < n) {
+    idle[num_idle] = idle_process;
+    process_start(&idle[num_idle], NULL);
+    num_idle++;
+  }
+  process_start(&poll_a_process, NULL);
+
+  CORE_TEST_TIMED(rounds, CLOCK_SECOND / 4) {
+    process_poll(&poll_a_process);
+    process_run();
+  }
+  process_exit(&poll_a_process);
+  return rounds;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(process_test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  core_test_start("Process");
+
+  core_test_result("Polls", process_test_polls());
+#if PROCESS_CONF_PRIORITIES
+  core_test_result("Priorities", process_test_priorities());
+#endif /* PROCESS_CONF_PRIORITIES */
+
+  printf("PROCESS_CONF_POLL_QUEUE %d\n", PROCESS_CONF_POLL_QUEUE);
+  printf("PROCESS_CONF_PRIORITIES %d\n", PROCESS_CONF_PRIORITIES);
+  printf("processes  polls/s\n");
+  for(i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+    printf("%9d  %7lu\n", counts[i], poll_rate(counts[i]) * 4);
+  }
+
+  core_test_finish("Process");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
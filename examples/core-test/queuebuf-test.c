@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Tests for the queue buffers, for the configuration they are
+ *         built in: in RAM, swapped to CFS (QUEUEBUF=swap in the
+ *         Makefile) or packed (QUEUEBUF=packed). Packets are queued
+ *         and dequeued in bursts, as a MAC layer does, and compared
+ *         with the packets that were queued. The test ends with the
+ *         number of packets of some lengths that can be queued, and
+ *         the rate of queued and dequeued packets.
+ */
+
+#include "contiki-net.h"
+#include "lib/random.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(queuebuf_test_process, "Queuebuf test process");
+AUTOSTART_PROCESSES(&queuebuf_test_process);
+
+#define OPERATIONS      20000
+#define MAX_LEN         100
+#define BURST           8
+#define DURATION        (CLOCK_SECOND / 2)
+
+/* The queued packets, oldest first, with what was put into them. */
+static struct queuebuf *queue[QUEUEBUF_NUM];
+static uint16_t queue_id[QUEUEBUF_NUM];
+static packetbuf_attr_t queue_attr[QUEUEBUF_NUM];
+static unsigned queue_head;
+static unsigned queue_len;
+static uint16_t next_id;
+#if QUEUEBUF_PACKED
+static unsigned long dropped_updates;
+#endif /* QUEUEBUF_PACKED */
+/*---------------------------------------------------------------------------*/
+static unsigned
+packet_len(uint16_t id)
+{
+  return 1 + id * 37 % MAX_LEN;
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_packet(uint16_t id, unsigned len)
+{
+  uint8_t *data;
+  rimeaddr_t addr;
+  unsigned i;
+
+  packetbuf_clear();
+  data = packetbuf_dataptr();
+  for(i = 0; i < len; i++) {
+    data[i] = id + i * 7;
+  }
+  packetbuf_set_datalen(len);
+  packetbuf_set_attr(PACKETBUF_ATTR_PACKET_ID, id);
+  packetbuf_set_attr(PACKETBUF_ATTR_CHANNEL, 26);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, 3);
+  addr.u8[0] = id;
+  addr.u8[1] = id >> 8;
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &rimeaddr_node_addr);
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_packet(struct queuebuf *b, uint16_t id, packetbuf_attr_t attr)
+{
+  uint8_t *data;
+  const rimeaddr_t *addr;
+  unsigned len;
+  unsigned i;
+
+  len = packet_len(id);
+  if(queuebuf_datalen(b) != len ||
+     queuebuf_attr(b, PACKETBUF_ATTR_PACKET_ID) != id ||
+     queuebuf_attr(b, PACKETBUF_ATTR_NUM_REXMIT) != attr) {
+    return 0;
+  }
+  queuebuf_to_packetbuf(b);
+  data = packetbuf_dataptr();
+  for(i = 0; i < len; i++) {
+    if(data[i] != (uint8_t)(id + i * 7)) {
+      return 0;
+    }
+  }
+  addr = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+  return packetbuf_datalen() == len &&
+    packetbuf_attr(PACKETBUF_ATTR_PACKET_ID) == id &&
+    packetbuf_attr(PACKETBUF_ATTR_CHANNEL) == 26 &&
+    packetbuf_attr(PACKETBUF_ATTR_NUM_REXMIT) == attr &&
+    addr->u8[0] == (uint8_t)id && addr->u8[1] == (uint8_t)(id >> 8) &&
+    rimeaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
+                 &rimeaddr_node_addr);
+}
+/*---------------------------------------------------------------------------*/
+static struct queuebuf *
+enqueue(void)
+{
+  struct queuebuf *b;
+  unsigned i;
+
+  make_packet(next_id, packet_len(next_id));
+  b = queuebuf_new_from_packetbuf();
+  if(b != NULL) {
+    i = (queue_head + queue_len) % QUEUEBUF_NUM;
+    queue[i] = b;
+    queue_id[i] = next_id++;
+    queue_attr[i] = 0;
+    queue_len++;
+  }
+  return b;
+}
+/*---------------------------------------------------------------------------*/
+static int
+dequeue(void)
+{
+  int ok;
+
+  ok = check_packet(queue[queue_head], queue_id[queue_head],
+                    queue_attr[queue_head]);
+  queuebuf_free(queue[queue_head]);
+  queue_head = (queue_head + 1) % QUEUEBUF_NUM;
+  queue_len--;
+  return ok;
+}
+/*---------------------------------------------------------------------------*/
+static void
+dequeue_all(void)
+{
+  while(queue_len > 0) {
+    dequeue();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+queue_test(void)
+{
+  int error;
+  unsigned n;
+  unsigned i;
+  unsigned count;
+  uint16_t first;
+
+  /* Test 1: A queued packet is read back. */
+  if(enqueue() == NULL) {
+    FAIL(1);
+  }
+  if(!dequeue()) {
+    FAIL(1);
+  }
+
+  /* Test 2: The queue can be filled. Packed queuebufs run out of room
+     before QUEUEBUF_NUM, but not before the packets fill as much RAM
+     as QUEUEBUFRAM_NUM unpacked ones. */
+  first = next_id;
+  while(queue_len < QUEUEBUF_NUM && enqueue() != NULL);
+#if QUEUEBUF_PACKED
+  if(queue_len < QUEUEBUFRAM_NUM) {
+    FAIL(2);
+  }
+#else /* QUEUEBUF_PACKED */
+  if(queue_len != QUEUEBUF_NUM) {
+    FAIL(2);
+  }
+#endif /* QUEUEBUF_PACKED */
+  count = queue_len;
+
+  /* Test 3: The filled queue is read back. */
+  while(queue_len > 0) {
+    if(!dequeue()) {
+      FAIL(3);
+    }
+  }
+
+  /* Test 4: The same packets fit again after the queue has been
+     emptied. */
+  next_id = first;
+  while(queue_len < count) {
+    if(enqueue() == NULL) {
+      FAIL(4);
+    }
+  }
+  dequeue_all();
+
+  /* Test 5 and 6: Bursts of queued and dequeued packets, and updates
+     of queued packets, which changes them in the swap or moves them
+     in the packed arena. */
+  for(n = 0; n < OPERATIONS; n++) {
+    switch(random_rand() % 3) {
+    case 0:
+      for(i = random_rand() % BURST; i > 0 && queue_len < QUEUEBUF_NUM; i--) {
+        if(enqueue() == NULL) {
+#if !QUEUEBUF_PACKED
+          FAIL(5);
+#endif /* !QUEUEBUF_PACKED */
+          break;
+        }
+      }
+      break;
+    case 1:
+      for(i = random_rand() % BURST; i > 0 && queue_len > 0; i--) {
+        if(!dequeue()) {
+          FAIL(6);
+        }
+      }
+      break;
+    default:
+      if(queue_len > 0) {
+        i = (queue_head + random_rand() % queue_len) % QUEUEBUF_NUM;
+        queuebuf_to_packetbuf(queue[i]);
+        queue_attr[i] = random_rand() % 8;
+        packetbuf_set_attr(PACKETBUF_ATTR_NUM_REXMIT, queue_attr[i]);
+        queuebuf_update_attr_from_packetbuf(queue[i]);
+#if QUEUEBUF_PACKED
+        /* A packed queuebuf keeps its old attributes if the arena
+           has no room for the new ones. */
+        if(queuebuf_attr(queue[i], PACKETBUF_ATTR_NUM_REXMIT) !=
+           queue_attr[i]) {
+          queue_attr[i] = queuebuf_attr(queue[i], PACKETBUF_ATTR_NUM_REXMIT);
+          dropped_updates++;
+        }
+#endif /* QUEUEBUF_PACKED */
+      }
+      break;
+    }
+  }
+
+  /* Test 7: The packets that are left are intact. */
+  while(queue_len > 0) {
+    if(!dequeue()) {
+      FAIL(7);
+    }
+  }
+
+  error = 0;
+end:
+  dequeue_all();
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+/* The number of packets of a length that can be queued. */
+static unsigned
+capacity(unsigned len)
+{
+  unsigned count;
+
+  for(count = 0; count < QUEUEBUF_NUM; count++) {
+    make_packet(count, len);
+    queue[count] = queuebuf_new_from_packetbuf();
+    if(queue[count] == NULL) {
+      break;
+    }
+  }
+  for(len = 0; len < count; len++) {
+    queuebuf_free(queue[len]);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+queue_rate(void)
+{
+  unsigned long rounds, packets;
+  unsigned i;
+
+  packets = 0;
+  CORE_TEST_TIMED(rounds, DURATION) {
+    for(i = 0; i < QUEUEBUF_NUM && enqueue() != NULL; i++);
+    packets += queue_len;
+    dequeue_all();
+  }
+  return CORE_TEST_PER_SECOND(packets, DURATION);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(queuebuf_test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  core_test_start("Queuebuf");
+  printf("%d queuebufs, %d in RAM%s%s\n",
+         QUEUEBUF_NUM, QUEUEBUFRAM_NUM, WITH_SWAP ? ", swapped" : "",
+         QUEUEBUF_PACKED ? ", packed" : "");
+
+  queuebuf_init();
+
+  core_test_result("Queue operations", queue_test());
+
+#if QUEUEBUF_PACKED
+  printf("Updates dropped for lack of room: %lu\n", dropped_updates);
+#endif /* QUEUEBUF_PACKED */
+  printf("Queued packets of %u, 100, 40 and 10 bytes: %u %u %u %u\n",
+         PACKETBUF_SIZE, capacity(PACKETBUF_SIZE), capacity(100),
+         capacity(40), capacity(10));
+  printf("Queued packets: %lu/s\n", queue_rate());
+
+  core_test_finish("Queuebuf");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,114 @@
+#!/bin/sh
+#
+# Builds the core tests on the native platform and runs each of them,
+# in every configuration the Makefile offers: each CRC16 method,
+# process priorities with and without the poll queue and with more
+# than 255 events in the two event queues, the swapped and
+# packed queuebufs, and the tests that need uIPv6, with and without a
+# pool of packet buffers.
+#
+# coffee-image-test is also run on an image file, and the Coffee
+# configuration it prints must match the native.properties of
+# tools/coffee-manager. If Java is installed, coffee-manager is built
+# and must extract the files the test wrote through their micro logs.
+#
+# Every test exits with a nonzero status if one of its checks failed.
+# Prints the last line of each test, and exits with status 1 if any
+# test failed, could not be built or did not finish.
+#
+# Usage: ./run-tests.sh [make arguments, e.g. -j4]
+
+TESTS="memb-test crc16-test coffee-log-test coffee-image-test \
+cfs-cache-test queuebuf-test mmem-test etimer-test process-test"
+COFFEE_MANAGER=../../tools/coffee-manager
+IMAGE_FILES="image-test image-test-log"
+TIMEOUT=300
+
+MAKEARGS="$*"
+failed=0
+
+# Builds the given programs with the given configuration and runs them.
+run() {
+  programs=$1
+  config=${2:-default}
+  make TARGET=native clean > /dev/null 2>&1
+  if ! make TARGET=native $MAKEARGS $2 $programs > run-tests.log 2>&1; then
+    cat run-tests.log >&2
+    echo "$programs, $config build: ERROR"
+    failed=1
+    return
+  fi
+  for program in $programs; do
+    timeout $TIMEOUT ./$program.native > run-tests.log 2>&1
+    status=$?
+    if [ $status -ne 0 ]; then
+      cat run-tests.log
+      echo "$program, $config: ERROR (status $status)"
+      failed=1
+    else
+      echo "$program, $config: $(tail -n 1 run-tests.log)"
+    fi
+  done
+}
+
+# Prints the settings of native.properties that are found in the file
+# given, sorted.
+properties() {
+  awk 'NR == FNR { keys[$1]; next } NF == 2 && $1 in keys { print $1, $2 }' \
+    $COFFEE_MANAGER/native.properties $1 | sort
+}
+
+# Runs coffee-image-test, as built by the last run, on an image file
+# and checks the image with coffee-manager.
+image_test() {
+  dir=$(mktemp -d)
+  program=$PWD/coffee-image-test.native
+  if ! (cd $dir && XMEM_IMAGE=image timeout $TIMEOUT $program) \
+       > $dir/output 2>&1; then
+    cat $dir/output
+    echo "coffee-image-test, image: ERROR"
+    failed=1
+  elif properties $dir/output > $dir/built &&
+       properties $COFFEE_MANAGER/native.properties > $dir/tool &&
+       ! diff $dir/tool $dir/built; then
+    echo "coffee-image-test, native.properties: ERROR"
+    failed=1
+  else
+    echo "coffee-image-test, native.properties: OK"
+    if command -v javac > /dev/null && command -v java > /dev/null; then
+      cp -r $COFFEE_MANAGER $dir/coffee-manager
+      (cd $dir/coffee-manager && ./build.sh) > /dev/null 2>&1
+      for file in $IMAGE_FILES; do
+        if (cd $dir && java -jar coffee-manager/coffee.jar -p native \
+              -e $file image) > /dev/null 2>&1 &&
+           cmp -s $dir/$file $dir/$file.expected; then
+          echo "coffee-manager, $file: OK"
+        else
+          echo "coffee-manager, $file: ERROR"
+          failed=1
+        fi
+      done
+    else
+      echo "coffee-manager: not checked, Java is not installed"
+    fi
+  fi
+  rm -rf $dir
+}
+
+run "$TESTS"
+image_test
+for method in CRC16_BITWISE CRC16_NIBBLE CRC16_SLICE4; do
+  run crc16-test CRC16_METHOD=$method
+done
+run process-test PRIORITIES=1
+run process-test "PRIORITIES=1 POLL_QUEUE=0"
+run process-test "PRIORITIES=1 NUMEVENTS_HIGH=250"
+run queuebuf-test QUEUEBUF=swap
+run queuebuf-test QUEUEBUF=packed
+run "chksum-test udp-demux-test packetqueue-test udp-packet-test" \
+  UIP_CONF_IPV6=1
+run udp-packet-test "UIP_CONF_IPV6=1 BUF_POOL=4"
+
+make TARGET=native clean > /dev/null 2>&1
+rm -f run-tests.log
+exit $failed
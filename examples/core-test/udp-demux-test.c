@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test and benchmark for the demultiplexing of incoming UDP
+ *         packets in uIPv6. Opens up to 128 UDP connections and times
+ *         uip_process() on a packet for the connection that a linear
+ *         scan finds last. Needs IPv6: build it with
+ *         "make udp-demux-test UIP_CONF_IPV6=1", once as it is and once
+ *         with DEFINES=UIP_CONF_UDP_CONN_HASH=16, and compare the
+ *         figures.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(udp_demux_test_process, "UDP demux test process");
+PROCESS(udp_demux_sink_process, "UDP demux sink process");
+AUTOSTART_PROCESSES(&udp_demux_test_process);
+
+#define UIP_IP_BUF      ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_UDP_BUF     ((struct uip_udp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+
+#define PAYLOAD_LEN     8
+#define MAX_CONNS       128
+
+static struct uip_udp_conn *conns[MAX_CONNS];
+static int num_conns;
+
+static u8_t packet[UIP_IPUDPH_LEN + PAYLOAD_LEN];
+
+/* The connection the sink was last called for. */
+static struct uip_udp_conn *delivered;
+
+static const int counts[] = { 1, 8, 32, 128 };
+/*---------------------------------------------------------------------------*/
+/* Called synchronously from uip_process() through tcpip_uipcall(). */
+PROCESS_THREAD(udp_demux_sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == tcpip_event) {
+      delivered = data;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Opens connections until there are n, delivering to the sink. */
+static int
+open_conns(int n)
+{
+  struct uip_udp_conn *c;
+
+  while(num_conns < n) {
+    c = uip_udp_new(NULL, 0);
+    if(c == NULL) {
+      return 0;
+    }
+    c->appstate.p = &udp_demux_sink_process;
+    c->appstate.state = c;
+    conns[num_conns++] = c;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Builds a packet from fe80::2 to the all-nodes address for the local
+   port of conn, without a checksum so that only the headers are
+   processed. */
+static void
+make_packet(struct uip_udp_conn *conn)
+{
+  memset(uip_buf, 0, UIP_IPUDPH_LEN + UIP_LLH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 2);
+  uip_create_linklocal_allnodes_mcast(&UIP_IP_BUF->destipaddr);
+  UIP_UDP_BUF->srcport = UIP_HTONS(1000);
+  UIP_UDP_BUF->destport = conn->lport;
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->udpchksum = 0;
+  memcpy(packet, &uip_buf[UIP_LLH_LEN], sizeof(packet));
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_packet(void)
+{
+  memcpy(&uip_buf[UIP_LLH_LEN], packet, sizeof(packet));
+  uip_len = sizeof(packet);
+  uip_ext_len = 0;
+  uip_process(UIP_DATA);
+}
+/*---------------------------------------------------------------------------*/
+static int
+udp_demux_test_delivery(void)
+{
+  int error;
+  int i;
+
+  /* Test 1: The connections can be opened. */
+  if(!open_conns(MAX_CONNS)) {
+    FAIL(1);
+  }
+
+  /* Test 2: A packet for the local port of a connection reaches that
+     connection. */
+  for(i = 0; i < MAX_CONNS; ++i) {
+    make_packet(conns[i]);
+    delivered = NULL;
+    input_packet();
+    if(delivered != conns[i]) {
+      FAIL(2);
+    }
+  }
+
+  /* Test 3: A connection bound to another remote port does not get
+     the packet, and the next one for the same local port does. */
+  make_packet(conns[0]);
+  conns[0]->rport = UIP_HTONS(1001);
+  uip_udp_bind(conns[1], conns[0]->lport);
+  delivered = NULL;
+  input_packet();
+  if(delivered != conns[1]) {
+    FAIL(3);
+  }
+
+  /* Test 4: Once the connection is removed, the packet is no longer
+     delivered. */
+  uip_udp_remove(conns[1]);
+  delivered = NULL;
+  input_packet();
+  if(delivered != NULL) {
+    FAIL(4);
+  }
+
+  error = 0;
+ end:
+  for(i = 0; i < num_conns; ++i) {
+    uip_udp_remove(conns[i]);
+  }
+  num_conns = 0;
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of packets processed in a quarter of a second
+   with n connections open, for the one opened last. */
+static unsigned long
+udp_demux_rate(int n)
+{
+  unsigned long rounds;
+
+  if(!open_conns(n)) {
+    return 0;
+  }
+  make_packet(conns[n - 1]);
+  CORE_TEST_TIMED(rounds, CLOCK_SECOND / 4) {
+    input_packet();
+  }
+  return rounds;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(udp_demux_test_process, ev, data)
+{
+  unsigned long base, rate;
+  int i;
+
+  PROCESS_BEGIN();
+
+  core_test_start("UDP demux");
+
+  process_start(&udp_demux_sink_process, NULL);
+
+  core_test_result("Delivery", udp_demux_test_delivery());
+
+  printf("UDP_CONN_HASH %u\n", UIP_UDP_CONN_HASH);
+  printf("conns  packets/s\n");
+  base = 0;
+  for(i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+    rate = udp_demux_rate(counts[i]);
+    if(base == 0) {
+      base = rate;
+    }
+    printf("%5d  %9lu (%lu%% of 1 conn)\n", counts[i], rate * 4,
+           base ? rate * 100 / base : 0);
+  }
+
+  core_test_finish("UDP demux");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Test for the zero-copy UDP API of uIPv6. Checks that a
+ *         payload written through uip_udp_packet_reserve() is sent as
+ *         it is and, with a buffer pool, that the datagram taken by
+ *         uip_udp_packet_take() in the tcpip_event handler stays intact
+ *         after the handler has returned, and that the datagram stays
+ *         in uip_buf if the pool is empty, and that
+ *         tcpip_ipv6_output_buf() sends a datagram from its own pool
+ *         buffer, or keeps the buffer while the datagram waits for
+ *         address resolution. Needs IPv6: build it with
+ *         "make udp-packet-test UIP_CONF_IPV6=1 BUF_POOL=4".
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/uip-udp-packet.h"
+#include "core-test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(udp_packet_test_process, "UDP packet test process");
+#if UIP_CONF_BUF_POOL
+PROCESS(udp_packet_sink_process, "UDP packet sink process");
+#endif /* UIP_CONF_BUF_POOL */
+AUTOSTART_PROCESSES(&udp_packet_test_process);
+
+#define UIP_IP_BUF      ((struct uip_ip_hdr *)&uip_buf[UIP_LLH_LEN])
+#define UIP_UDP_BUF     ((struct uip_udp_hdr *)&uip_buf[UIP_LLH_LEN + UIP_IPH_LEN])
+#define UDP_PAYLOAD     (&uip_buf[UIP_LLH_LEN + UIP_IPUDPH_LEN])
+
+#define PORT            3001
+#define PAYLOAD_LEN     64
+
+static struct uip_udp_conn *conn;
+#if UIP_CONF_BUF_POOL
+static struct uip_udp_conn *sink_conn;
+#endif /* UIP_CONF_BUF_POOL */
+
+/* The payload of the last datagram handed to the link layer. */
+static uint8_t sent[PAYLOAD_LEN];
+static int sent_len;
+#if UIP_CONF_BUF_POOL
+static uip_buf_t *sent_buf;
+#endif /* UIP_CONF_BUF_POOL */
+
+#if UIP_CONF_BUF_POOL
+/* What the sink saw of the last datagram delivered to it. */
+static uip_buf_t *taken;
+static uint8_t *taken_data;
+static int delivered_len;
+#endif /* UIP_CONF_BUF_POOL */
+/*---------------------------------------------------------------------------*/
+/* Replaces the output function of the network stack. */
+static u8_t
+output(uip_lladdr_t *lladdr)
+{
+  sent_len = uip_len - UIP_IPUDPH_LEN;
+  if(sent_len > 0 && sent_len <= sizeof(sent)) {
+    memcpy(sent, UDP_PAYLOAD, sent_len);
+  }
+#if UIP_CONF_BUF_POOL
+  sent_buf = uip_bufp;
+#endif /* UIP_CONF_BUF_POOL */
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_CONF_BUF_POOL
+/* Called synchronously from uip_process() through tcpip_uipcall(). */
+PROCESS_THREAD(udp_packet_sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == tcpip_event && uip_newdata()) {
+      delivered_len = uip_datalen();
+      taken = uip_udp_packet_take(&taken_data);
+    }
+  }
+
+  PROCESS_END();
+}
+#endif /* UIP_CONF_BUF_POOL */
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint8_t *data, int len, int seqno)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    data[i] = seqno + i;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+check(const uint8_t *data, int len, int seqno)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    if(data[i] != (uint8_t)(seqno + i)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+udp_packet_test_send(void)
+{
+  int error;
+  uint8_t *data;
+
+  /* Test 1: The payload area is in uip_buf, after the headers, and a
+     payload that does not fit is refused. */
+  data = uip_udp_packet_reserve(PAYLOAD_LEN);
+  if(data != UDP_PAYLOAD ||
+     uip_udp_packet_reserve(UIP_BUFSIZE) != NULL ||
+     uip_udp_packet_reserve(-1) != NULL) {
+    FAIL(1);
+  }
+
+  /* Test 2: A payload written there is sent as it is. */
+  fill(data, PAYLOAD_LEN, 1);
+  sent_len = 0;
+  uip_udp_packet_send(conn, data, PAYLOAD_LEN);
+  if(sent_len != PAYLOAD_LEN || !check(sent, PAYLOAD_LEN, 1)) {
+    FAIL(2);
+  }
+
+  /* Test 3: So is a payload passed from elsewhere. */
+  fill(sent, PAYLOAD_LEN, 0);
+  {
+    uint8_t payload[PAYLOAD_LEN];
+
+    fill(payload, PAYLOAD_LEN, 2);
+    sent_len = 0;
+    uip_udp_packet_send(conn, payload, PAYLOAD_LEN);
+  }
+  if(sent_len != PAYLOAD_LEN || !check(sent, PAYLOAD_LEN, 2)) {
+    FAIL(3);
+  }
+
+  error = 0;
+ end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_CONF_BUF_POOL
+/* Writes a datagram from fe80::2 into uip_buf, without a checksum. */
+static void
+build_packet(const uip_ipaddr_t *dest, int seqno)
+{
+  memset(uip_buf, 0, UIP_LLH_LEN + UIP_IPUDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[1] = UIP_UDPH_LEN + PAYLOAD_LEN;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 2);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dest);
+  UIP_UDP_BUF->srcport = UIP_HTONS(PORT);
+  UIP_UDP_BUF->destport = UIP_HTONS(PORT);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  fill(UDP_PAYLOAD, PAYLOAD_LEN, seqno);
+  uip_len = UIP_IPUDPH_LEN + PAYLOAD_LEN;
+  uip_ext_len = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Passes a datagram to the sink through uip_process(), so that only
+   the headers are processed. */
+static void
+input_packet(int seqno)
+{
+  uip_ipaddr_t addr;
+
+  uip_create_linklocal_allnodes_mcast(&addr);
+  build_packet(&addr, seqno);
+  delivered_len = 0;
+  taken = NULL;
+  uip_process(UIP_DATA);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of free buffers in the pool. */
+static int
+pool_free_count(void)
+{
+  uip_buf_t *held[UIP_CONF_BUF_POOL];
+  int i, n;
+
+  n = 0;
+  while(n < UIP_CONF_BUF_POOL && (held[n] = uip_bufpool_alloc()) != NULL) {
+    n++;
+  }
+  for(i = 0; i < n; i++) {
+    uip_bufpool_free(held[i]);
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static int
+udp_packet_test_take(void)
+{
+  int error;
+  uip_buf_t *held[UIP_CONF_BUF_POOL];
+  uip_buf_t *first;
+  int i, n;
+
+  n = 0;
+  first = NULL;
+
+  /* Test 1: The sink takes the buffer of the datagram, and uip_buf
+     goes on with another one. */
+  input_packet(3);
+  if(delivered_len != PAYLOAD_LEN || taken == NULL || taken == uip_bufp ||
+     taken_data != &taken->u8[UIP_LLH_LEN + UIP_IPUDPH_LEN]) {
+    FAIL(1);
+  }
+  first = taken;
+
+  /* Test 2: The payload is intact after uip_process() has returned,
+     and after uip_buf has been reused. */
+  memset(uip_buf, 0, UIP_BUFSIZE);
+  if(!check(taken_data, PAYLOAD_LEN, 3)) {
+    FAIL(2);
+  }
+
+  /* Test 3: If the pool is empty, no buffer is taken and the datagram
+     is still in uip_buf. */
+  while(n < UIP_CONF_BUF_POOL && (held[n] = uip_bufpool_alloc()) != NULL) {
+    n++;
+  }
+  input_packet(4);
+  if(delivered_len != PAYLOAD_LEN || taken != NULL ||
+     !check(UDP_PAYLOAD, PAYLOAD_LEN, 4)) {
+    FAIL(3);
+  }
+
+  /* Test 4: A buffer freed by the application can be taken again. */
+  uip_bufpool_free(first);
+  first = NULL;
+  input_packet(5);
+  if(taken == NULL || !check(taken_data, PAYLOAD_LEN, 5)) {
+    FAIL(4);
+  }
+  first = taken;
+
+  error = 0;
+ end:
+  if(first != NULL) {
+    uip_bufpool_free(first);
+  }
+  for(i = 0; i < n; i++) {
+    uip_bufpool_free(held[i]);
+  }
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+static int
+udp_packet_test_output(void)
+{
+  int error;
+  int free_count;
+  uip_ipaddr_t addr;
+  uip_buf_t *buf;
+  uip_buf_t *prev;
+  uip_buf_t *ret;
+  uip_ds6_nbr_t *nbr;
+  uint8_t *queued;
+
+  nbr = NULL;
+  free_count = pool_free_count();
+  uip_len = 0;
+
+  /* Build a multicast datagram in a buffer of its own, as a forwarding
+     engine keeps it, while uip_buf holds something else. */
+  buf = uip_bufpool_alloc();
+  if(buf == NULL) {
+    FAIL(1);
+  }
+  prev = uip_bufpool_exchange(buf);
+  uip_create_linklocal_allnodes_mcast(&addr);
+  build_packet(&addr, 6);
+  uip_bufpool_exchange(prev);
+  uip_len = 1;
+
+  /* Test 1: The datagram is sent from its buffer, which is given back
+     along with uip_buf and uip_len. */
+  sent_buf = NULL;
+  sent_len = 0;
+  ret = tcpip_ipv6_output_buf(buf, UIP_IPUDPH_LEN + PAYLOAD_LEN);
+  if(ret != buf || sent_buf != buf || sent_len != PAYLOAD_LEN ||
+     !check(sent, PAYLOAD_LEN, 6) || uip_bufp != prev || uip_len != 1) {
+    FAIL(1);
+  }
+
+  /* Test 2: The same buffer can be sent again. */
+  sent_buf = NULL;
+  sent_len = 0;
+  ret = tcpip_ipv6_output_buf(buf, UIP_IPUDPH_LEN + PAYLOAD_LEN);
+  if(ret != buf || sent_buf != buf || sent_len != PAYLOAD_LEN ||
+     !check(sent, PAYLOAD_LEN, 6)) {
+    FAIL(2);
+  }
+
+  /* Test 3: A unicast datagram to an unresolved neighbor is queued
+     with its buffer, and uip_buf is still the previous one. */
+  uip_ip6addr(&addr, 0xfe80, 0, 0, 0, 0, 0, 0, 5);
+  uip_ipaddr_copy(&((struct uip_ip_hdr *)&buf->u8[UIP_LLH_LEN])->destipaddr,
+                  &addr);
+  buf = tcpip_ipv6_output_buf(buf, UIP_IPUDPH_LEN + PAYLOAD_LEN);
+  nbr = uip_ds6_nbr_lookup(&addr);
+  if(buf != NULL || uip_bufp != prev || uip_len != 1 || nbr == NULL ||
+     uip_packetqueue_len(&nbr->packethandle) != 1) {
+    FAIL(3);
+  }
+  queued = uip_packetqueue_buf(&nbr->packethandle);
+  if(queued == NULL ||
+     !check(queued + UIP_IPUDPH_LEN, PAYLOAD_LEN, 6)) {
+    FAIL(3);
+  }
+
+  /* Test 4: No buffer is lost once the neighbor is gone. */
+  uip_ds6_nbr_rm(nbr);
+  nbr = NULL;
+  if(pool_free_count() != free_count) {
+    FAIL(4);
+  }
+
+  error = 0;
+ end:
+  if(buf != NULL) {
+    uip_bufpool_free(buf);
+  }
+  if(nbr != NULL) {
+    uip_ds6_nbr_rm(nbr);
+  }
+  uip_len = 0;
+  return error;
+}
+#endif /* UIP_CONF_BUF_POOL */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(udp_packet_test_process, ev, data)
+{
+  uip_ipaddr_t addr;
+
+  PROCESS_BEGIN();
+
+  core_test_start("UDP packet");
+
+  tcpip_set_outputfunc(output);
+  uip_create_linklocal_allnodes_mcast(&addr);
+  conn = udp_new(&addr, UIP_HTONS(PORT), NULL);
+
+  core_test_result("Send", udp_packet_test_send());
+#if UIP_CONF_BUF_POOL
+  printf("%d buffers\n", UIP_CONF_BUF_POOL);
+  process_start(&udp_packet_sink_process, NULL);
+  sink_conn = udp_new(NULL, 0, NULL);
+  udp_bind(sink_conn, UIP_HTONS(PORT));
+  sink_conn->appstate.p = &udp_packet_sink_process;
+  core_test_result("Take", udp_packet_test_take());
+  core_test_result("Output", udp_packet_test_output());
+#else /* UIP_CONF_BUF_POOL */
+  printf("No buffer pool, uip_udp_packet_take() not tested\n");
+#endif /* UIP_CONF_BUF_POOL */
+
+  core_test_finish("UDP packet");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,92 @@
+#!/bin/sh
+#
+# Runs mcast6.csc on tools/native-sim with SMRF, or Trickle, and
+# messages long enough for 6LoWPAN to fragment them, once with the
+# single static uip_buf and once with a pool of buffers
+# (UIP_CONF_BUF_POOL): four with SMRF, ten with Trickle, which keeps
+# up to six messages. With the pool, fragments are reassembled and
+# handed to the tcpip process in their own buffers, and the engine
+# holds the datagrams it forwards in pool buffers instead of copies,
+# and sends them from there with tcpip_ipv6_output_buf().
+#
+# With the pool, the sinks take the buffers of the messages with
+# uip_udp_packet_take() and check them after their handler has
+# returned, or read them from uip_buf when the pool is empty.
+#
+# The simulation is deterministic, so for every seed both SMRF builds
+# must deliver the same number of messages. Trickle schedules its
+# transmissions from the time the messages are processed, which the
+# queue of the pool delays, so its counts are only printed. Prints,
+# for every run, the messages the sinks received with each build, how
+# many of them the sinks took from the pool, and OK, or ERROR if the
+# SMRF counts differ, a message arrived short or with a bad payload,
+# or none was taken.
+#
+# Usage: ./pool-test.sh [runs] [payload] [smrf|trickle]
+
+CONTIKI=../../..
+SIM=$CONTIKI/tools/native-sim/native-sim
+RUNS=${1:-3}
+PAYLOAD=${2:-200}
+ENGINE=${3:-smrf}
+if [ $ENGINE = trickle ]; then
+  POOL=10
+else
+  POOL=4
+fi
+TIME=240
+
+make -s -C $CONTIKI/tools/native-sim || exit 1
+
+build() {
+  make TARGET=native-sim clean > /dev/null 2>&1
+  if ! make TARGET=native-sim ENGINE=$ENGINE PAYLOAD=$PAYLOAD $1 > pool-test.log 2>&1; then
+    cat pool-test.log >&2
+    exit 1
+  fi
+}
+
+# Prints the number of full-length messages received, the number of
+# short or bad ones, and the number of messages taken from the pool.
+run() {
+  $SIM -c mcast6.csc -s $1 -t $TIME 2> /dev/null |
+    awk -v len=$PAYLOAD '
+      /^In:/ {
+        if($NF == "bytes" && $(NF - 1) == len) {
+          full++
+        } else {
+          short++
+        }
+        if(/, taken,/) {
+          taken++
+        }
+      }
+      END { print full + 0, short + 0, taken + 0 }'
+}
+
+build
+seed=1
+while [ $seed -le $RUNS ]; do
+  eval static_$seed=\"$(run $seed)\"
+  seed=$((seed + 1))
+done
+
+build BUF_POOL=$POOL
+failed=0
+seed=1
+while [ $seed -le $RUNS ]; do
+  eval static=\$static_$seed
+  pooled=$(run $seed)
+  set -- $static $pooled
+  if { [ $ENGINE = trickle ] || [ $1 -eq $4 ]; } &&
+     [ $2 -eq 0 ] && [ $5 -eq 0 ] && [ $6 -gt 0 ]; then
+    result=OK
+  else
+    result=ERROR
+    failed=1
+  fi
+  echo "seed $seed: static $1, pooled $4 messages, $6 taken: $result"
+  seed=$((seed + 1))
+done
+rm -f pool-test.log
+exit $failed
@@ -49,17 +49,23 @@
 #include "net/uip-debug.h"
 #include "net/rpl/rpl.h"
 
-#define MAX_PAYLOAD_LEN 120
 #define MCAST_SINK_UDP_PORT 3001 /* Host byte order */
 #define SEND_INTERVAL CLOCK_SECOND /* clock ticks */
 #define ITERATIONS 100 /* messages */
 
+/* Message length, at least the sequence number. Longer messages are
+   padded and do not fit in one frame, so 6LoWPAN fragments them. */
+#ifdef MCAST_CONF_PAYLOAD_LEN
+#define PAYLOAD_LEN MCAST_CONF_PAYLOAD_LEN
+#else
+#define PAYLOAD_LEN sizeof(uint32_t)
+#endif
+
 /* Start sending messages START_DELAY secs after we start so that routing can
  * converge */
 #define START_DELAY 60
 
 static struct uip_udp_conn * mcast_conn;
-static char buf[MAX_PAYLOAD_LEN];
 static uint32_t seq_id;
 
 #if !UIP_CONF_IPV6 || !UIP_CONF_ROUTER || !UIP_IPV6_MULTICAST || !UIP_CONF_IPV6_RPL
@@ -75,19 +81,25 @@ static void
 multicast_send()
 {
   uint32_t id;
+  uint8_t *buf;
 
+  /* Write the message straight into the outgoing packet. */
+  buf = uip_udp_packet_reserve(PAYLOAD_LEN);
+  if(buf == NULL) {
+    return;
+  }
   id = uip_htonl(seq_id);
-  memset(buf, 0, MAX_PAYLOAD_LEN);
   memcpy(buf, &id, sizeof(seq_id));
+  memset(buf + sizeof(id), (uint8_t)seq_id, PAYLOAD_LEN - sizeof(id));
 
   PRINTF("Send to: ");
   PRINT6ADDR(&mcast_conn->ripaddr);
   PRINTF(" Remote Port %u,", uip_ntohs(mcast_conn->rport));
-  PRINTF(" (msg=0x%08lx)", (unsigned long)uip_ntohl(*((uint32_t *)buf)));
-  PRINTF(" %lu bytes\n", (unsigned long)sizeof(id));
+  PRINTF(" (msg=0x%08lx)", (unsigned long)uip_ntohl(id));
+  PRINTF(" %lu bytes\n", (unsigned long)PAYLOAD_LEN);
 
   seq_id++;
-  uip_udp_packet_send(mcast_conn, buf, sizeof(id));
+  uip_udp_packet_send(mcast_conn, buf, PAYLOAD_LEN);
 }
 /*---------------------------------------------------------------------------*/
 static void
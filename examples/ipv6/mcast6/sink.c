@@ -61,18 +61,61 @@ static uint16_t count;
 #error "Check the values of: UIP_CONF_IPV6, UIP_CONF_ROUTER,"
 #error "UIP_IPV6_CONF_MULTICAST, UIP_CONF_IPV6_RPL"
 #endif
+
+#if UIP_CONF_BUF_POOL
+/*
+ * With a buffer pool, the sink takes the buffer of a datagram instead of
+ * reading it from uip_buf, and reports it once the handler has returned
+ * and the stack has gone on with other packets. If no buffer is free,
+ * the datagram is read from uip_buf at once.
+ */
+static uip_buf_t *taken;
+static uint8_t *taken_data;
+static uint16_t taken_len;
+static uint8_t taken_ttl;
+static process_event_t taken_event;
+#endif /* UIP_CONF_BUF_POOL */
 /*---------------------------------------------------------------------------*/
 PROCESS(mcast_sink_process, "Multicast Sink");
 AUTOSTART_PROCESSES(&mcast_sink_process);
 /*---------------------------------------------------------------------------*/
+/*
+ * The root fills the datagram after the sequence number with its low
+ * byte. A datagram that does not match is reported as bad, after the
+ * length, so that pool-test.sh counts it as short.
+ */
+static void
+report(const uint8_t *data, uint16_t len, uint8_t ttl, const char *how)
+{
+  uint32_t seq_id;
+  uint16_t i;
+
+  memcpy(&seq_id, data, sizeof(seq_id));
+  seq_id = uip_ntohl(seq_id);
+  for(i = sizeof(seq_id); i < len && data[i] == (uint8_t)seq_id; i++);
+  PRINTF("In: [0x%08lx], TTL %u, total %u, %s, %u bytes%s\n",
+         (unsigned long)seq_id, ttl, count, how, len,
+         i < len ? ", bad payload" : "");
+}
+/*---------------------------------------------------------------------------*/
 static void
 tcpip_handler(void)
 {
   if(uip_newdata()) {
     count++;
-    PRINTF("In: [0x%08lx], TTL %u, total %u\n",
-        uip_ntohl((unsigned long) *((uint32_t *)(uip_appdata))),
-        UIP_IP_BUF->ttl, count);
+#if UIP_CONF_BUF_POOL
+    if(taken == NULL) {
+      taken_len = uip_datalen();
+      taken_ttl = UIP_IP_BUF->ttl;
+      /* uip_buf is another buffer after this. No reply may be sent. */
+      taken = uip_udp_packet_take(&taken_data);
+      if(taken != NULL) {
+        process_post(&mcast_sink_process, taken_event, NULL);
+        return;
+      }
+    }
+#endif /* UIP_CONF_BUF_POOL */
+    report(uip_appdata, uip_datalen(), UIP_IP_BUF->ttl, "copied");
   }
   return;
 }
@@ -115,6 +158,9 @@ PROCESS_THREAD(mcast_sink_process, ev, data)
   }
 
   count = 0;
+#if UIP_CONF_BUF_POOL
+  taken_event = process_alloc_event();
+#endif /* UIP_CONF_BUF_POOL */
 
   sink_conn = udp_new(NULL, UIP_HTONS(0), NULL);
   udp_bind(sink_conn, UIP_HTONS(MCAST_SINK_UDP_PORT));
@@ -129,6 +175,13 @@ PROCESS_THREAD(mcast_sink_process, ev, data)
     if(ev == tcpip_event) {
       tcpip_handler();
     }
+#if UIP_CONF_BUF_POOL
+    if(ev == taken_event && taken != NULL) {
+      report(taken_data, taken_len, taken_ttl, "taken");
+      uip_bufpool_free(taken);
+      taken = NULL;
+    }
+#endif /* UIP_CONF_BUF_POOL */
   }
 
   PROCESS_END();
@@ -86,15 +86,24 @@ collect_common_recv(const rimeaddr_t *originator, uint8_t seqno, uint8_t hops,
 {
   unsigned long time;
   uint16_t data;
+  uint16_t latency;
   int i;
 
   printf("%u", 8 + payload_len / 2);
   /* Timestamp. Ignore time synch for now. */
   time = get_time();
   printf(" %lu %lu 0", ((time >> 16) & 0xffff), time & 0xffff);
-  /* Ignore latency for now */
+  latency = 0;
+#if COLLECT_CONF_SHARED_CLOCK
+  /* All nodes read the same clock, as in native-sim, so the clock
+     value in the message gives its latency in clock ticks. */
+  if(payload_len >= 2 * sizeof(data)) {
+    memcpy(&data, payload + sizeof(data), sizeof(data));
+    latency = (uint16_t)clock_time() - data;
+  }
+#endif /* COLLECT_CONF_SHARED_CLOCK */
   printf(" %u %u %u %u",
-         originator->u8[0] + (originator->u8[1] << 8), seqno, hops, 0);
+         originator->u8[0] + (originator->u8[1] << 8), seqno, hops, latency);
   for(i = 0; i < payload_len / 2; i++) {
     memcpy(&data, payload, sizeof(data));
     payload += sizeof(data);
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Downward route test for DAO aggregation on native-sim
+ *
+ *         Node 1 is the DODAG root, and the other nodes send it a UDP
+ *         message every two seconds, so that they measure the ETX of
+ *         their parents. Every node prints its routing table every ten
+ *         seconds, one "route <time> <node> <target> <next hop>
+ *         <lifetime> <expiring>" line per route, with nodes identified
+ *         by the last two bytes of their addresses. A route is expiring
+ *         after a No-Path DAO. See dao-test.sh.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/rpl/rpl.h"
+#include "node-id.h"
+
+#include <stdio.h>
+
+PROCESS(dao_test_process, "DAO test process");
+AUTOSTART_PROCESSES(&dao_test_process);
+
+#define PRINT_INTERVAL (10 * CLOCK_SECOND)
+#define SEND_INTERVAL  (2 * CLOCK_SECOND)
+
+#define UDP_PORT 5688
+
+#define ID(addr) (((addr)->u8[14] << 8) | (addr)->u8[15])
+
+extern uip_ds6_route_t uip_ds6_routing_table[UIP_DS6_ROUTE_NB];
+
+static struct uip_udp_conn *conn;
+static uip_ipaddr_t root_ipaddr;
+/*---------------------------------------------------------------------------*/
+static void
+set_addresses(void)
+{
+  uip_ipaddr_t ipaddr;
+  rpl_dag_t *dag;
+
+  uip_ip6addr(&ipaddr, 0xaaaa, 0, 0, 0, 0, 0, 0, 0);
+  uip_ds6_set_addr_iid(&ipaddr, &uip_lladdr);
+  uip_ds6_addr_add(&ipaddr, 0, ADDR_AUTOCONF);
+
+  uip_ip6addr(&root_ipaddr, 0xaaaa, 0, 0, 0, 0, 0, 0, 1);
+
+  if(node_id == 1) {
+    uip_ds6_addr_add(&root_ipaddr, 0, ADDR_MANUAL);
+    dag = rpl_set_root(RPL_DEFAULT_INSTANCE, &root_ipaddr);
+    uip_ip6addr(&ipaddr, 0xaaaa, 0, 0, 0, 0, 0, 0, 0);
+    rpl_set_prefix(dag, &ipaddr, 64);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_routes(void)
+{
+  uip_ds6_route_t *r;
+
+  for(r = uip_ds6_routing_table;
+      r < uip_ds6_routing_table + UIP_DS6_ROUTE_NB; r++) {
+    if(r->isused) {
+      printf("route %lu %u %u %u %lu %u\n", clock_seconds(), node_id,
+             ID(&r->ipaddr), ID(&r->nexthop),
+             (unsigned long)r->state.lifetime,
+             r->state.saved_lifetime != 0);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(dao_test_process, ev, data)
+{
+  static struct etimer print_timer, send_timer;
+
+  PROCESS_BEGIN();
+
+  set_addresses();
+
+  conn = udp_new(NULL, UIP_HTONS(UDP_PORT), NULL);
+  udp_bind(conn, UIP_HTONS(UDP_PORT));
+
+  /* Print at the same times on all nodes. */
+  etimer_set(&print_timer, PRINT_INTERVAL - clock_time() % PRINT_INTERVAL);
+  etimer_set(&send_timer, SEND_INTERVAL);
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(etimer_expired(&print_timer)) {
+      etimer_set(&print_timer, PRINT_INTERVAL -
+                 clock_time() % PRINT_INTERVAL);
+      print_routes();
+    }
+    if(etimer_expired(&send_timer)) {
+      etimer_reset(&send_timer);
+      if(node_id != 1) {
+        uip_udp_packet_sendto(conn, &node_id, sizeof(node_id),
+                              &root_ipaddr, UIP_HTONS(UDP_PORT));
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
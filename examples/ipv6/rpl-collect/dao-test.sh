@@ -0,0 +1,92 @@
+#!/bin/sh
+#
+# Tests downward routes with RPL_CONF_DAO_AGGREGATE on native-sim, with
+# dao-test.csc and dao-test.trace. Node 4 moves from the subtree of
+# node 2 to that of node 5 at 300 s. The route lifetime unit is one
+# minute (see the Makefile), so that lifetimes can be followed.
+#
+# For every run, prints OK or the first failed test:
+#   1  node 2 still routes to node 4 two minutes after the move, so
+#      the No-Path DAO of node 4 did not make it up from node 3
+#   2  the root does not route to node 4 through node 5 at the end
+#   3  a node holds a route longer than the next hop towards the
+#      target does, plus one lifetime unit, so an aggregated DAO did
+#      not carry the remaining lifetime. Routes the next hop has set
+#      to expire after a No-Path DAO are not compared.
+#
+# Usage: ./dao-test.sh [runs]
+
+CONTIKI=../../..
+SIM=$CONTIKI/tools/native-sim/native-sim
+RUNS=${1:-5}
+MOVE=300
+TIME=600
+
+make -s -C $CONTIKI/tools/native-sim || exit 1
+
+make TARGET=native-sim clean > /dev/null 2>&1
+if ! make TARGET=native-sim DAO_TEST=1 > dao-test.log 2>&1; then
+  cat dao-test.log >&2
+  exit 1
+fi
+
+failed=0
+seed=1
+while [ $seed -le $RUNS ]; do
+  $SIM -c dao-test.csc -l dao-test.trace -s $seed -t $TIME \
+    > dao-test.log 2> /dev/null
+  awk -v seed=$seed -v move=$MOVE -v end=$TIME '
+    function fail(test) {
+      if(error == 0) {
+        error = test
+      }
+    }
+    # route <time> <node> <target> <next hop> <lifetime> <expiring>
+    $1 == "route" {
+      t = $2
+      if(t != now) {
+        check()
+        now = t
+        delete lifetime
+        delete nexthop
+        delete expiring
+      }
+      lifetime[$3, $4] = $6
+      nexthop[$3, $4] = $5
+      expiring[$3, $4] = $7
+      if(t >= move + 120 && $3 == 2 && $4 == 4) {
+        fail(1)
+      }
+      if($3 == 1 && $4 == 4) {
+        last = $5
+      }
+    }
+    function check(  key, k, n, target, hop) {
+      for(key in lifetime) {
+        split(key, k, SUBSEP)
+        n = k[1]
+        target = k[2]
+        hop = nexthop[n, target]
+        if(hop != target && (hop, target) in lifetime &&
+           !expiring[hop, target] &&
+           lifetime[n, target] > lifetime[hop, target] + 65) {
+          fail(3)
+        }
+      }
+    }
+    END {
+      check()
+      if(last != 5) {
+        fail(2)
+      }
+      if(error == 0) {
+        printf "seed %d: OK\n", seed
+      } else {
+        printf "seed %d: ERROR (test %d)\n", seed, error
+        exit 1
+      }
+    }' dao-test.log || failed=1
+  seed=$((seed + 1))
+done
+rm -f dao-test.log
+exit $failed
@@ -0,0 +1,86 @@
+#!/bin/sh
+#
+# Measures how long node 4 of failover.csc is cut off from the sink
+# when the link to its parent fails at 600 s (see failover.trace), with
+# ETX alone and with NEIGHBOR_INFO_CONF_NOACK_LIMIT, simulated with
+# tools/native-sim. Nodes send a message every second.
+#
+# For every run, prints the parent of node 4 before the failure, the
+# time from the failure to the next message from node 4 at the sink
+# and the number of messages from node 4 that never arrived. Runs in
+# which node 4 used node 3 all along do not see the failure.
+#
+# Usage: ./failover-benchmark.sh [runs]
+
+CONTIKI=../../..
+SIM=$CONTIKI/tools/native-sim/native-sim
+RUNS=${1:-10}
+FAILURE=600
+TIME=900
+
+make -s -C $CONTIKI/tools/native-sim || exit 1
+
+build() {
+  make TARGET=native-sim clean > /dev/null 2>&1
+  if ! make TARGET=native-sim DEFINES=$1 > failover-benchmark.log 2>&1; then
+    cat failover-benchmark.log >&2
+    exit 1
+  fi
+}
+
+printf "%-10s %4s %6s %9s %5s\n" detection seed parent outage/s lost
+for detection in etx noack; do
+  if [ $detection = etx ]; then
+    build PERIOD=1
+  else
+    build PERIOD=1,NEIGHBOR_INFO_CONF_NOACK_LIMIT=3,RPL_CONF_REROUTE_QUEUED=csma_reroute
+  fi
+  seed=1
+  while [ $seed -le $RUNS ]; do
+    $SIM -c failover.csc -l failover.trace -s $seed -t $TIME \
+      > failover-benchmark.log 2> /dev/null
+    awk -v detection=$detection -v seed=$seed -v failure=$FAILURE '
+      # Sequence numbers cycle through 128-255 after the first 255, see
+      # udp-sender.c; n counts on across the cycles.
+      $1 == NF && NF > 8 && $5 == 4 {
+        time = $2 * 65536 + $3
+        if(time < failure) {
+          parent = $16
+        } else if(recovered == 0) {
+          recovered = time
+        }
+        if(count == 0) {
+          n = first = last = $6
+        } else {
+          step = (($6 - seqno) % 128 + 128) % 128
+          if(step >= 64) {
+            step -= 128
+          }
+          n += step
+        }
+        seqno = $6
+        if(!(n in seen)) {
+          seen[n] = 1
+          received++
+        }
+        if(n < first) {
+          first = n
+        }
+        if(n > last) {
+          last = n
+        }
+        count++
+      }
+      END {
+        outage = -1
+        if(recovered > 0) {
+          outage = recovered - failure
+        }
+        lost = last - first + 1 - received
+        printf "%-10s %4d %6d %9d %5d\n", detection, seed, parent, outage,
+               lost
+      }' failover-benchmark.log
+    seed=$((seed + 1))
+  done
+done
+rm -f failover-benchmark.log
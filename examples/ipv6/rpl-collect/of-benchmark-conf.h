@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Configuration for comparing objective functions on native-sim
+ *
+ *         Built with "make TARGET=native-sim OF_BENCHMARK=etx" or
+ *         OF_BENCHMARK=composite, see of-benchmark.sh. The composite
+ *         objective function takes the residual energy of a node from a
+ *         battery that drains with the radio airtime of the node.
+ */
+
+#ifndef __OF_BENCHMARK_CONF_H__
+#define __OF_BENCHMARK_CONF_H__
+
+/* The sink prints the latency of the messages it receives. */
+#define COLLECT_CONF_SHARED_CLOCK 1
+
+#if OF_BENCHMARK_COMPOSITE
+#define RPL_CONF_OF rpl_of_composite
+#define RPL_CONF_DAG_MC_MAX_OBJECTS 3
+#define RPL_OF_COMPOSITE_CONF_NODE_ENERGY() of_benchmark_node_energy()
+#endif /* OF_BENCHMARK_COMPOSITE */
+
+/* Radio airtime that empties the battery of a node, in microseconds. */
+#ifndef OF_BENCHMARK_BATTERY
+#define OF_BENCHMARK_BATTERY 60000000UL
+#endif /* OF_BENCHMARK_BATTERY */
+
+/* Residual energy of the node, from 0 (empty) to 255 (full). */
+uint8_t of_benchmark_node_energy(void);
+
+#endif /* __OF_BENCHMARK_CONF_H__ */
@@ -0,0 +1,75 @@
+#!/bin/sh
+#
+# Compares the composite objective function with OF-ETX on the
+# rpl-collect scenarios, simulated with tools/native-sim.
+#
+# For every scenario and objective function, prints the number of
+# messages the sink received, their mean latency and the projected
+# network lifetime: the simulated time scaled by how long the node that
+# used the most radio airtime would take to empty its battery
+# (OF_BENCHMARK_BATTERY in of-benchmark-conf.h). The sink is mains
+# powered and does not count. The figures are the means over runs with
+# random seeds 1, 2, ...
+#
+# Usage: ./of-benchmark.sh [seconds] [runs]
+
+CONTIKI=../../..
+SIM=$CONTIKI/tools/native-sim/native-sim
+TIME=${1:-1800}
+RUNS=${2:-5}
+# Must match OF_BENCHMARK_BATTERY.
+BATTERY=60000000
+SCENARIOS="collect-tree-dense-noloss collect-tree-sparse-lossy"
+
+make -s -C $CONTIKI/tools/native-sim || exit 1
+
+build() {
+  make TARGET=native-sim clean > /dev/null 2>&1
+  if ! make TARGET=native-sim OF_BENCHMARK=$1 > of-benchmark.log 2>&1; then
+    cat of-benchmark.log >&2
+    exit 1
+  fi
+}
+
+printf "%-28s %-10s %9s %12s %12s\n" scenario of received latency/ms lifetime/s
+for of in etx composite; do
+  build $of
+  for scenario in $SCENARIOS; do
+    seed=1
+    while [ $seed -le $RUNS ]; do
+      $SIM -c $scenario.csc -t $TIME -s $seed -a > of-benchmark.log \
+        2> of-benchmark.stats
+      awk -v time=$TIME -v battery=$BATTERY '
+        FILENAME == "of-benchmark.log" && $1 == NF && NF > 8 {
+          received++
+          latency += $8
+        }
+        FILENAME == "of-benchmark.stats" && $1 == "node" && $2 != "1:" {
+          if($3 + $6 > used) {
+            used = $3 + $6
+          }
+        }
+        END {
+          lifetime = 0
+          if(used > 0) {
+            lifetime = time * battery / used
+          }
+          print received, latency, lifetime
+        }' of-benchmark.log of-benchmark.stats
+      seed=$((seed + 1))
+    done | awk -v scenario=$scenario -v of=$of -v runs=$RUNS '
+      {
+        received += $1
+        latency += $2
+        lifetime += $3
+      }
+      END {
+        if(received > 0) {
+          latency /= received
+        }
+        printf "%-28s %-10s %9.1f %12.1f %12.0f\n", scenario, of,
+               received / runs, latency, lifetime / runs
+      }'
+  done
+done
+rm -f of-benchmark.log of-benchmark.stats
@@ -41,12 +41,19 @@
 #include "contiki.h"
 #include "cfs/cfs.h"
 #include "cfs/cfs-coffee.h"
+#include "cfs-coffee-arch.h"
 #include "lib/crc16.h"
 #include "lib/random.h"
 
 #include <stdio.h>
 #include <string.h>
 
+#ifdef CONTIKI_TARGET_NATIVE
+#include <setjmp.h>
+#include "dev/xmem-native.h"
+#include "cfs/cfs-cache.h"
+#endif
+
 PROCESS(testcoffee_process, "Test CFS/Coffee process");
 AUTOSTART_PROCESSES(&testcoffee_process);
 
@@ -340,6 +347,228 @@ coffee_test_gc(void)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * The cycle and power failure tests keep a set of files whose contents
+ * follow from the file number and a generation count, so that they can
+ * be checked after any number of rewrites.
+ */
+#define CYCLE_FILES	8
+#define CYCLES		24
+
+static uint16_t generation[CYCLE_FILES];
+
+static char *
+cycle_name(int file)
+{
+  static char name[4];
+
+  name[0] = 'C';
+  name[1] = '0' + file;
+  name[2] = '\0';
+  return name;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+cycle_size(int file, unsigned gen)
+{
+  /* From a quarter of a sector up to two sectors, so that some files
+     span sector boundaries and some cover whole sectors. */
+  return (((file * 5 + gen * 3) & 7) + 1) * (COFFEE_SECTOR_SIZE / 4) - file;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned char
+cycle_byte(int file, unsigned gen, unsigned long offset)
+{
+  return (unsigned char)(file * 31 + gen * 17 + offset + (offset >> 8));
+}
+/*---------------------------------------------------------------------------*/
+static int
+cycle_write(int file, unsigned gen)
+{
+  unsigned char buf[128];
+  unsigned long size, offset;
+  int fd, i, n;
+
+  cfs_remove(cycle_name(file));
+  size = cycle_size(file, gen);
+  if(cfs_coffee_reserve(cycle_name(file), size) < 0) {
+    return -1;
+  }
+  fd = cfs_open(cycle_name(file), CFS_WRITE);
+  if(fd < 0) {
+    return -1;
+  }
+  for(offset = 0; offset < size; offset += n) {
+    n = size - offset < sizeof(buf) ? size - offset : sizeof(buf);
+    for(i = 0; i < n; i++) {
+      buf[i] = cycle_byte(file, gen, offset + i);
+    }
+    if(cfs_write(fd, buf, n) != n) {
+      cfs_close(fd);
+      return -1;
+    }
+  }
+  cfs_close(fd);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cycle_check(int file, unsigned gen)
+{
+  unsigned char buf[128];
+  unsigned long offset;
+  int fd, i, r;
+
+  fd = cfs_open(cycle_name(file), CFS_READ);
+  if(fd < 0) {
+    return gen == 0 ? 0 : -1;
+  } else if(gen == 0) {
+    cfs_close(fd);
+    return -1;
+  }
+  offset = 0;
+  while((r = cfs_read(fd, buf, sizeof(buf))) > 0) {
+    for(i = 0; i < r; i++) {
+      if(buf[i] != cycle_byte(file, gen, offset + i)) {
+        cfs_close(fd);
+        return -1;
+      }
+    }
+    offset += r;
+  }
+  cfs_close(fd);
+  return offset == cycle_size(file, gen) ? 0 : -1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+coffee_reboot(void)
+{
+  void *mem;
+  unsigned size;
+
+  /* Coffee keeps all of its state in the protected memory, which is
+     cleared when a node restarts. Blocks that were still dirty in the
+     cache are lost as well. */
+  mem = cfs_coffee_get_protected_mem(&size);
+  memset(mem, 0, size);
+#ifdef CONTIKI_TARGET_NATIVE
+  cfs_cache_invalidate(NULL, -1, 0, 0);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static int
+coffee_test_cycle(int cycle)
+{
+  int error;
+  int i;
+
+  /* Test 1: Rewrite one third of the files, remove one third, and
+     keep the rest. The files fill the file system several times
+     over the cycles, so the garbage collector has to run. */
+  for(i = 0; i < CYCLE_FILES; i++) {
+    switch((i + cycle) % 3) {
+    case 0:
+      cfs_remove(cycle_name(i));
+      generation[i] = 0;
+      break;
+    case 1:
+      if(cycle_write(i, cycle + 1) < 0) {
+        FAIL(1);
+      }
+      generation[i] = cycle + 1;
+      break;
+    }
+  }
+
+  /* Test 2: All files have the contents they were last given. */
+  for(i = 0; i < CYCLE_FILES; i++) {
+    if(cycle_check(i, generation[i]) < 0) {
+      printf("file %d generation %u\n", i, generation[i]);
+      FAIL(2);
+    }
+  }
+
+  /* Test 3: They still do after the file system has been reopened. */
+  if(cycle % 4 == 3) {
+    coffee_reboot();
+    for(i = 0; i < CYCLE_FILES; i++) {
+      if(cycle_check(i, generation[i]) < 0) {
+        printf("file %d generation %u\n", i, generation[i]);
+        FAIL(3);
+      }
+    }
+  }
+
+  error = 0;
+end:
+  return error;
+}
+/*---------------------------------------------------------------------------*/
+#ifdef CONTIKI_TARGET_NATIVE
+#define POWER_CUTS	200
+
+static jmp_buf power_cut;
+
+static void
+power_cut_callback(void)
+{
+  longjmp(power_cut, 1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+coffee_test_power_cut(void)
+{
+  int error;
+  static int cut, file, i;
+  static unsigned gen;
+
+  /* Test 1: Start with all files in place. */
+  for(i = 0; i < CYCLE_FILES; i++) {
+    if(generation[i] == 0) {
+      if(cycle_write(i, CYCLES + 1) < 0) {
+        FAIL(1);
+      }
+      generation[i] = CYCLES + 1;
+    }
+  }
+
+  for(cut = 0; cut < POWER_CUTS; cut++) {
+    /* Rewrite one file, with the power failing after a varying amount
+       of flash has been written or erased. The file system is nearly
+       full, so this often needs the garbage collector. */
+    file = cut % CYCLE_FILES;
+    gen = generation[file] + 1;
+    xmem_power_cut((cut * 7919UL) % (3 * COFFEE_SECTOR_SIZE) + 1,
+                   power_cut_callback);
+    if(setjmp(power_cut) == 0) {
+      if(cycle_write(file, gen) < 0) {
+        xmem_power_cut(0, NULL);
+        FAIL(2);
+      }
+      xmem_power_cut(0, NULL);
+      generation[file] = gen;
+    } else {
+      /* The file being written is in an unknown state. */
+      coffee_reboot();
+      cfs_remove(cycle_name(file));
+      generation[file] = 0;
+    }
+
+    /* Test 3: No other file is lost or damaged. */
+    for(i = 0; i < CYCLE_FILES; i++) {
+      if(cycle_check(i, generation[i]) < 0) {
+        printf("file %d generation %u after cut %d\n", i, generation[i], cut);
+        FAIL(3);
+      }
+    }
+  }
+
+  error = 0;
+end:
+  return error;
+}
+#endif /* CONTIKI_TARGET_NATIVE */
+/*---------------------------------------------------------------------------*/
 static void
 print_result(const char *test_name, int result)
 {
@@ -353,8 +582,9 @@ print_result(const char *test_name, int result)
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(testcoffee_process, ev, data)
 {
-  int start;
-  int result;
+  static int start;
+  static int result;
+  static int cycle;
 
   PROCESS_BEGIN();
 
@@ -377,6 +607,23 @@ PROCESS_THREAD(testcoffee_process, ev, data)
   result = coffee_test_gc();
   print_result("Garbage collection", result);
 
+  /* Other processes, such as the background garbage collector of
+     Coffee, run between the cycles. */
+  cfs_coffee_format();
+  for(cycle = 0; cycle < CYCLES; cycle++) {
+    result = coffee_test_cycle(cycle);
+    if(result != 0) {
+      break;
+    }
+    PROCESS_PAUSE();
+  }
+  print_result("Fill, remove and reopen cycles", result);
+
+#ifdef CONTIKI_TARGET_NATIVE
+  result = coffee_test_power_cut();
+  print_result("Power failures", result);
+#endif
+
   printf("Coffee test finished. Duration: %d seconds\n", 
          (int)(clock_seconds() - start));
 
@@ -150,6 +150,7 @@ typedef unsigned short uip_stats_t;
 #define UIP_CONF_TCP                  1
 
 #if UIP_CONF_IPV6
+#define RIMEADDR_CONF_SIZE            8
 #define UIP_CONF_IPV6_QUEUE_PKT       1
 #define UIP_CONF_IPV6_CHECKS          1
 #define UIP_CONF_IPV6_REASSEMBLY      1
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Node entry points for the native-sim platform
+ *
+ *         There is no main() here. The runner in tools/native-sim
+ *         boots the node with sim_node_init() and then calls
+ *         sim_node_run() whenever the virtual clock reaches the time
+ *         the previous call asked for.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/rime.h"
+
+#include "dev/serial-line.h"
+
+#include "net/uip.h"
+
+#include "dev/button-sensor.h"
+#include "dev/pir-sensor.h"
+#include "dev/vib-sensor.h"
+
+#include "lib/random.h"
+#include "node-id.h"
+#include "sim-node.h"
+
+/* Upper bound on the events one node may handle in a single clock
+   tick. A node that still has work after that is run again on the
+   next tick rather than holding up the whole simulation. */
+#ifdef NATIVE_SIM_CONF_MAX_EVENTS
+#define NATIVE_SIM_MAX_EVENTS NATIVE_SIM_CONF_MAX_EVENTS
+#else
+#define NATIVE_SIM_MAX_EVENTS 1000
+#endif
+
+PROCINIT(&etimer_process, &tcpip_process);
+
+SENSORS(&pir_sensor, &vib_sensor, &button_sensor);
+
+unsigned short node_id;
+
+extern clock_time_t sim_clock_time;
+
+/*---------------------------------------------------------------------------*/
+static void
+set_node_addr(void)
+{
+  rimeaddr_t addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[sizeof(addr.u8) - 2] = node_id >> 8;
+  addr.u8[sizeof(addr.u8) - 1] = node_id & 0xff;
+  rimeaddr_set_node_addr(&addr);
+
+#if UIP_CONF_IPV6
+  memcpy(&uip_lladdr.addr, &addr, sizeof(uip_lladdr.addr));
+#endif /* UIP_CONF_IPV6 */
+}
+/*---------------------------------------------------------------------------*/
+void
+sim_node_init(unsigned short id, unsigned short seed, unsigned long now)
+{
+  node_id = id;
+  sim_clock_time = now;
+  random_init(seed);
+
+  printf("Starting Contiki node %u\n", node_id);
+  process_init();
+  ctimer_init();
+  rtimer_init();
+
+  set_node_addr();
+  netstack_init();
+
+  procinit_init();
+
+  serial_line_init();
+
+  autostart_start(autostart_processes);
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+sim_node_run(unsigned long now)
+{
+  clock_time_t next, t;
+  int n;
+
+  sim_clock_time = now;
+
+  rtimer_arch_check();
+
+  if(etimer_pending()) {
+    etimer_request_poll();
+  }
+
+  n = 0;
+  while(process_run() > 0 && ++n < NATIVE_SIM_MAX_EVENTS);
+
+  if(process_nevents() > 0) {
+    return now + 1;
+  }
+
+  next = SIM_NODE_NEVER;
+  if(etimer_pending()) {
+    next = etimer_next_expiration_time();
+  }
+  if(rtimer_arch_pending()) {
+    t = now + (rtimer_clock_t)(rtimer_arch_next() - (rtimer_clock_t)now);
+    if(t < next) {
+      next = t;
+    }
+  }
+
+  /* Anything due right now was scheduled after it could run. */
+  return next > now ? next : now + 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_message(char *m1, char *m2)
+{
+  printf("%lu %u: %s%s\n", (unsigned long)sim_clock_time, node_id, m1, m2);
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_log(char *m)
+{
+  printf("%lu %u: %s\n", (unsigned long)sim_clock_time, node_id, m);
+}
+/*---------------------------------------------------------------------------*/
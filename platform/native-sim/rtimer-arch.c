@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Virtual rtimer for native-sim nodes
+ *
+ *         Instead of arming a host timer, the next rtimer is recorded
+ *         and sim_node_run() fires it when the virtual clock gets
+ *         there.
+ */
+
+#include "sys/rtimer.h"
+#include "sys/clock.h"
+
+static int pending_rtimer;
+static rtimer_clock_t next_rtimer;
+
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_init(void)
+{
+  pending_rtimer = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  next_rtimer = t;
+  pending_rtimer = 1;
+}
+/*---------------------------------------------------------------------------*/
+rtimer_clock_t
+rtimer_arch_next(void)
+{
+  return next_rtimer;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_arch_pending(void)
+{
+  return pending_rtimer;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_arch_check(void)
+{
+  if(pending_rtimer &&
+     (rtimer_clock_t)(rtimer_arch_now() - next_rtimer) <
+     (rtimer_clock_t)~0 / 2) {
+    pending_rtimer = 0;
+    rtimer_run_next();
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
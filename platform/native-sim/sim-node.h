@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Entry points of a native-sim node
+ *
+ *         A native-sim build is a shared object holding one complete
+ *         Contiki node. The runner in tools/native-sim loads a separate
+ *         copy of the object for every node, so each node has its own
+ *         globals, and calls these functions through dlsym(). Calls for
+ *         one node must not overlap; different nodes may run
+ *         concurrently. This header is shared with the runner and must
+ *         not depend on Contiki headers.
+ */
+
+#ifndef __SIM_NODE_H__
+#define __SIM_NODE_H__
+
+/* Ticks per second of the virtual clock (CLOCK_CONF_SECOND). */
+#define SIM_NODE_SECOND 1000
+
+/* Returned by sim_node_run() when the node has nothing scheduled. */
+#define SIM_NODE_NEVER ((unsigned long)-1)
+
+/* Boot the node at virtual time now. */
+void sim_node_init(unsigned short id, unsigned short seed,
+                   unsigned long now);
+
+/* Set the virtual clock to now (in clock ticks), run everything that
+   is due and return the absolute time the node next needs to run. */
+unsigned long sim_node_run(unsigned long now);
+
+#endif /* __SIM_NODE_H__ */
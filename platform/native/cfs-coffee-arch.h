@@ -41,12 +41,33 @@
 #define CFS_COFFEE_ARCH_H
 
 #include "contiki-conf.h"
-#include "dev/xmem.h"
+#include "dev/xmem-native.h"
 
-#define COFFEE_SECTOR_SIZE		65536UL
+/* The geometry follows the emulated flash in dev/xmem.c, which can be
+   resized with XMEM_CONF_SIZE and XMEM_ERASE_UNIT_SIZE. */
+#ifdef COFFEE_CONF_SECTOR_SIZE
+#define COFFEE_SECTOR_SIZE		COFFEE_CONF_SECTOR_SIZE
+#else
+#define COFFEE_SECTOR_SIZE		XMEM_ERASE_UNIT_SIZE
+#endif
+
+#ifdef COFFEE_CONF_PAGE_SIZE
+#define COFFEE_PAGE_SIZE		COFFEE_CONF_PAGE_SIZE
+#else
 #define COFFEE_PAGE_SIZE		256UL
+#endif
+
 #define COFFEE_START			0
-#define COFFEE_SIZE			((1024UL * 1024UL) - COFFEE_START)
+
+#ifdef COFFEE_CONF_SIZE
+#define COFFEE_SIZE			COFFEE_CONF_SIZE
+#else
+#define COFFEE_SIZE			(XMEM_SIZE - COFFEE_START)
+#endif
+
+#if COFFEE_START + COFFEE_SIZE > XMEM_SIZE
+#error "The Coffee file system does not fit in the emulated flash."
+#endif
 #define COFFEE_NAME_LENGTH		16
 #define COFFEE_DYN_SIZE			16384
 #define COFFEE_MAX_OPEN_FILES		6
@@ -54,8 +75,44 @@
 #define COFFEE_LOG_DIVISOR		4
 #define COFFEE_LOG_SIZE			8192
 #define COFFEE_LOG_TABLE_LIMIT		256
-#define COFFEE_MICRO_LOGS		0
+#ifdef COFFEE_CONF_MICRO_LOGS
+#define COFFEE_MICRO_LOGS		COFFEE_CONF_MICRO_LOGS
+#else
+#define COFFEE_MICRO_LOGS		1
+#endif
 #define COFFEE_IO_SEMANTICS		1
+#define COFFEE_NAME_INDEX		1
+#define COFFEE_NAME_INDEX_SIZE		64
+
+/* Both can be turned off to test Coffee as it runs on the small
+   platforms, e.g. with DEFINES=COFFEE_CONF_SECTOR_MAP=0. */
+#ifdef COFFEE_CONF_SECTOR_MAP
+#define COFFEE_SECTOR_MAP		COFFEE_CONF_SECTOR_MAP
+#else
+#define COFFEE_SECTOR_MAP		1
+#endif
+
+#ifdef COFFEE_CONF_BACKGROUND_GC
+#define COFFEE_BACKGROUND_GC		COFFEE_CONF_BACKGROUND_GC
+#else
+#define COFFEE_BACKGROUND_GC		COFFEE_SECTOR_MAP
+#endif
+
+/* Finish erases cut short by a power failure at the first allocation;
+   reading the emulated flash through costs little. */
+#ifdef COFFEE_CONF_ERASE_CHECK
+#define COFFEE_ERASE_CHECK		COFFEE_CONF_ERASE_CHECK
+#else
+#define COFFEE_ERASE_CHECK		1
+#endif
+
+#ifdef COFFEE_CONF_LOG_INDEX
+#define COFFEE_LOG_INDEX		COFFEE_CONF_LOG_INDEX
+#else
+#define COFFEE_LOG_INDEX		COFFEE_MICRO_LOGS
+#endif
+/* Index logs of up to COFFEE_LOG_SIZE bytes in records of 64 bytes. */
+#define COFFEE_LOG_INDEX_RECORDS	(COFFEE_LOG_SIZE / 64)
 
 #define COFFEE_WRITE(buf, size, offset)				\
 		xmem_pwrite((char *)(buf), (size), COFFEE_START + (offset))
@@ -72,7 +129,12 @@
 #define WRITE_HEADER(hdr, page)						\
   COFFEE_WRITE((hdr), sizeof (*hdr), (page) * COFFEE_PAGE_SIZE)
 
-/* Coffee types. */
+/* Coffee types. Large file systems need wider page numbers, which
+   is the page_type_size of tools/coffee-manager. */
+#if COFFEE_SIZE / COFFEE_PAGE_SIZE > 32767
+typedef int32_t coffee_page_t;
+#else
 typedef int16_t coffee_page_t;
+#endif
 
 #endif /* !COFFEE_ARCH_H */
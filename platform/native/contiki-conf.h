@@ -60,8 +60,21 @@ typedef unsigned short uip_stats_t;
 #define UIP_CONF_TCP_SPLIT       1
 #define UIP_CONF_LOGGING         0
 #define UIP_CONF_UDP_CHECKSUMS   1
+#ifndef UIP_CONF_CHKSUM_WORD32
+#define UIP_CONF_CHKSUM_WORD32   1
+#endif /* UIP_CONF_CHKSUM_WORD32 */
+
+#define MEMB_CONF_FREELIST       1
+/* Nothing polls from interrupts here, so the poll queue needs no lock. */
+#ifndef PROCESS_CONF_POLL_QUEUE
+#define PROCESS_CONF_POLL_QUEUE  1
+#endif /* PROCESS_CONF_POLL_QUEUE */
+#ifndef CRC16_CONF_METHOD
+#define CRC16_CONF_METHOD        CRC16_SLICE4
+#endif /* CRC16_CONF_METHOD */
 
 #if UIP_CONF_IPV6
+#define RIMEADDR_CONF_SIZE       8
 #define UIP_CONF_IPV6_CHECKS     1
 #define UIP_CONF_IPV6_QUEUE_PKT  1
 #define UIP_CONF_IPV6_REASSEMBLY 0
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *	Flash emulation of the native platform.
+ *
+ *	The external flash is kept in RAM unless the environment variable
+ *	XMEM_IMAGE names an image file, which is then mapped into memory
+ *	and keeps its contents between runs. The image has the same
+ *	layout as the images handled by tools/coffee-manager. The nodes
+ *	of native-sim would all share the image, so it is meant for
+ *	native builds only.
+ *
+ *	As on the flash of the other platforms, which store the data bit
+ *	inverted, an erased byte reads as zero and a write can only set
+ *	bits until the erase unit is erased again, so that data that is
+ *	overwritten without an erase is corrupted as it would be on the
+ *	real flash. Set XMEM_CONF_FLASH_WRITES to 0 to overwrite bytes
+ *	as in RAM instead.
+ *
+ *	Erases and writes are counted per erase unit. With an image file,
+ *	the counts are kept in a file with the suffix ".wear" next to it.
+ *
+ *	A power failure can be emulated by setting XMEM_POWER_CUT to a
+ *	number of bytes, or by calling xmem_power_cut(). When that many
+ *	bytes have been written or erased, the operation in progress is
+ *	cut short and the program exits with XMEM_POWER_CUT_STATUS.
+ */
+
+#ifndef XMEM_NATIVE_H
+#define XMEM_NATIVE_H
+
+#include "contiki-conf.h"
+#include "dev/xmem.h"
+
+#ifdef XMEM_CONF_SIZE
+#define XMEM_SIZE XMEM_CONF_SIZE
+#else
+#define XMEM_SIZE (1024UL * 1024UL)
+#endif
+
+#ifndef XMEM_ERASE_UNIT_SIZE
+#define XMEM_ERASE_UNIT_SIZE (64 * 1024UL)
+#endif
+
+#define XMEM_SECTORS (XMEM_SIZE / XMEM_ERASE_UNIT_SIZE)
+
+#ifdef XMEM_CONF_FLASH_WRITES
+#define XMEM_FLASH_WRITES XMEM_CONF_FLASH_WRITES
+#else
+#define XMEM_FLASH_WRITES 1
+#endif
+
+#define XMEM_POWER_CUT_STATUS 75
+
+struct xmem_sector_stats {
+  uint32_t erases;
+  uint32_t writes;
+};
+
+/**
+ * \brief Get the erase and write counts of an erase unit.
+ * \return The counts, or NULL if the sector does not exist.
+ */
+const struct xmem_sector_stats *xmem_sector_stats(unsigned sector);
+
+/**
+ * \brief Cut the power after a number of written or erased bytes.
+ * \param bytes The bytes to allow, or 0 to never cut the power.
+ * \param callback Called after the partial write or erase, or NULL.
+ *
+ * The program exits when the callback returns, so a callback that
+ * wants the program to continue must leave with longjmp().
+ */
+void xmem_power_cut(unsigned long bytes, void (*callback)(void));
+
+#endif /* !XMEM_NATIVE_H */
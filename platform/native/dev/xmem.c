@@ -35,39 +35,128 @@
 
 #include "contiki-conf.h"
 #include "dev/xmem.h"
+#include "dev/xmem-native.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+
+static unsigned char *xmem;
+static struct xmem_sector_stats *sector_stats;
+
+static char power_cut_armed;
+static unsigned long power_left;
+static void (*power_cut_callback)(void);
+/*---------------------------------------------------------------------------*/
+static void *
+map_file(const char *name, size_t size)
+{
+  void *mem;
+  int fd;
+
+  fd = open(name, O_RDWR | O_CREAT, 0644);
+  if(fd < 0) {
+    perror(name);
+    return NULL;
+  }
 
-#define XMEM_SIZE 1024 * 1024
+  /* An extended file reads as zeros, which is erased flash. */
+  if(lseek(fd, 0, SEEK_END) < (off_t)size && ftruncate(fd, size) < 0) {
+    perror(name);
+    close(fd);
+    return NULL;
+  }
 
-static unsigned char xmem[XMEM_SIZE];
+  mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if(mem == MAP_FAILED) {
+    perror(name);
+    return NULL;
+  }
+  return mem;
+}
+/*---------------------------------------------------------------------------*/
+static int
+check_range(long nbytes, unsigned long offset)
+{
+  if(xmem == NULL) {
+    xmem_init();
+  }
+  if(nbytes < 0 || offset > XMEM_SIZE ||
+     (unsigned long)nbytes > XMEM_SIZE - offset) {
+    fprintf(stderr, "xmem: access of %ld bytes at 0x%lx is out of range\n",
+            nbytes, offset);
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the bytes that can be written or erased before the power fails. */
+static long
+power_check(long nbytes)
+{
+  if(!power_cut_armed) {
+    return nbytes;
+  }
+  if(power_left < (unsigned long)nbytes) {
+    nbytes = power_left;
+  }
+  power_left -= nbytes;
+  return nbytes;
+}
+/*---------------------------------------------------------------------------*/
+static void
+power_fail(const char *operation, unsigned long offset)
+{
+  fprintf(stderr, "xmem: power cut during %s at 0x%lx\n", operation, offset);
+  if(power_cut_callback != NULL) {
+    power_cut_armed = 0;
+    power_cut_callback();
+  }
+  _exit(XMEM_POWER_CUT_STATUS);
+}
 /*---------------------------------------------------------------------------*/
 int
 xmem_pwrite(const void *buf, int size, unsigned long offset)
 {
-  /*  int f;
-  char name[400];
-
-  snprintf(name, sizeof(name), "xmem.%d.%d", node_x(), node_y());
-  f = open(name, O_WRONLY | O_APPEND | O_CREAT, 0644);
-  lseek(f, addr, SEEK_SET);
-  write(f, buf, size);
-  close(f);*/
-  
-  /*  printf("xmem_write(offset 0x%02x, buf %p, size %l);\n", offset, buf, size);*/
-  
-  memcpy(&xmem[offset], buf, size);
+  unsigned long sector;
+  long n;
+#if XMEM_FLASH_WRITES
+  long i;
+#endif
+
+  if(!check_range(size, offset)) {
+    return -1;
+  }
+
+  for(sector = offset / XMEM_ERASE_UNIT_SIZE;
+      sector * XMEM_ERASE_UNIT_SIZE < offset + size; sector++) {
+    sector_stats[sector].writes++;
+  }
+
+  n = power_check(size);
+#if XMEM_FLASH_WRITES
+  for(i = 0; i < n; i++) {
+    xmem[offset + i] |= ((const unsigned char *)buf)[i];
+  }
+#else
+  memcpy(&xmem[offset], buf, n);
+#endif
+  if(n < size) {
+    power_fail("write", offset + n);
+  }
   return size;
 }
 /*---------------------------------------------------------------------------*/
 int
 xmem_pread(void *buf, int size, unsigned long offset)
 {
-  /*  printf("xmem_read(addr 0x%02x, buf %p, size %d);\n", addr, buf, size);*/
+  if(!check_range(size, offset)) {
+    return -1;
+  }
   memcpy(buf, &xmem[offset], size);
   return size;
 }
@@ -75,14 +164,71 @@ xmem_pread(void *buf, int size, unsigned long offset)
 int
 xmem_erase(long nbytes, unsigned long offset)
 {
-  /*  printf("xmem_read(addr 0x%02x, buf %p, size %d);\n", addr, buf, size);*/
-  memset(&xmem[offset], 0, nbytes);
+  unsigned long sector;
+  long n;
+
+  if(!check_range(nbytes, offset)) {
+    return -1;
+  }
+
+  for(sector = offset / XMEM_ERASE_UNIT_SIZE;
+      sector * XMEM_ERASE_UNIT_SIZE < offset + nbytes; sector++) {
+    sector_stats[sector].erases++;
+  }
+
+  n = power_check(nbytes);
+  memset(&xmem[offset], 0, n);
+  if(n < nbytes) {
+    power_fail("erase", offset + n);
+  }
   return nbytes;
 }
 /*---------------------------------------------------------------------------*/
+const struct xmem_sector_stats *
+xmem_sector_stats(unsigned sector)
+{
+  if(xmem == NULL) {
+    xmem_init();
+  }
+  return sector < XMEM_SECTORS ? &sector_stats[sector] : NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+xmem_power_cut(unsigned long bytes, void (*callback)(void))
+{
+  power_cut_armed = bytes > 0;
+  power_left = bytes;
+  power_cut_callback = callback;
+}
+/*---------------------------------------------------------------------------*/
 void
 xmem_init(void)
 {
+  static unsigned char ram[XMEM_SIZE];
+  static struct xmem_sector_stats ram_stats[XMEM_SECTORS];
+  char name[FILENAME_MAX];
+  const char *env;
+
+  if(xmem != NULL) {
+    return;
+  }
+
+  env = getenv("XMEM_IMAGE");
+  if(env != NULL) {
+    xmem = map_file(env, XMEM_SIZE);
+    snprintf(name, sizeof(name), "%s.wear", env);
+    sector_stats = map_file(name, sizeof(ram_stats));
+  }
+  if(xmem == NULL) {
+    xmem = ram;
+  }
+  if(sector_stats == NULL) {
+    sector_stats = ram_stats;
+  }
 
+  env = getenv("XMEM_POWER_CUT");
+  if(env != NULL) {
+    xmem_power_cut(strtoul(env, NULL, 0), NULL);
+  }
 }
 /*---------------------------------------------------------------------------*/
@@ -56,7 +56,8 @@ public class CoffeeFile {
 		reservedSize = header.maxPages * coffeeFS.getConfiguration().pageSize;
 		if (header.isModified() && 
 		   coffeeFS.getConfiguration().useMicroLogs == true) {
-			microLog = new CoffeeMicroLog(coffeeFS, coffeeFS.readHeader(header.logPage));
+			microLog = new CoffeeMicroLog(coffeeFS,
+				coffeeFS.readHeader(header.logPage), header);
 		} else {
 			microLog = null;
 		}
@@ -66,7 +67,7 @@ public class CoffeeFile {
 		byte[] bytes = new byte[1];
 		int i;
 
-		for (i = reservedSize; i >= header.rawLength(); i--) {
+		for (i = reservedSize - 1; i >= header.rawLength(); i--) {
 			coffeeFS.getImage().read(bytes, 1, header.getPage() * coffeeFS.getConfiguration().pageSize + i);
 			if (bytes[0] != 0) {
 				return i - header.rawLength() + 1;
@@ -99,18 +100,22 @@ public class CoffeeFile {
 				  coffeeFS.getConfiguration().pageSize +
 				  header.rawLength();
 		int i;
+		int recordSize;
 		byte[] bytes;
 
 		FileOutputStream fOut = new FileOutputStream(file);
 
 		if (microLog != null) {
-			for (i = 0; i < microLog.getLogRecords(); i++) {
-				bytes = microLog.getRegion(i);
+			/* Regions that have been modified are read from the
+			   log, and the others from the file itself. */
+			recordSize = microLog.getLogRecordSize();
+			for (i = 0; i < getLength(); i += recordSize) {
+				bytes = microLog.getRegion(i / recordSize);
 				if (bytes == null) {
-					bytes = new byte[microLog.getLogRecordSize()];
-					coffeeFS.getImage().read(bytes, bytes.length, i * microLog.getLogRecordSize());
+					bytes = new byte[recordSize];
+					coffeeFS.getImage().read(bytes, bytes.length, startOffset + i);
 				}
-				fOut.write(bytes);
+				fOut.write(bytes, 0, Math.min(recordSize, getLength() - i));
 			}
 		} else {
 			bytes = new byte[1];
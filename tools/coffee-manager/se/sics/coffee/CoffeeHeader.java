@@ -80,10 +80,10 @@ class CoffeeHeader {
 		logPage = getPageValue(bytes, 0);
 		index += conf.pageTypeSize;
 
-		logRecords = bytes[index] + (bytes[index + 1] << 8);
+		logRecords = (bytes[index] & 0xff) + ((bytes[index + 1] & 0xff) << 8);
 		index += 2;
 
-		logRecordSize = bytes[index] + (bytes[index + 1] << 8);
+		logRecordSize = (bytes[index] & 0xff) + ((bytes[index + 1] & 0xff) << 8);
 		index += 2;
 
 		maxPages = getPageValue(bytes, index);
@@ -162,7 +162,7 @@ class CoffeeHeader {
 		int page = 0;
 
 		for (int i = 0; i < conf.pageTypeSize; i++) {
-			page |= bytes[offset + i] << (8 * i);
+			page |= (bytes[offset + i] & 0xff) << (8 * i);
 		}
 		return page;
 	}
@@ -176,11 +176,11 @@ class CoffeeHeader {
 			conf.pageTypeSize);
 		index += conf.pageTypeSize;
 
-		bytes[index++] = (byte) (logRecords >> 8);
 		bytes[index++] = (byte) logRecords;
+		bytes[index++] = (byte) (logRecords >> 8);
 
-		bytes[index++] = (byte) (logRecordSize >> 8);
 		bytes[index++] = (byte) logRecordSize;
+		bytes[index++] = (byte) (logRecordSize >> 8);
 
 		System.arraycopy(setPageValue(maxPages), 0, bytes, index,
 			conf.pageTypeSize);
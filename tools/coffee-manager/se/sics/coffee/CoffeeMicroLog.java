@@ -46,19 +46,21 @@ public class CoffeeMicroLog extends CoffeeFile {
 	private int recordStart;
 	private int[] index;
 
-	public CoffeeMicroLog(CoffeeFS fs, CoffeeHeader header)
-			throws IOException {
+	public CoffeeMicroLog(CoffeeFS fs, CoffeeHeader header,
+			CoffeeHeader fileHeader) throws IOException {
 		super(fs, header);
 
+		/* The log is configured in the header of its file. */
 		CoffeeConfiguration conf = fs.getConfiguration();
-		if (header.logRecordSize == 0) {
+		if (fileHeader.logRecordSize == 0) {
 			logRecordSize = conf.pageSize;
+		} else {
+			logRecordSize = fileHeader.logRecordSize;
 		}
-		int logAreaSize;
-		if (header.logRecords == 0) {
+		if (fileHeader.logRecords == 0) {
 			logRecords = conf.defaultLogSize / logRecordSize;
 		} else {
-			logRecords = header.logRecords;
+			logRecords = fileHeader.logRecords;
 		}
 
 		indexStart = header.getPage() * conf.pageSize +
@@ -73,7 +75,7 @@ public class CoffeeMicroLog extends CoffeeFile {
 		for (int i = 0; i < logRecords; i++) {
 			coffeeFS.getImage().read(bytes, bytes.length,
 				indexStart + i * 2);
-			index[i] = bytes[1] << 8 | bytes[0];
+			index[i] = (bytes[1] & 0xff) << 8 | (bytes[0] & 0xff);
 		}
 	}
 
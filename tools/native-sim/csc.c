@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Reading Cooja simulation (.csc) files for native-sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csc.h"
+
+/*---------------------------------------------------------------------------*/
+static char *
+read_file(const char *file)
+{
+  FILE *f;
+  char *buf;
+  long len;
+
+  f = fopen(file, "r");
+  if(f == NULL) {
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  buf = malloc(len + 1);
+  if(buf != NULL) {
+    len = fread(buf, 1, len, f);
+    buf[len] = '\0';
+  }
+  fclose(f);
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+/* Find the text of the first <tag ...>text</tag> in [start, end) and
+   copy it into buf. Returns a pointer past the element, or NULL. */
+static const char *
+get_tag(const char *start, const char *end, const char *tag,
+        char *buf, int bufsize)
+{
+  char open[CSC_NAME_LEN], close[CSC_NAME_LEN];
+  const char *p, *q;
+  int len;
+
+  snprintf(open, sizeof(open), "<%s", tag);
+  snprintf(close, sizeof(close), "</%s>", tag);
+  for(p = start; (p = strstr(p, open)) != NULL && p < end; p++) {
+    q = p + strlen(open);
+    if(*q == '>' || *q == ' ') {
+      break;
+    }
+  }
+  if(p == NULL || p >= end) {
+    return NULL;
+  }
+  p = strchr(p, '>');
+  q = strstr(p, close);
+  if(p == NULL || q == NULL || q > end) {
+    return NULL;
+  }
+  p++;
+  while(p < q && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+    p++;
+  }
+  len = q - p;
+  if(len >= bufsize) {
+    len = bufsize - 1;
+  }
+  memcpy(buf, p, len);
+  while(len > 0 && (buf[len - 1] == ' ' || buf[len - 1] == '\n' ||
+                    buf[len - 1] == '\r' || buf[len - 1] == '\t')) {
+    len--;
+  }
+  buf[len] = '\0';
+  return q + strlen(close);
+}
+/*---------------------------------------------------------------------------*/
+static void
+get_double(const char *start, const char *end, const char *tag, double *d)
+{
+  char buf[CSC_NAME_LEN];
+
+  if(get_tag(start, end, tag, buf, sizeof(buf)) != NULL) {
+    *d = strtod(buf, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* [CONFIG_DIR]/udp-sink.c becomes <dir of the .csc>/udp-sink.native-sim */
+static void
+library_name(char *lib, const char *source, const char *file)
+{
+  const char *base, *dir_end;
+  int dirlen, baselen;
+
+  base = strrchr(source, '/');
+  base = base != NULL ? base + 1 : source;
+  baselen = strlen(base);
+  if(baselen > 2 && strcmp(base + baselen - 2, ".c") == 0) {
+    baselen -= 2;
+  }
+  dir_end = strrchr(file, '/');
+  dirlen = dir_end != NULL ? dir_end - file + 1 : 0;
+  snprintf(lib, CSC_PATH_LEN, "%.*s%.*s.native-sim", dirlen, file,
+           baselen, base);
+}
+/*---------------------------------------------------------------------------*/
+int
+csc_read(struct csc *csc, const char *file)
+{
+  char buf[CSC_PATH_LEN];
+  const char *p, *start, *end, *sim_end;
+  char *text;
+  int i;
+
+  text = read_file(file);
+  if(text == NULL) {
+    perror(file);
+    return -1;
+  }
+
+  start = strstr(text, "<radiomedium>");
+  if(start != NULL && (end = strstr(start, "</radiomedium>")) != NULL) {
+    if(strstr(start, "radiomediums.UDGM") == NULL ||
+       strstr(start, "radiomediums.UDGM") > end) {
+      fprintf(stderr, "%s: radio medium is not UDGM, using defaults\n",
+              file);
+    } else {
+      get_double(start, end, "transmitting_range", &csc->medium.tx_range);
+      get_double(start, end, "interference_range",
+                 &csc->medium.interference_range);
+      get_double(start, end, "success_ratio_tx", &csc->medium.success_tx);
+      get_double(start, end, "success_ratio_rx", &csc->medium.success_rx);
+    }
+  }
+
+  /* Plugin configurations refer to motes with <mote> tags too, so
+     only look inside the simulation element. */
+  sim_end = strstr(text, "</simulation>");
+  if(sim_end == NULL) {
+    sim_end = text + strlen(text);
+  }
+
+  csc->num_types = csc->num_motes = 0;
+  for(p = text; (p = strstr(p, "<motetype>")) != NULL && p < sim_end; p++) {
+    csc->num_types++;
+  }
+  for(p = text; (p = strstr(p, "<mote>")) != NULL && p < sim_end; p++) {
+    csc->num_motes++;
+  }
+  csc->types = calloc(csc->num_types + 1, sizeof(struct csc_motetype));
+  csc->motes = calloc(csc->num_motes + 1, sizeof(struct csc_mote));
+  if(csc->types == NULL || csc->motes == NULL) {
+    free(text);
+    return -1;
+  }
+
+  i = 0;
+  for(p = text; i < csc->num_types &&
+        (start = strstr(p, "<motetype>")) != NULL; p = end, i++) {
+    struct csc_motetype *t = &csc->types[i];
+
+    end = strstr(start, "</motetype>");
+    if(end == NULL) {
+      break;
+    }
+    get_tag(start, end, "identifier", t->identifier, sizeof(t->identifier));
+    if(get_tag(start, end, "source", buf, sizeof(buf)) != NULL) {
+      library_name(t->library, buf, file);
+    }
+  }
+
+  i = 0;
+  for(p = text; i < csc->num_motes &&
+        (start = strstr(p, "<mote>")) != NULL; p = end, i++) {
+    struct csc_mote *m = &csc->motes[i];
+    int j;
+
+    end = strstr(start, "</mote>");
+    if(end == NULL) {
+      break;
+    }
+    m->id = i + 1;
+    if(get_tag(start, end, "id", buf, sizeof(buf)) != NULL) {
+      m->id = atoi(buf);
+    }
+    get_double(start, end, "x", &m->x);
+    get_double(start, end, "y", &m->y);
+    m->type = 0;
+    if(get_tag(start, end, "motetype_identifier", buf, sizeof(buf)) != NULL) {
+      for(j = 0; j < csc->num_types; j++) {
+        if(strcmp(buf, csc->types[j].identifier) == 0) {
+          m->type = j;
+        }
+      }
+    }
+  }
+
+  free(text);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
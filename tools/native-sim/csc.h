@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Reading Cooja simulation (.csc) files for native-sim
+ *
+ *         Only what native-sim can use is read: the UDGM radio medium
+ *         parameters, the mote types and, for each mote, its type, id
+ *         and position. This is a plain tag scanner, not an XML
+ *         parser, which is enough for the files Cooja writes.
+ */
+
+#ifndef __CSC_H__
+#define __CSC_H__
+
+#include "radio-medium.h"
+
+#define CSC_NAME_LEN 64
+#define CSC_PATH_LEN 256
+
+struct csc_motetype {
+  char identifier[CSC_NAME_LEN];
+  /* The native-sim library built from the mote type's source. */
+  char library[CSC_PATH_LEN];
+};
+
+struct csc_mote {
+  int type;
+  unsigned short id;
+  double x, y;
+};
+
+struct csc {
+  struct medium_params medium;
+  struct csc_motetype *types;
+  int num_types;
+  struct csc_mote *motes;
+  int num_motes;
+};
+
+/* Returns 0 on success. Fields not present in the file keep their
+   previous values. */
+int csc_read(struct csc *csc, const char *file);
+
+#endif /* __CSC_H__ */
@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Runner for native-sim simulations
+ *
+ *         Loads a Contiki application built with TARGET=native-sim
+ *         once per node and runs all nodes against a shared virtual
+ *         clock. Each node is a private copy of the shared object, so
+ *         nodes keep their globals apart without any change to Contiki
+ *         itself. Time jumps straight to the next node wakeup or frame
+ *         arrival; the nodes due at that time run in parallel on a
+ *         pool of worker threads. Nodes using the sim radio driver are
+ *         connected through the radio medium in radio-medium.c.
+ *
+ *         Usage: native-sim [options] [app.native-sim]
+ *           -n nodes     number of nodes, placed on a grid
+ *           -c file.csc  take nodes, positions and radio medium from a
+ *                        Cooja simulation; each mote type runs the
+ *                        .native-sim library built from its source
+ *           -m type=lib  run lib for the motes of a .csc mote type
+ *           -l trace     trace-driven loss, see radio-medium.h
+ *           -a           print the radio airtime of every node at the end
+ *           -r range     transmission range
+ *           -j threads   worker threads
+ *           -t seconds   simulated time
+ *           -s seed      random seed
+ *
+ *         Output from different nodes interleaves when running with
+ *         more than one thread.
+ */
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "sim-node.h"
+#include "radio-medium.h"
+#include "csc.h"
+
+#define MAX_TYPE_LIBS 16
+
+struct frame {
+  struct frame *next;
+  /* The node to acknowledge the frame and whether it receives it, see
+     medium_unicast(). */
+  int to, to_received;
+  unsigned short len;
+  unsigned char data[MEDIUM_MAX_FRAME];
+};
+
+struct node {
+  void (*init)(unsigned short id, unsigned short seed, unsigned long now);
+  unsigned long (*run)(unsigned long now);
+  unsigned long next;
+  int heap_pos;
+  unsigned short id;
+  unsigned short seed;
+  int booted;
+  /* For the medium decisions taken while the node runs. */
+  unsigned int medium_seed;
+
+  /* Radio driver variables in the node, see cpu/native/net/sim-radio.h */
+  void (*radio_input)(const void *data, unsigned short len);
+  unsigned long *radio_busy_until;
+  unsigned long *radio_tx_time, *radio_rx_time;
+
+  /* Frames sent while running, handed to the medium afterwards. */
+  struct frame *outbox, **outbox_last;
+};
+
+static struct node *nodes;
+static int num_nodes;
+
+/* Node index by id, -1 for none. */
+static int *node_by_id;
+static int num_threads = 1;
+
+/* Nodes ordered by their next wakeup time. */
+static int *heap;
+static int heap_len;
+
+/* The nodes to run at the current time, shared with the workers. */
+static int *due;
+static int num_due;
+static int next_due;
+static unsigned long now;
+static int done;
+
+static pthread_barrier_t start_barrier, end_barrier;
+
+/* Below this many nodes in a step, the main thread runs them alone;
+   waking the workers would cost more than it saves. */
+#define MIN_PARALLEL 8
+
+/*---------------------------------------------------------------------------*/
+static void
+usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [-n nodes] [-c file.csc] [-m type=lib] [-l trace] [-a]\n"
+          "       [-r range] [-j threads] [-t seconds] [-s seed] "
+          "[app.native-sim]\n", prog);
+  exit(1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_set(int i, int n)
+{
+  heap[i] = n;
+  nodes[n].heap_pos = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_up(int i)
+{
+  int n, parent;
+
+  n = heap[i];
+  for(; i > 0; i = parent) {
+    parent = (i - 1) / 2;
+    if(nodes[heap[parent]].next <= nodes[n].next) {
+      break;
+    }
+    heap_set(i, heap[parent]);
+  }
+  heap_set(i, n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_push(int n)
+{
+  heap[heap_len] = n;
+  heap_up(heap_len++);
+}
+/*---------------------------------------------------------------------------*/
+static int
+heap_pop(void)
+{
+  int top, last, i, child;
+
+  top = heap[0];
+  last = heap[--heap_len];
+  for(i = 0; (child = 2 * i + 1) < heap_len; i = child) {
+    if(child + 1 < heap_len &&
+       nodes[heap[child + 1]].next < nodes[heap[child]].next) {
+      child++;
+    }
+    if(nodes[last].next <= nodes[heap[child]].next) {
+      break;
+    }
+    heap_set(i, heap[child]);
+  }
+  if(heap_len > 0) {
+    heap_set(i, last);
+  }
+  return top;
+}
+/*---------------------------------------------------------------------------*/
+static int
+copy_file(const char *from, int to)
+{
+  char buf[8192];
+  int fd;
+  ssize_t n;
+
+  fd = open(from, O_RDONLY);
+  if(fd < 0) {
+    return -1;
+  }
+  while((n = read(fd, buf, sizeof(buf))) > 0) {
+    if(write(to, buf, n) != n) {
+      n = -1;
+      break;
+    }
+  }
+  close(fd);
+  return n < 0 ? -1 : 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Called from the node, on whichever thread runs it. */
+static int
+radio_output(void *ctx, const void *data, unsigned short len,
+             unsigned short ack_from)
+{
+  struct node *n = ctx;
+  struct frame *f;
+  int acked;
+
+  if(len > MEDIUM_MAX_FRAME || (f = malloc(sizeof(struct frame))) == NULL) {
+    return 0;
+  }
+  acked = 0;
+  f->to = -1;
+  f->to_received = 0;
+  if(ack_from != 0 && node_by_id[ack_from] >= 0 &&
+     node_by_id[ack_from] != n - nodes) {
+    f->to = node_by_id[ack_from];
+    acked = medium_unicast(n - nodes, f->to, now, &n->medium_seed,
+                           &f->to_received);
+  }
+  f->next = NULL;
+  f->len = len;
+  memcpy(f->data, data, len);
+  *n->outbox_last = f;
+  n->outbox_last = &f->next;
+  return acked;
+}
+/*---------------------------------------------------------------------------*/
+/* dlopen() returns the already loaded object when given the same file
+   twice, so every node is loaded from a copy of its own. The copy is
+   removed as soon as it is mapped. */
+static int
+load_node(struct node *n, const char *lib)
+{
+  char path[] = "/tmp/native-sim-XXXXXX";
+  int (**output)(void *, const void *, unsigned short, unsigned short);
+  void **ctx;
+  void *handle;
+  int fd;
+
+  fd = mkstemp(path);
+  if(fd < 0) {
+    perror("mkstemp");
+    return -1;
+  }
+  if(copy_file(lib, fd) < 0) {
+    perror(lib);
+    close(fd);
+    unlink(path);
+    return -1;
+  }
+  close(fd);
+
+  handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+  unlink(path);
+  if(handle == NULL) {
+    fprintf(stderr, "%s\n", dlerror());
+    return -1;
+  }
+
+  n->init = (void (*)(unsigned short, unsigned short, unsigned long))
+    dlsym(handle, "sim_node_init");
+  n->run = (unsigned long (*)(unsigned long))dlsym(handle, "sim_node_run");
+  if(n->init == NULL || n->run == NULL) {
+    fprintf(stderr, "%s: not a native-sim node\n", lib);
+    return -1;
+  }
+
+  n->outbox = NULL;
+  n->outbox_last = &n->outbox;
+  n->radio_input = (void (*)(const void *, unsigned short))
+    dlsym(handle, "sim_radio_input");
+  n->radio_busy_until = dlsym(handle, "sim_radio_busy_until");
+  output = dlsym(handle, "sim_radio_output");
+  ctx = dlsym(handle, "sim_radio_ctx");
+  if(n->radio_input != NULL && n->radio_busy_until != NULL &&
+     output != NULL && ctx != NULL) {
+    *output = radio_output;
+    *ctx = n;
+  } else {
+    n->radio_input = NULL;
+  }
+  n->radio_tx_time = dlsym(handle, "sim_radio_tx_time");
+  n->radio_rx_time = dlsym(handle, "sim_radio_rx_time");
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+radio_deliver(int i, const void *data, unsigned short len)
+{
+  struct node *n = &nodes[i];
+
+  if(n->radio_input == NULL || !n->booted) {
+    return;
+  }
+  n->radio_input(data, len);
+  if(n->next > now) {
+    n->next = now;
+    heap_up(n->heap_pos);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_due(void)
+{
+  struct node *n;
+  int i;
+
+  while((i = __sync_fetch_and_add(&next_due, 1)) < num_due) {
+    n = &nodes[due[i]];
+    if(!n->booted) {
+      n->init(n->id, n->seed, now);
+      n->booted = 1;
+    }
+    if(n->radio_input != NULL) {
+      *n->radio_busy_until = medium_busy_until(due[i]);
+    }
+    n->next = n->run(now);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void *
+worker(void *arg)
+{
+  while(1) {
+    pthread_barrier_wait(&start_barrier);
+    if(done) {
+      break;
+    }
+    run_due();
+    pthread_barrier_wait(&end_barrier);
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  struct medium_params medium = { 50.0, 100.0, 1.0, 1.0 };
+  char *type_libs[MAX_TYPE_LIBS];
+  const char *csc_file, *trace_file, *lib;
+  struct csc csc;
+  pthread_t *threads;
+  unsigned long end, steps, runs, t;
+  struct timeval start, stop;
+  double wall, range;
+  unsigned short seed;
+  unsigned int boot_seed;
+  int c, i, j, side, num_type_libs, print_airtime;
+  struct frame *f;
+
+  end = 60 * SIM_NODE_SECOND;
+  seed = 1;
+  range = 0;
+  csc_file = trace_file = NULL;
+  num_type_libs = 0;
+  num_nodes = 1;
+  print_airtime = 0;
+
+  while((c = getopt(argc, argv, "n:c:m:l:ar:j:t:s:")) != -1) {
+    switch(c) {
+    case 'n':
+      num_nodes = atoi(optarg);
+      break;
+    case 'c':
+      csc_file = optarg;
+      break;
+    case 'm':
+      if(num_type_libs == MAX_TYPE_LIBS || strchr(optarg, '=') == NULL) {
+        usage(argv[0]);
+      }
+      type_libs[num_type_libs++] = optarg;
+      break;
+    case 'l':
+      trace_file = optarg;
+      break;
+    case 'a':
+      print_airtime = 1;
+      break;
+    case 'r':
+      range = atof(optarg);
+      break;
+    case 'j':
+      num_threads = atoi(optarg);
+      break;
+    case 't':
+      end = strtoul(optarg, NULL, 10) * SIM_NODE_SECOND;
+      break;
+    case 's':
+      seed = atoi(optarg);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  lib = optind < argc ? argv[optind] : NULL;
+  if(optind < argc - 1 || (lib == NULL && csc_file == NULL) ||
+     num_nodes < 1 || num_threads < 1) {
+    usage(argv[0]);
+  }
+
+  boot_seed = seed;
+  memset(&csc, 0, sizeof(csc));
+  csc.medium = medium;
+  if(csc_file != NULL) {
+    if(csc_read(&csc, csc_file) < 0) {
+      return 1;
+    }
+    if(csc.num_motes == 0) {
+      fprintf(stderr, "%s: no motes\n", csc_file);
+      return 1;
+    }
+    num_nodes = csc.num_motes;
+    medium = csc.medium;
+  }
+  if(range > 0) {
+    medium.interference_range *= range / medium.tx_range;
+    medium.tx_range = range;
+  }
+
+  nodes = calloc(num_nodes, sizeof(struct node));
+  heap = calloc(num_nodes, sizeof(int));
+  due = calloc(num_nodes, sizeof(int));
+  threads = calloc(num_threads, sizeof(pthread_t));
+  node_by_id = malloc(65536 * sizeof(int));
+  if(nodes == NULL || heap == NULL || due == NULL || threads == NULL ||
+     node_by_id == NULL ||
+     medium_init(num_nodes, &medium, seed) < 0) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  memset(node_by_id, 0xff, 65536 * sizeof(int));
+
+  /* Without a .csc file, nodes are placed on a square grid close
+     enough for each to reach its eight nearest neighbours. */
+  side = ceil(sqrt(num_nodes));
+  for(i = 0; i < num_nodes; i++) {
+    const char *node_lib = lib;
+
+    if(csc_file != NULL) {
+      struct csc_mote *m = &csc.motes[i];
+      struct csc_motetype *type = &csc.types[m->type];
+
+      nodes[i].id = m->id;
+      medium_set_node(i, m->id, m->x, m->y);
+      if(node_lib == NULL) {
+        node_lib = type->library;
+      }
+      for(j = 0; j < num_type_libs; j++) {
+        if(strncmp(type_libs[j], type->identifier,
+                   strlen(type->identifier)) == 0 &&
+           type_libs[j][strlen(type->identifier)] == '=') {
+          node_lib = type_libs[j] + strlen(type->identifier) + 1;
+        }
+      }
+    } else {
+      nodes[i].id = i + 1;
+      medium_set_node(i, i + 1, (i % side) * medium.tx_range * 0.6,
+                      (i / side) * medium.tx_range * 0.6);
+    }
+
+    if(load_node(&nodes[i], node_lib) < 0) {
+      return 1;
+    }
+    /* Nodes boot at random times within the first second, as in
+       Cooja, so that their timers do not all run in step. */
+    nodes[i].seed = seed + i;
+    nodes[i].medium_seed = seed + i;
+    node_by_id[nodes[i].id] = i;
+    nodes[i].next = rand_r(&boot_seed) % SIM_NODE_SECOND;
+    heap_push(i);
+  }
+
+  if(trace_file != NULL && medium_load_trace(trace_file) < 0) {
+    return 1;
+  }
+
+  setvbuf(stdout, NULL, _IOLBF, 0);
+
+  pthread_barrier_init(&start_barrier, NULL, num_threads);
+  pthread_barrier_init(&end_barrier, NULL, num_threads);
+  for(i = 1; i < num_threads; i++) {
+    pthread_create(&threads[i], NULL, worker, NULL);
+  }
+
+  gettimeofday(&start, NULL);
+  steps = runs = 0;
+  while(1) {
+    now = nodes[heap[0]].next;
+    t = medium_next_arrival();
+    if(t < now) {
+      now = t;
+    }
+    if(now == SIM_NODE_NEVER || now > end) {
+      break;
+    }
+
+    medium_deliver(now, radio_deliver);
+
+    num_due = 0;
+    while(heap_len > 0 && nodes[heap[0]].next <= now) {
+      due[num_due++] = heap_pop();
+    }
+    next_due = 0;
+    steps++;
+    runs += num_due;
+
+    if(num_due < MIN_PARALLEL || num_threads == 1) {
+      run_due();
+    } else {
+      pthread_barrier_wait(&start_barrier);
+      run_due();
+      pthread_barrier_wait(&end_barrier);
+    }
+
+    /* Transmissions are handed to the medium in node order, which
+       keeps runs repeatable whatever the thread timing. */
+    for(i = 0; i < num_due; i++) {
+      struct node *n = &nodes[due[i]];
+
+      while((f = n->outbox) != NULL) {
+        n->outbox = f->next;
+        medium_transmit(due[i], f->data, f->len, now, f->to,
+                        f->to_received);
+        free(f);
+      }
+      n->outbox_last = &n->outbox;
+      heap_push(due[i]);
+    }
+  }
+  gettimeofday(&stop, NULL);
+
+  done = 1;
+  pthread_barrier_wait(&start_barrier);
+  for(i = 1; i < num_threads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  wall = (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) / 1e6;
+  fprintf(stderr, "%d nodes, %lu s simulated in %.2f s (%lu steps, "
+          "%lu node runs)\n", num_nodes, end / SIM_NODE_SECOND, wall,
+          steps, runs);
+  medium_print_stats();
+  if(print_airtime) {
+    for(i = 0; i < num_nodes; i++) {
+      if(nodes[i].radio_tx_time != NULL && nodes[i].radio_rx_time != NULL) {
+        fprintf(stderr, "node %u: %lu us sent, %lu us received\n",
+                nodes[i].id, *nodes[i].radio_tx_time,
+                *nodes[i].radio_rx_time);
+      }
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
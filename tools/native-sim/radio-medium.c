@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Radio medium for native-sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim-node.h"
+#include "radio-medium.h"
+
+/* PHY overhead (preamble, SFD and length) and time per byte at
+   250 kbit/s. */
+#define PHY_HEADER_LEN    6
+#define BYTE_TIME_US      32
+
+struct arrival {
+  struct arrival *next;
+  unsigned long time;
+  int node;
+  int lost;
+  /* The sender was told the frame arrived. */
+  int sure;
+  unsigned short len;
+  unsigned char data[MEDIUM_MAX_FRAME];
+};
+
+struct link {
+  int node;
+  double distance;
+};
+
+struct medium_node {
+  unsigned short id;
+  double x, y;
+  /* Neighbours within interference range, for the UDGM model. */
+  struct link *links;
+  int num_links;
+  unsigned long busy_until;
+  /* The end of the last frame sent. */
+  unsigned long tx_until;
+  /* The frame being received, if any. */
+  struct arrival *receiving;
+};
+
+struct trace_entry {
+  unsigned long time;
+  int line;
+  int src, dst;
+  float prr;
+};
+
+static struct medium_params params;
+static struct medium_node *nodes;
+static int num_nodes;
+static int links_ready;
+static unsigned int seed;
+
+/* Frames in the air, in order of arrival. */
+static struct arrival *arrivals;
+
+/* Trace-driven model: the reception ratio of every link. */
+static struct trace_entry *trace;
+static int trace_len, trace_pos;
+static float *prr;
+
+static struct {
+  unsigned long sent, received, collisions;
+} stats;
+
+/*---------------------------------------------------------------------------*/
+static double
+rnd(void)
+{
+  return rand_r(&seed) / (RAND_MAX + 1.0);
+}
+/*---------------------------------------------------------------------------*/
+int
+medium_init(int n, const struct medium_params *p, unsigned int s)
+{
+  num_nodes = n;
+  params = *p;
+  seed = s;
+  nodes = calloc(n, sizeof(struct medium_node));
+  return nodes == NULL ? -1 : 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+medium_set_node(int node, unsigned short id, double x, double y)
+{
+  nodes[node].id = id;
+  nodes[node].x = x;
+  nodes[node].y = y;
+  links_ready = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_links(void)
+{
+  double range, dx, dy, d2;
+  int i, j;
+
+  range = params.interference_range > params.tx_range ?
+    params.interference_range : params.tx_range;
+
+  for(i = 0; i < num_nodes; i++) {
+    struct medium_node *n = &nodes[i];
+
+    free(n->links);
+    n->links = NULL;
+    n->num_links = 0;
+    for(j = 0; j < num_nodes; j++) {
+      dx = nodes[j].x - n->x;
+      dy = nodes[j].y - n->y;
+      d2 = dx * dx + dy * dy;
+      if(j == i || d2 > range * range) {
+        continue;
+      }
+      if((n->num_links & 15) == 0) {
+        n->links = realloc(n->links,
+                           (n->num_links + 16) * sizeof(struct link));
+      }
+      n->links[n->num_links].node = j;
+      n->links[n->num_links].distance = d2;
+      n->num_links++;
+    }
+  }
+  links_ready = 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+find_node(unsigned short id)
+{
+  int i;
+
+  for(i = 0; i < num_nodes; i++) {
+    if(nodes[i].id == id) {
+      return i;
+    }
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+trace_cmp(const void *a, const void *b)
+{
+  const struct trace_entry *x = a, *y = b;
+
+  if(x->time != y->time) {
+    return x->time < y->time ? -1 : 1;
+  }
+  return x->line - y->line;
+}
+/*---------------------------------------------------------------------------*/
+int
+medium_load_trace(const char *file)
+{
+  char line[128];
+  double time;
+  unsigned src, dst;
+  float p;
+  FILE *f;
+  int n;
+
+  f = fopen(file, "r");
+  if(f == NULL) {
+    perror(file);
+    return -1;
+  }
+  prr = calloc((size_t)num_nodes * num_nodes, sizeof(float));
+  if(prr == NULL) {
+    fclose(f);
+    return -1;
+  }
+
+  for(n = 1; fgets(line, sizeof(line), f) != NULL; n++) {
+    struct trace_entry *t;
+
+    if(line[0] == '#' || sscanf(line, "%lf %u %u %f", &time, &src, &dst,
+                                &p) != 4) {
+      continue;
+    }
+    if((trace_len & 255) == 0) {
+      trace = realloc(trace, (trace_len + 256) * sizeof(struct trace_entry));
+    }
+    t = &trace[trace_len];
+    t->time = time * SIM_NODE_SECOND;
+    t->line = n;
+    t->src = find_node(src);
+    t->dst = find_node(dst);
+    t->prr = p;
+    if(t->src < 0 || t->dst < 0) {
+      fprintf(stderr, "%s:%d: unknown node\n", file, n);
+      continue;
+    }
+    trace_len++;
+  }
+  fclose(f);
+
+  qsort(trace, trace_len, sizeof(struct trace_entry), trace_cmp);
+  trace_pos = 0;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+apply_trace(unsigned long now)
+{
+  struct trace_entry *t;
+
+  for(; trace_pos < trace_len && trace[trace_pos].time <= now; trace_pos++) {
+    t = &trace[trace_pos];
+    prr[t->src * num_nodes + t->dst] = t->prr;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static double
+link_prr(int s, int r)
+{
+  double dx, dy, d2, range2;
+
+  if(prr != NULL) {
+    return prr[s * num_nodes + r];
+  }
+  dx = nodes[r].x - nodes[s].x;
+  dy = nodes[r].y - nodes[s].y;
+  d2 = dx * dx + dy * dy;
+  range2 = params.tx_range * params.tx_range;
+  if(d2 > range2) {
+    return 0;
+  }
+  return 1.0 - d2 / range2 * (1.0 - params.success_rx);
+}
+/*---------------------------------------------------------------------------*/
+int
+medium_unicast(int s, int r, unsigned long now, unsigned int *seed,
+               int *received)
+{
+  *received = rand_r(seed) / (RAND_MAX + 1.0) < params.success_tx &&
+    nodes[r].busy_until <= now &&
+    rand_r(seed) / (RAND_MAX + 1.0) < link_prr(s, r);
+  return *received && rand_r(seed) / (RAND_MAX + 1.0) < link_prr(r, s);
+}
+/*---------------------------------------------------------------------------*/
+/* The frame reaches node r, which may or may not be able to decode
+   it. Either way the channel at r is busy until end. */
+static struct arrival *
+reach(int r, int decodable, int sure, unsigned long now, unsigned long end,
+      const void *data, unsigned short len)
+{
+  struct medium_node *n = &nodes[r];
+  struct arrival *a;
+  int busy;
+
+  busy = n->busy_until > now;
+  if(busy && n->receiving != NULL && !n->receiving->sure) {
+    n->receiving->lost = 1;
+  }
+  if(n->busy_until < end) {
+    n->busy_until = end;
+  }
+  if(!decodable) {
+    return NULL;
+  }
+
+  a = malloc(sizeof(struct arrival));
+  if(a == NULL) {
+    return NULL;
+  }
+  a->time = end;
+  a->node = r;
+  a->lost = busy && !sure;
+  a->sure = sure;
+  a->len = len;
+  memcpy(a->data, data, len);
+  n->receiving = a;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+void
+medium_transmit(int s, const void *data, unsigned short len,
+                unsigned long now, int to, int to_received)
+{
+  struct arrival *first, **last, *a, **pos;
+  struct medium_node *n;
+  unsigned long end;
+  double d2, p;
+  int tx_ok, i, r;
+
+  if(len > MEDIUM_MAX_FRAME) {
+    return;
+  }
+  stats.sent++;
+
+  /* Frames sent in one run, such as the fragments of a packet, go out
+     one after the other. */
+  n = &nodes[s];
+  if(n->tx_until > now) {
+    now = n->tx_until;
+  }
+  end = now + ((len + PHY_HEADER_LEN) * BYTE_TIME_US * SIM_NODE_SECOND +
+               999999) / 1000000;
+  n->tx_until = end;
+  tx_ok = rnd() < params.success_tx;
+
+  /* A transmitting node cannot receive. */
+  if(n->busy_until > now && n->receiving != NULL && !n->receiving->sure) {
+    n->receiving->lost = 1;
+  }
+  n->receiving = NULL;
+  if(n->busy_until < end) {
+    n->busy_until = end;
+  }
+
+  first = NULL;
+  last = &first;
+  if(prr != NULL) {
+    for(i = 0; i < num_nodes; i++) {
+      p = prr[s * num_nodes + i];
+      if(p <= 0) {
+        continue;
+      }
+      if(i == to) {
+        a = reach(i, to_received, to_received, now, end, data, len);
+      } else {
+        a = reach(i, tx_ok && rnd() < p, 0, now, end, data, len);
+      }
+      if(a != NULL) {
+        *last = a;
+        last = &a->next;
+      }
+    }
+  } else {
+    if(!links_ready) {
+      make_links();
+    }
+    for(i = 0; i < n->num_links; i++) {
+      r = n->links[i].node;
+      d2 = n->links[i].distance;
+      p = 0;
+      if(d2 <= params.tx_range * params.tx_range) {
+        p = 1.0 - d2 / (params.tx_range * params.tx_range) *
+          (1.0 - params.success_rx);
+      }
+      if(r == to) {
+        a = reach(r, to_received, to_received, now, end, data, len);
+      } else {
+        a = reach(r, tx_ok && p > 0 && rnd() < p, 0, now, end, data, len);
+      }
+      if(a != NULL) {
+        *last = a;
+        last = &a->next;
+      }
+    }
+  }
+
+  /* All new arrivals end at the same time; keep them after the ones
+     ending no later. */
+  for(pos = &arrivals; *pos != NULL && (*pos)->time <= end;
+      pos = &(*pos)->next);
+  *last = *pos;
+  *pos = first;
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+medium_next_arrival(void)
+{
+  return arrivals != NULL ? arrivals->time : SIM_NODE_NEVER;
+}
+/*---------------------------------------------------------------------------*/
+void
+medium_deliver(unsigned long now,
+               void (*deliver)(int node, const void *data, unsigned short len))
+{
+  struct arrival *a;
+
+  /* Links change here, before the nodes run, so that medium_unicast()
+     sees the same table from all threads. */
+  if(prr != NULL) {
+    apply_trace(now);
+  }
+
+  while(arrivals != NULL && arrivals->time <= now) {
+    a = arrivals;
+    arrivals = a->next;
+    if(nodes[a->node].receiving == a) {
+      nodes[a->node].receiving = NULL;
+    }
+    if(a->lost) {
+      stats.collisions++;
+    } else {
+      stats.received++;
+      deliver(a->node, a->data, a->len);
+    }
+    free(a);
+  }
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+medium_busy_until(int node)
+{
+  return nodes[node].busy_until;
+}
+/*---------------------------------------------------------------------------*/
+void
+medium_print_stats(void)
+{
+  fprintf(stderr, "radio: %lu frames sent, %lu received, %lu collided\n",
+          stats.sent, stats.received, stats.collisions);
+}
+/*---------------------------------------------------------------------------*/
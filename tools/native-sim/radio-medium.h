@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2026, Contiki contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of its
+ *    contributors may be used to endorse or promote products derived from
+ *    this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Radio medium for native-sim
+ *
+ *         Two loss models are available. The default works like the
+ *         Cooja UDGM: frames reach nodes within the transmission
+ *         range, with a reception probability falling off with
+ *         distance, and disturb nodes within the interference range.
+ *         Alternatively, a trace file gives the packet reception ratio
+ *         of every directed link over time, one "time src dst prr"
+ *         line per change, with the time in seconds and nodes by id.
+ *
+ *         A frame is in the air for its 250 kbit/s transmission time.
+ *         Frames that overlap at a receiver are both lost there, and a
+ *         node does not receive while it transmits.
+ *
+ *         The fate of a frame that asks for an acknowledgement is
+ *         decided by medium_unicast() as it is sent, so that the sender
+ *         learns it at once. A frame decided received is not lost to
+ *         frames sent after it. Acknowledgements take no airtime.
+ */
+
+#ifndef __RADIO_MEDIUM_H__
+#define __RADIO_MEDIUM_H__
+
+#define MEDIUM_MAX_FRAME 127
+
+struct medium_params {
+  double tx_range;
+  double interference_range;
+  double success_tx;
+  double success_rx;
+};
+
+/* Nodes are numbered from 0 to num_nodes - 1. */
+int medium_init(int num_nodes, const struct medium_params *params,
+                unsigned int seed);
+void medium_set_node(int node, unsigned short id, double x, double y);
+
+/* Switch to the trace-driven model. Returns 0 on success. */
+int medium_load_trace(const char *file);
+
+/* Called while the nodes run, for a frame node s sends now that node
+   r is to acknowledge. Sets *received to whether r gets the frame and
+   returns whether the acknowledgement gets back to s. Draws from the
+   caller's seed, so that the outcome does not depend on the thread
+   running s. */
+int medium_unicast(int s, int r, unsigned long now, unsigned int *seed,
+                   int *received);
+
+/* to is the node medium_unicast() decided the frame for, or -1. */
+void medium_transmit(int node, const void *data, unsigned short len,
+                     unsigned long now, int to, int to_received);
+
+/* Time of the next frame arrival, or SIM_NODE_NEVER. */
+unsigned long medium_next_arrival(void);
+
+/* Hand all frames arriving at or before now to their receivers. */
+void medium_deliver(unsigned long now,
+                    void (*deliver)(int node, const void *data,
+                                    unsigned short len));
+
+/* The channel at a node is busy until this time. */
+unsigned long medium_busy_until(int node);
+
+void medium_print_stats(void);
+
+#endif /* __RADIO_MEDIUM_H__ */